@@ -33,6 +33,7 @@ public:
     static void waitUntilEndOfAllMoves();
     static void waitUntilEndOfAllBuffers();
     static void printCurrentPosition();
+    static void printQueueStatistics();
     static void printTemperatures(bool showRaw = false);
     static void setFanSpeed(int speed,bool wait); /// Set fan speed 0..255
     static void changeFeedrateMultiply(int factorInPercent);
@@ -42,6 +43,8 @@ public:
     static void checkFreeMemory();
     static void writeLowestFreeRAM();
 private:
+    static millis_t statisticsInterval; ///< M539 P, 0 = no automatic report
+    static millis_t lastStatistics;
     static int lowestRAMValue;
     static int lowestRAMValueSend;
 };
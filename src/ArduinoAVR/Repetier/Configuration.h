@@ -218,6 +218,7 @@ Overridden if EEPROM activated.*/
 - 0 = Simply switch on/off if temperature is reached. Works always.
 - 1 = PID Temperature control. Is better but needs good PID values. Defaults are a good start for most extruder.
 - 3 = Dead-time control. PID_P becomes dead-time in seconds.
+- 4 = Model predictive control. Uses the EXT0_MPC_ values, measure them with M306.
  Overridden if EEPROM activated.
 */
 #define EXT0_HEAT_MANAGER 1
@@ -252,6 +253,20 @@ A good start is 30 lower then the optimal value. You need to leave room for cool
 #define EXT0_PID_D 80
 // maximum time the heater is can be switched on. Max = 255.  Overridden if EEPROM activated.
 #define EXT0_PID_MAX 255
+/** \brief Heater model for heat manager 4.
+
+Power of the heater at full pwm in W, e.g. 40 for a 40W cartridge at its rated voltage. The other
+values are measured by M306 relative to it: heat capacity of heater block and nozzle in J/K, heat
+loss to the surrounding air in W/K and the part of the difference between block and sensor the
+sensor follows per second.  Overridden if EEPROM activated.
+*/
+#define EXT0_MPC_HEATER_POWER 40
+#define EXT0_MPC_HEAT_CAPACITY 16.7
+#define EXT0_MPC_AMBIENT_LOSS 0.068
+#define EXT0_MPC_SENSOR_RESPONSE 0.22
+/** Heat needed to warm 1 mm of filament by 1 degree in J/(mm*K). 0.0056 for 1.75 mm PLA,
+0.015 for 2.85 mm filament. Overridden if EEPROM activated. */
+#define EXT0_MPC_FILAMENT_HEAT 0.0056
 /** \brief Faktor for the advance algorithm. 0 disables the algorithm.  Overridden if EEPROM activated.
 K is the factor for the quadratic term, which is normally disabled in newer versions. If you want to use
 the quadratic factor make sure ENABLE_QUADRATIC_ADVANCE is defined.
@@ -365,6 +380,12 @@ A good start is 30 lower then the optimal value. You need to leave room for cool
 #define EXT1_PID_D 200
 // maximum time the heater is can be switched on. Max = 255.  Overridden if EEPROM activated.
 #define EXT1_PID_MAX 255
+/** Heater model for heat manager 4, see EXT0_MPC_HEATER_POWER.  Overridden if EEPROM activated. */
+#define EXT1_MPC_HEATER_POWER 40
+#define EXT1_MPC_HEAT_CAPACITY 16.7
+#define EXT1_MPC_AMBIENT_LOSS 0.068
+#define EXT1_MPC_SENSOR_RESPONSE 0.22
+#define EXT1_MPC_FILAMENT_HEAT 0.0056
 /** \brief Faktor for the advance algorithm. 0 disables the algorithm.  Overridden if EEPROM activated.
 K is the factor for the quadratic term, which is normally disabled in newer versions. If you want to use
 the quadratic factor make sure ENABLE_QUADRATIC_ADVANCE is defined.
@@ -396,6 +417,14 @@ need to increase this value. For one 6.8 Ohm heater 10 is ok. With two 6.8 Ohm h
 */
 #define PID_CONTROL_RANGE 20
 
+/** \brief Seconds of queued moves heat manager 4 averages the filament flow over.
+
+The heater output includes the heat for this flow, so it rises before a faster move starts.
+*/
+#define MPC_FEED_FORWARD_TIME 1.0
+/** Ambient temperature heat manager 4 starts with. It is corrected while the target temperature is held. */
+#define MPC_AMBIENT_TEMPERATURE 25
+
 /** Prevent extrusions longer then x mm for one command. This is especially important if you abort a print. Then the
 extrusion poistion might be at any value like 23344. If you then have an G1 E-2 it will roll back 23 meter! */
 #define EXTRUDE_MAXLENGTH 100
@@ -414,6 +443,25 @@ If your EXT0_PID_MAX is low, you should prefer the second method.
 
 #define HEATER_PWM_SPEED 1 // How fast ist pwm signal 0 = 15.25Hz, 1 = 30.51Hz, 2 = 61.03Hz, 3 = 122.06Hz
 
+/** \brief Sample the analog inputs from the ADC interrupt
+
+The timer 0 overflow starts a conversion 976 times per second and the ADC interrupt reads it,
+instead of polling the ADC in the PWM interrupt. The value of an input is the median of the last
+three sums of 2^ANALOG_INPUT_SAMPLE conversions, which removes single disturbed readings.
+The interrupt load has not been measured on hardware yet, 0 keeps the old polling.
+*/
+#define ANALOG_INTERRUPT_SAMPLING 0
+
+/** \brief Drive heater and fan outputs on timer pins by the timer
+
+Outputs on pins of a free timer (timers 4 and 5 on the ATmega1280/2560, timer 2 without beeper,
+timer 3 without servos) use 8 bit phase correct hardware pwm. The pwm interrupt only copies the
+new value into the compare register once per period instead of switching the pin. All these
+outputs run with 30.6 Hz for HEATER_PWM_SPEED 0 and 1 and with 122.5 Hz for 2 and 3.
+Not tested on hardware yet, so check the heater and fan outputs before you enable it.
+*/
+#define HARDWARE_PWM 0
+
 /** Temperature range for target temperature to hold in M109 command. 5 means +/-5 degC
 
 Uncomment define to force the temperature into the range for given watchperiod.
@@ -526,6 +574,13 @@ See http://reprap.org/wiki/MeasuringThermistorBeta for more details.
 Value is used for all generic tables created. */
 #define GENERIC_THERM_NUM_ENTRIES 33
 
+/** With THERMISTOR_DENSE_INDEX 1 the built-in tables 1-4 and 8-12 get an index in flash that holds the
+table row for every 16 raw values, so converting a reading needs no search. The temperature is still
+interpolated between the table rows, the readings do not change. Costs 256 bytes of flash for every
+table used by an extruder or the bed and no RAM. The index is in thermistortables.h, made with
+"make thermistortables" of the host simulator. */
+#define THERMISTOR_DENSE_INDEX 0
+
 // uncomment the following line for MAX6675 support.
 //#define SUPPORT_MAX6675
 // uncomment the following line for MAX31855 support.
@@ -809,6 +864,25 @@ Increasing this figure can use a lot of memory since 7 bytes * size of line buff
 will be allocated for the delta buffer. With defaults 7 * 16 * 22 = 2464 bytes. This leaves ~1K free RAM on an Arduino
 Mega. Used only for nonlinear systems like delta or tuga. */
 #define MAX_DELTA_SEGMENTS_PER_LINE 22
+/** \brief Size of a shared delta segment pool.
+
+With 0 every line in the line cache reserves MAX_DELTA_SEGMENTS_PER_LINE segments, also short moves that need only a few.
+With a value > 0 all lines borrow exactly the segments they use from one ring of this size. Most printing moves need far
+less than MAX_DELTA_SEGMENTS_PER_LINE segments, so you can raise MOVE_CACHE_SIZE for a deeper lookahead with the same RAM.
+Costs 7 bytes per segment, e.g. 7 * 256 = 1792 bytes. Must be at least MAX_DELTA_SEGMENTS_PER_LINE. If the pool is full
+new moves wait until the printer has executed enough segments. Used only for nonlinear systems like delta or tuga. */
+#define DELTA_SEGMENT_POOL_SIZE 0
+/** \brief Compute delta segments just ahead of the stepper instead of when the move is queued.
+
+Normally all segments of a line are computed and stored when the line enters the line cache. With DELTA_LAZY_SEGMENTS 1
+a line only keeps its start position (24 bytes) and the main loop computes the tower steps of the next segments into a
+ring of DELTA_LAZY_SEGMENTS_BUFFER entries (7 bytes each, power of 2, max. 128) shortly before the stepper needs them.
+RAM no longer depends on MAX_DELTA_SEGMENTS_PER_LINE (max. 255), so DELTA_SEGMENTS_PER_SECOND_PRINT can go higher.
+The primary axis of a line uses an upper bound of the tower steps per segment, which costs some extra timer calls.
+If the main loop falls behind, the stepper waits; M536 reports how often. Only for DRIVE_SYSTEM 3, ignores
+DELTA_SEGMENT_POOL_SIZE. */
+#define DELTA_LAZY_SEGMENTS 0
+#define DELTA_LAZY_SEGMENTS_BUFFER 16
 
 /** After x seconds of inactivity, the stepper motors are disabled.
     Set to 0 to leave them enabled.
@@ -847,6 +921,16 @@ own weight, so this is nearly never needed. */
 
 /** Comment this to disable ramp acceleration */
 #define RAMP_ACCELERATION 1
+/** \brief Use an S-curve instead of a linear speed ramp for acceleration and deceleration.
+
+The speed follows the 5th order polynomial 10u^3-15u^4+6u^5 (a bezier curve with 6 control points)
+over the same time as the linear ramp would need. Acceleration starts and ends at zero, so moves
+start and stop without jerk and cause less ringing, which allows higher accelerations.
+The distance needed for a speed change stays the same, but the peak acceleration in the middle
+of the ramp is 1.875 times the configured acceleration. Costs 8 byte ram per cached move
+(12 on Due). Requires RAMP_ACCELERATION.
+*/
+#define S_CURVE_ACCELERATION 0
 
 /** If your stepper needs a longer high signal then given, you can add a delay here.
 The delay is realized as a simple loop wasting time, which is not available for other
@@ -872,6 +956,29 @@ for some printers causing an early stall.
 */
 #define DOUBLE_STEP_DELAY 1 // time in microseconds
 
+/** With STEP_TIMING_QUEUE enabled, the 2 or 4 steps of one timer call above STEP_DOUBLER_FREQUENCY
+are no longer sent back to back. The first step is sent directly, the others go into a small queue
+and are sent by the following timer interrupts at evenly spaced times. These interrupts only set the
+step pins and reload the timer, so the primary axis runs without the doubling jitter.
+Used for cartesian printers without XY gantry, other drive systems ignore it. Costs 13 byte ram.
+*/
+#define STEP_TIMING_QUEUE 0
+
+/** With STEP_EVENT_RING enabled the bresenham and acceleration computations move out of the timer
+interrupt. The main loop converts the running move ahead of time into a ring of
+{interval, step bits, direction bits} events and the timer interrupt only sets the pins from them.
+Steps above STEP_DOUBLER_FREQUENCY get evenly spaced like with STEP_TIMING_QUEUE, which is
+not used together with the ring.
+If the main loop falls behind, the interrupt counts an underrun and computes the next steps itself
+like without the ring, so the move keeps its speed. M536 reports the underruns and the lowest fill
+level seen during moves, so you can size STEP_EVENT_RING_SIZE (power of 2, max. 128, 4 byte ram
+per entry). A line stays in the move queue until the interrupt has sent its last event.
+Used for cartesian printers without XY gantry. Moves with active advance, z probing or
+MAX_HARDWARE_ENDSTOP_Z upwards are still computed inside the interrupt.
+*/
+#define STEP_EVENT_RING 0
+#define STEP_EVENT_RING_SIZE 64
+
 /** The firmware supports trajectory smoothing. To achieve this, it divides the stepsize by 2, resulting in
 the double computation cost. For slow movements this is not an issue, but for really fast moves this is
 too much. The value specified here is the number of clock cycles between a step on the driving axis.
@@ -938,6 +1045,14 @@ This value must be high enough, that the buffer has time to fill up. The problem
 if you are printing many very short segments at high speed. Higher delays here allow higher values in PATH_PLANNER_CHECK_SEGMENTS.
 */
 #define LOW_TICKS_PER_MOVE 250000
+/** \brief Use integer math for the speed limits in the path planner.
+
+Computes the step intervals at maximum feedrate with 16x16 bit multiplications and 32/16 bit
+divisions instead of float divisions. This speeds up the computation of short moves, which
+matters if you print many small segments. Only moves with less than 65536 steps on the primary
+axis use it. Has no effect on delta printers. Set to 1 to enable.
+*/
+#define FIXED_POINT_PLANNER 0
 
 // ##########################################################################################
 // ##                           Extruder control                                           ##
@@ -1008,10 +1123,40 @@ boards you might need to make it inverting.
 
 /** \brief Cache size for incoming commands.
 
-There should be no reason to increase this cache. Commands are nearly immediately sent to
-execution.
+Commands are nearly immediately sent to execution, so with a host waiting for the ok of every line 2 are enough.
+Hosts that stream several lines without waiting (M576 S1 adds the free places to the ok) profit from a larger
+cache, it hides the round trip time of the connection. Each place needs 52 bytes of RAM, max. 255.
 */
 #define GCODE_BUFFER_SIZE 2
+/** \brief Size of the serial receive buffer in bytes.
+
+The receive interrupt stores incoming bytes here until the main loop reads them. If the main loop is busy longer
+than it takes to fill the buffer, e.g. while planning a move at 250000 baud, bytes get lost and the host has to resend.
+Must be a power of 2 between 32 and 256 and uses that much RAM. M537 reports overflows and the highest fill level.
+*/
+#define SERIAL_RX_BUFFER_SIZE 128
+/** \brief Parse received commands directly inside the serial receive buffer.
+
+Normally every byte is copied into a line buffer before the complete line is parsed. With SERIAL_RX_ZERO_COPY 1
+the main loop scans the receive buffer for complete lines and parses them where they are, reading all complete
+lines at once as long as GCODE_BUFFER_SIZE allows. Not available with EXTERNALSERIAL.
+*/
+#define SERIAL_RX_ZERO_COPY 0
+/** \brief Accept version 3 frames of the binary repetier protocol.
+
+A frame packs several G0/G1 moves with micrometre deltas to the previous position and only one checksum, which cuts
+the serial data of dense curves to a third or less. M115 then reports REPETIER_PROTOCOL:3. Frames use absolute
+coordinates, see GCode::computeBinarySize for the format.
+*/
+#define BINARY_PROTOCOL_V3 0
+/** \brief Parse ASCII commands with the built in number scanner instead of strtod/strtol.
+
+The scanner reads each line once and converts each number as integer divided once by a power of ten, which is several times faster than
+the libc functions, especially on AVR. The values equal those of strtod, except on AVR for numbers with more than 7
+digits, which can be off by one bit there. Exponents like 1e3 are not accepted. Set it to 0 to use the libc functions,
+"make parsebench" in src/Host/Repetier compares both.
+*/
+#define FAST_ASCII_PARSER 1
 /** Appends the linenumber after every ok send, to acknowledge the received command. Uncomment for plain ok ACK if your host has problems with this */
 #define ACK_WITH_LINENUMBER
 /** Communication errors can swollow part of the ok, which tells the host software to send
@@ -1147,6 +1292,44 @@ is always running and is not hung up for some unknown reason. */
 #endif
 /** Show extended directory including file length. Don't use this with Pronterface! */
 #define SD_EXTENDED_DIR true
+/** \brief Read ahead buffers for printing from SD card.
+
+With 0 the file is read byte by byte through the SdFat cache, so every new block
+costs a full single block read while the command parser waits. With 2 or more
+buffers of 512 byte RAM each the next blocks are read in the background between
+commands, consecutive blocks with one multiple block read. M538 reports how often
+the parser had to wait for a block.
+*/
+#define SD_READ_AHEAD 0
+/** \brief Print motion stream files.
+
+Motion streams are G-code files converted to steps on the PC, see MotionRecord in Repetier.h.
+Their moves go directly to the path planner without parsing. Normal G-code files
+still print as before.
+*/
+#define MOTION_STREAM 0
+/** \brief Runs of consecutive clusters remembered for the printed file.
+
+When a file is selected, its cluster chain is read once and stored as up to SD_EXTENT_CACHE
+runs with 8 byte RAM each. Reading and M26 then compute the block of a file position without
+reading the FAT. A contiguous file needs one run. 0 disables the cache.
+*/
+#define SD_EXTENT_CACHE 0
+/** \brief Gather uploads (M28) in the read ahead buffers.
+
+Full buffers are written with one multiple block write and clusters are allocated
+SD_BUFFERED_UPLOAD at a time, the unused ones are freed at M29. 0 writes every command
+separately. Needs SD_READ_AHEAD. M29 reports the upload speed in both cases.
+*/
+#define SD_BUFFERED_UPLOAD 0
+/** \brief Entries of the directory index used by the LCD file browser.
+
+The browser keeps the position and a name hash of every listed file, so drawing a row
+reads one directory entry instead of scanning the directory. The index is built in the
+background after a directory change. Files beyond SD_DIR_INDEX are found by scanning
+from the last indexed one. 4 byte per entry, at most 254, 0 scans the directory as before.
+*/
+#define SD_DIR_INDEX 0
 // If you want support for G2/G3 arc commands set to true, otherwise false.
 #define ARC_SUPPORT true
 
@@ -20,7 +20,7 @@
 #define _EEPROM_H
 
 // Id to distinguish version changes
-#define EEPROM_PROTOCOL_VERSION 7
+#define EEPROM_PROTOCOL_VERSION 8
 
 /** Where to start with our datablock in memory. Can be moved if you
 have problems with other modules using the eeprom */
@@ -132,6 +132,11 @@ have problems with other modules using the eeprom */
 #define EPR_EXTRUDER_WAIT_RETRACT_TEMP 50
 #define EPR_EXTRUDER_WAIT_RETRACT_UNITS 52
 #define EPR_EXTRUDER_COOLER_SPEED       54
+#define EPR_EXTRUDER_MPC_HEATER_POWER   55
+#define EPR_EXTRUDER_MPC_HEAT_CAPACITY  59
+#define EPR_EXTRUDER_MPC_AMBIENT_LOSS   63
+#define EPR_EXTRUDER_MPC_SENSOR_RESPONSE 67
+#define EPR_EXTRUDER_MPC_FILAMENT_HEAT  71
 
 #ifndef Z_PROBE_BED_DISTANCE
 #define Z_PROBE_BED_DISTANCE 5.0
@@ -48,6 +48,9 @@ uint8 osAnalogInputCounter[ANALOG_INPUTS];
 uint osAnalogInputBuildup[ANALOG_INPUTS];
 uint8 osAnalogInputPos=0; // Current sampling position
 volatile uint osAnalogInputValues[ANALOG_INPUTS];
+#if ANALOG_INTERRUPT_SAMPLING
+uint osAnalogInputHistory[ANALOG_INPUTS][2]; // previous sums for the median
+#endif
 #endif
 
 #ifdef USE_GENERIC_THERMISTORTABLE_1
@@ -64,6 +67,9 @@ short temptable_generic3[GENERIC_THERM_NUM_ENTRIES][2];
 Is called every 100ms.
 */
 static uint8_t extruderTempErrors = 0;
+#ifdef TEMP_PID
+static bool autotuneModelRunning = false; ///< Autotune of autotuneIndex measures the model for M306
+#endif
 void Extruder::manageTemperatures()
 {
 #if FEATURE_WATCHDOG
@@ -72,7 +78,6 @@ void Extruder::manageTemperatures()
     uint8_t errorDetected = 0;
     for(uint8_t controller=0; controller<NUM_TEMPERATURE_LOOPS; controller++)
     {
-        if(controller == autotuneIndex) continue;
         TemperatureController *act = tempController[controller];
         // Get Temperature
         //int oldTemp = act->currentTemperatureC;
@@ -88,7 +93,7 @@ void Extruder::manageTemperatures()
                     extruder[0].coolerPWM = extruder[0].coolerSpeed;
             if(controller>1)
 #endif // NUM_EXTRUDER
-                if(act->currentTemperatureC<EXTRUDER_FAN_COOL_TEMP && act->targetTemperatureC<EXTRUDER_FAN_COOL_TEMP)
+                if(act->currentTemperatureC<EXTRUDER_FAN_COOL_TEMP && act->targetTemperatureC<EXTRUDER_FAN_COOL_TEMP && controller!=autotuneIndex)
                     extruder[controller].coolerPWM = 0;
                 else
                     extruder[controller].coolerPWM = extruder[controller].coolerSpeed;
@@ -112,7 +117,14 @@ void Extruder::manageTemperatures()
 #ifdef TEMP_PID
         act->tempArray[act->tempPointer++] = act->currentTemperatureC;
         act->tempPointer &= 3;
-        if(act->heatManager == 1)
+        if(controller == autotuneIndex)
+        {
+            if(autotuneModelRunning)
+                act->manageAutotuneModel();
+            else
+                act->manageAutotunePID();
+        }
+        else if(act->heatManager == 1)
         {
             uint8_t output;
             float error = act->targetTemperatureC - act->currentTemperatureC;
@@ -153,6 +165,13 @@ void Extruder::manageTemperatures()
             }
             pwm_pos[act->pwmIndex] = output;
         }
+        else if(act->heatManager == 4)     // model predictive control
+        {
+            float flow = 0,flowAhead = 0;
+            if(act == &Extruder::current->tempControl)
+                flowAhead = PrintLine::queuedExtrusionRate(MPC_FEED_FORWARD_TIME,flow);
+            pwm_pos[act->pwmIndex] = act->modelOutput(flow,flowAhead);
+        }
         else
 #endif
             if(act->heatManager == 2)    // Bang-bang with reduced change frequency to save relais life
@@ -318,6 +337,7 @@ void Extruder::initExtruder()
 void TemperatureController::updateTempControlVars()
 {
 #ifdef TEMP_PID
+    flags &= ~TEMPERATURE_CONTROLLER_FLAG_MODEL; // restart model with current temperature
     if(heatManager==1 && pidIGain!=0)   // prevent division by zero
     {
         tempIStateLimitMax = (float)pidDriveMax*10.0f/pidIGain;
@@ -372,6 +392,9 @@ void Extruder::selectExtruderById(uint8_t extruderId)
     }
     float fmax=((float)HAL::maxExtruderTimerFrequency()/((float)Printer::maxExtruderSpeed*Printer::axisStepsPerMM[E_AXIS])); // Limit feedrate to interrupt speed
     if(fmax<Printer::maxFeedrate[E_AXIS]) Printer::maxFeedrate[E_AXIS] = fmax;
+#endif
+#if FIXED_POINT_PLANNER
+    Printer::updateMaxFeedrateInterval(E_AXIS);
 #endif
     Extruder::current->tempControl.updateTempControlVars();
     float cx,cy,cz;
@@ -446,7 +469,7 @@ void Extruder::setHeatedBedTemperature(float temperatureInCelsius,bool beep)
 #if HAVE_HEATED_BED
     if(temperatureInCelsius>HEATED_BED_MAX_TEMP) temperatureInCelsius = HEATED_BED_MAX_TEMP;
     if(temperatureInCelsius<0) temperatureInCelsius = 0;
-    if(heatedBedController.targetTemperatureC==temperatureInCelsius) return; // don't flood log with messages if killed
+    if(heatedBedController.targetTemperatureC==temperatureInCelsius && autotuneIndex!=NUM_EXTRUDER) return; // don't flood log with messages if killed
     heatedBedController.setTargetTemperature(temperatureInCelsius);
     if(beep && temperatureInCelsius>30) heatedBedController.setAlarm(true);
     Com::printFLN(Com::tTargetBedColon,heatedBedController.targetTemperatureC,0);
@@ -528,7 +551,7 @@ const short temptable_8[NUMTEMPS_8][2] PROGMEM =
     {422,1520},{511,1440},{621,1360},{755,1280},{918,1200},{1114,1120},{1344,1040},{1608,960},{1902,880},{2216,800},{2539,720},
     {2851,640},{3137,560},{3385,480},{3588,400},{3746,320},{3863,240},{3945,160},{4002,80},{4038,0},{4061,-80},{4075,-160}
 };
-#define NUMTEMPS_9 67 // 100k Honeywell 135-104LAG-J01
+#define NUMTEMPS_9 58 // 100k Honeywell 135-104LAG-J01
 const short temptable_9[NUMTEMPS_9][2] PROGMEM =
 {
     {1*4, 941*8},{19*4, 362*8},{37*4, 299*8}, //top rating 300C
@@ -597,6 +620,101 @@ const uint8_t temptables_num[12] PROGMEM = {NUMTEMPS_1,NUMTEMPS_2,NUMTEMPS_3,NUM
                                  NUMTEMPS_9,NUMTEMPS_10,NUMTEMPS_11,NUMTEMPS_12
                                            };
 
+/** Reads entry i of a temperature table. The generic tables are computed at startup and are in RAM. */
+inline short temptableRead(const short *temptable,uint8_t i,bool inFlash)
+{
+    return inFlash ? (short)pgm_read_word(&temptable[i]) : temptable[i];
+}
+
+/** Returns the first row with a raw value above raw, num if there is none. */
+uint8_t temptableFindRow(const short *temptable,uint8_t num,bool inFlash,int raw)
+{
+    uint8_t lo = 1,hi = num; // hi = num means no row found
+    while(lo < hi)
+    {
+        uint8_t mid = (lo + hi) >> 1;
+        if(temptableRead(temptable,mid << 1,inFlash) > raw)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+/** Interpolates the temperature of raw from row lo found by temptableFindRow and the row before. */
+float temptableInterpolate(const short *temptable,uint8_t num,bool inFlash,uint8_t lo,int raw)
+{
+    if(lo >= num) // Overflow: Set to last value in the table
+        return temptableRead(temptable,(num << 1) - 1,inFlash);
+    short oldraw = temptableRead(temptable,(lo << 1) - 2,inFlash);
+    short oldtemp = temptableRead(temptable,(lo << 1) - 1,inFlash);
+    short newraw = temptableRead(temptable,lo << 1,inFlash);
+    short newtemp = temptableRead(temptable,(lo << 1) + 1,inFlash);
+    return oldtemp + (float)(raw-oldraw)*(float)(newtemp-oldtemp)/(newraw-oldraw);
+}
+
+/** \brief Converts a raw value into the temperature of a table.
+
+The table rows are {raw,temperature} pairs with rising raw values. A binary search finds the first
+row with a raw value above raw, the temperature is interpolated linearly from that row and the one
+before. Values above the table return the last temperature.
+\return Temperature in units of 1/8 degC.
+*/
+float temptableRawToTemp(const short *temptable,uint8_t num,bool inFlash,int raw)
+{
+    return temptableInterpolate(temptable,num,inFlash,temptableFindRow(temptable,num,inFlash,raw),raw);
+}
+
+#if THERMISTOR_DENSE_INDEX || CPU_ARCH==ARCH_HOST
+/** \brief Same as temptableRawToTemp for a flash table with a dense index.
+
+Entry i of the index is the row temptableFindRow returns for raw = i*16. The loop passes the rows
+starting between i*16 and raw, at most two for the built-in tables.
+*/
+float temptableIndexedRawToTemp(const short *temptable,const uint8_t *index,uint8_t num,int raw)
+{
+    if(raw < 0 || raw >= (THERMISTOR_INDEX_ENTRIES << THERMISTOR_INDEX_SHIFT))
+        return temptableRawToTemp(temptable,num,true,raw);
+    uint8_t lo = (uint8_t)pgm_read_byte(&index[raw >> THERMISTOR_INDEX_SHIFT]);
+    while(lo < num && (short)pgm_read_word(&temptable[lo << 1]) <= raw)
+        lo++;
+    return temptableInterpolate(temptable,num,true,lo,raw);
+}
+#endif
+#if THERMISTOR_DENSE_INDEX
+/** Tables used by a temperature controller get an index in thermistortables.h */
+#define TEMPTABLE_USED(n) ((NUM_EXTRUDER>0 && EXT0_TEMPSENSOR_TYPE==n) || (NUM_EXTRUDER>1 && EXT1_TEMPSENSOR_TYPE==n) || \
+    (NUM_EXTRUDER>2 && EXT2_TEMPSENSOR_TYPE==n) || (NUM_EXTRUDER>3 && EXT3_TEMPSENSOR_TYPE==n) || \
+    (NUM_EXTRUDER>4 && EXT4_TEMPSENSOR_TYPE==n) || (NUM_EXTRUDER>5 && EXT5_TEMPSENSOR_TYPE==n) || HEATED_BED_SENSOR_TYPE==n)
+#include "thermistortables.h"
+#endif
+
+/** \brief Converts a temperature in units of 1/8 degC into the raw value of a table.
+
+Same search as temptableRawToTemp, but for the first row beyond temp. The temperatures fall
+with rising raw values for NTC thermistors and rise for PTC sensors.
+*/
+int temptableTempToRaw(const short *temptable,uint8_t num,bool inFlash,int temp,bool ptc)
+{
+    uint8_t lo = 1,hi = num;
+    while(lo < hi)
+    {
+        uint8_t mid = (lo + hi) >> 1;
+        short newtemp = temptableRead(temptable,(mid << 1) + 1,inFlash);
+        if(ptc ? newtemp > temp : newtemp < temp)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    if(lo >= num) // Overflow: Set to last value in the table
+        return temptableRead(temptable,(num << 1) - 2,inFlash);
+    short oldraw = temptableRead(temptable,(lo << 1) - 2,inFlash);
+    short oldtemp = temptableRead(temptable,(lo << 1) - 1,inFlash);
+    short newraw = temptableRead(temptable,lo << 1,inFlash);
+    short newtemp = temptableRead(temptable,(lo << 1) + 1,inFlash);
+    return oldraw + (int32_t)(oldtemp-temp)*(int32_t)(newraw-oldraw)/(oldtemp-newtemp);
+}
+
 
 void TemperatureController::updateCurrentTemperature()
 {
@@ -661,29 +779,18 @@ void TemperatureController::updateCurrentTemperature()
     case 12:
     {
         type--;
-        uint8_t num = pgm_read_byte(&temptables_num[type])<<1;
-        uint8_t i=2;
+        uint8_t num = pgm_read_byte(&temptables_num[type]);
         const short *temptable = (const short *)pgm_read_word(&temptables[type]); //pgm_read_word_near(&temptables[type]);
-        short oldraw = pgm_read_word(&temptable[0]);
-        short oldtemp = pgm_read_word(&temptable[1]);
-        short newraw,newtemp;
         currentTemperature = (1023<<(2-ANALOG_REDUCE_BITS))-currentTemperature;
-        while(i<num)
+#if THERMISTOR_DENSE_INDEX
+        const uint8_t *index = (const uint8_t *)pgm_read_word(&temptables_index[type]);
+        if(index)
         {
-            newraw = pgm_read_word(&temptable[i++]);
-            newtemp = pgm_read_word(&temptable[i++]);
-            if (newraw > currentTemperature)
-            {
-                //OUT_P_I("RC O:",oldtemp);OUT_P_I_LN(" OR:",oldraw);
-                //OUT_P_I("RC N:",newtemp);OUT_P_I_LN(" NR:",newraw);
-                currentTemperatureC = TEMP_INT_TO_FLOAT(oldtemp + (float)(currentTemperature-oldraw)*(float)(newtemp-oldtemp)/(newraw-oldraw));
-                return;
-            }
-            oldtemp = newtemp;
-            oldraw = newraw;
+            currentTemperatureC = TEMP_INT_TO_FLOAT(temptableIndexedRawToTemp(temptable,index,num,currentTemperature));
+            break;
         }
-        // Overflow: Set to last value in the table
-        currentTemperatureC = TEMP_INT_TO_FLOAT(newtemp);
+#endif
+        currentTemperatureC = TEMP_INT_TO_FLOAT(temptableRawToTemp(temptable,num,true,currentTemperature));
     }
     break;
     case 50: // User defined PTC thermistor
@@ -691,26 +798,9 @@ void TemperatureController::updateCurrentTemperature()
     case 52:
     {
         type-=46;
-        uint8_t num = pgm_read_byte(&temptables_num[type])<<1;
-        uint8_t i=2;
+        uint8_t num = pgm_read_byte(&temptables_num[type]);
         const short *temptable = (const short *)pgm_read_word(&temptables[type]); //pgm_read_word_near(&temptables[type]);
-        short oldraw = pgm_read_word(&temptable[0]);
-        short oldtemp = pgm_read_word(&temptable[1]);
-        short newraw,newtemp;
-        while(i<num)
-        {
-            newraw = pgm_read_word(&temptable[i++]);
-            newtemp = pgm_read_word(&temptable[i++]);
-            if (newraw > currentTemperature)
-            {
-                currentTemperatureC = TEMP_INT_TO_FLOAT(oldtemp + (float)(currentTemperature-oldraw)*(float)(newtemp-oldtemp)/(newraw-oldraw));
-                return;
-            }
-            oldtemp = newtemp;
-            oldraw = newraw;
-        }
-        // Overflow: Set to last value in the table
-        currentTemperatureC = TEMP_INT_TO_FLOAT(newtemp);
+        currentTemperatureC = TEMP_INT_TO_FLOAT(temptableRawToTemp(temptable,num,true,currentTemperature));
         break;
     }
     case 60: // AD8495 (Delivers 5mV/degC vs the AD595's 10mV)
@@ -735,7 +825,6 @@ void TemperatureController::updateCurrentTemperature()
     case 98:
     case 99:
     {
-        uint8_t i=2;
         const short *temptable;
 #ifdef USE_GENERIC_THERMISTORTABLE_1
         if(type == 97)
@@ -749,34 +838,29 @@ void TemperatureController::updateCurrentTemperature()
         if(type == 99)
             temptable = (const short *)temptable_generic3;
 #endif
-        short oldraw = temptable[0];
-        short oldtemp = temptable[1];
-        short newraw,newtemp;
         currentTemperature = (1023<<(2-ANALOG_REDUCE_BITS))-currentTemperature;
-        while(i<GENERIC_THERM_NUM_ENTRIES*2)
-        {
-            newraw = temptable[i++];
-            newtemp = temptable[i++];
-            if (newraw > currentTemperature)
-            {
-                //OUT_P_I("RC O:",oldtemp);OUT_P_I_LN(" OR:",oldraw);
-                //OUT_P_I("RC N:",newtemp);OUT_P_I_LN(" NR:",newraw);
-                currentTemperatureC = TEMP_INT_TO_FLOAT(oldtemp + (float)(currentTemperature-oldraw)*(float)(newtemp-oldtemp)/(newraw-oldraw));
-                return;
-            }
-            oldtemp = newtemp;
-            oldraw = newraw;
-        }
-        // Overflow: Set to last value in the table
-        currentTemperatureC = TEMP_INT_TO_FLOAT(newtemp);
+        currentTemperatureC = TEMP_INT_TO_FLOAT(temptableRawToTemp(temptable,GENERIC_THERM_NUM_ENTRIES,false,currentTemperature));
         break;
     }
 #endif
     }
 }
 
+#ifdef TEMP_PID
+static void autotuneStop(TemperatureController *act);
+#endif
+
+/** Sets the target temperature. A new target for the controller in autotune ends the autotune,
+so M104 S0 or M109 stop it and the heat manager takes over. */
 void TemperatureController::setTargetTemperature(float target)
 {
+#ifdef TEMP_PID
+    if(autotuneIndex != 255 && tempController[autotuneIndex] == this)
+    {
+        autotuneStop(this);
+        Com::printInfoFLN(Com::tAutotuneStopped);
+    }
+#endif
     targetTemperatureC = target;
     int temp = TEMP_FLOAT_TO_INT(target);
     uint8_t type = sensorType;
@@ -796,26 +880,9 @@ void TemperatureController::setTargetTemperature(float target)
     case 12:
     {
         type--;
-        uint8_t num = pgm_read_byte(&temptables_num[type])<<1;
-        uint8_t i=2;
+        uint8_t num = pgm_read_byte(&temptables_num[type]);
         const short *temptable = (const short *)pgm_read_word(&temptables[type]); //pgm_read_word(&temptables[type]);
-        short oldraw = pgm_read_word(&temptable[0]);
-        short oldtemp = pgm_read_word(&temptable[1]);
-        short newraw,newtemp;
-        while(i<num)
-        {
-            newraw = pgm_read_word(&temptable[i++]);
-            newtemp = pgm_read_word(&temptable[i++]);
-            if (newtemp < temp)
-            {
-                targetTemperature = (1023<<(2-ANALOG_REDUCE_BITS))- oldraw + (int32_t)(oldtemp-temp)*(int32_t)(oldraw-newraw)/(oldtemp-newtemp);
-                return;
-            }
-            oldtemp = newtemp;
-            oldraw = newraw;
-        }
-        // Overflow: Set to last value in the table
-        targetTemperature = (1023<<(2-ANALOG_REDUCE_BITS))-newraw;
+        targetTemperature = (1023<<(2-ANALOG_REDUCE_BITS))-temptableTempToRaw(temptable,num,true,temp,false);
         break;
     }
     case 50: // user defined PTC thermistor
@@ -823,26 +890,9 @@ void TemperatureController::setTargetTemperature(float target)
     case 52:
     {
         type-=46;
-        uint8_t num = pgm_read_byte(&temptables_num[type])<<1;
-        uint8_t i=2;
+        uint8_t num = pgm_read_byte(&temptables_num[type]);
         const short *temptable = (const short *)pgm_read_word(&temptables[type]); //pgm_read_word(&temptables[type]);
-        short oldraw = pgm_read_word(&temptable[0]);
-        short oldtemp = pgm_read_word(&temptable[1]);
-        short newraw,newtemp;
-        while(i<num)
-        {
-            newraw = pgm_read_word(&temptable[i++]);
-            newtemp = pgm_read_word(&temptable[i++]);
-            if (newtemp > temp)
-            {
-                targetTemperature = oldraw + (int32_t)(oldtemp-temp)*(int32_t)(oldraw-newraw)/(oldtemp-newtemp);
-                return;
-            }
-            oldtemp = newtemp;
-            oldraw = newraw;
-        }
-        // Overflow: Set to last value in the table
-        targetTemperature = newraw;
+        targetTemperature = temptableTempToRaw(temptable,num,true,temp,true);
         break;
     }
     case 60: // HEATER_USES_AD8495 (Delivers 5mV/degC)
@@ -866,7 +916,6 @@ void TemperatureController::setTargetTemperature(float target)
     case 98:
     case 99:
     {
-        uint8_t i=2;
         const short *temptable;
 #ifdef USE_GENERIC_THERMISTORTABLE_1
         if(type == 97)
@@ -880,23 +929,7 @@ void TemperatureController::setTargetTemperature(float target)
         if(type == 99)
             temptable = (const short *)temptable_generic3;
 #endif
-        short oldraw = temptable[0];
-        short oldtemp = temptable[1];
-        short newraw,newtemp;
-        while(i<GENERIC_THERM_NUM_ENTRIES*2)
-        {
-            newraw = temptable[i++];
-            newtemp = temptable[i++];
-            if (newtemp < temp)
-            {
-                targetTemperature = (1023<<(2-ANALOG_REDUCE_BITS))- oldraw + (int32_t)(oldtemp-temp)*(int32_t)(oldraw-newraw)/(oldtemp-newtemp);
-                return;
-            }
-            oldtemp = newtemp;
-            oldraw = newraw;
-        }
-        // Overflow: Set to last value in the table
-        targetTemperature = (1023<<(2-ANALOG_REDUCE_BITS))-newraw;
+        targetTemperature = (1023<<(2-ANALOG_REDUCE_BITS))-temptableTempToRaw(temptable,GENERIC_THERM_NUM_ENTRIES,false,temp,false);
         break;
     }
 #endif
@@ -917,144 +950,393 @@ void Extruder::disableAllHeater()
 }
 
 #ifdef TEMP_PID
+// State of the PID autotune of controller autotuneIndex
+static float autotuneTemp;
+static bool autotuneStoreValues;
+static bool autotuneHeating;
+static uint8_t autotuneCycles;
+static uint32_t autotuneT1;
+static uint32_t autotuneT2;
+static uint32_t autotuneReportTime;
+static int32_t autotuneHigh;
+static int32_t autotuneLow;
+static int32_t autotuneBias;
+static int32_t autotuneD;
+static float autotuneMaxTemp;
+static float autotuneMinTemp;
+static float autotuneKp,autotuneKi,autotuneKd;
+
+/** \brief Starts the PID autotune of this controller.
+
+Only one controller can be tuned at a time, a running autotune is replaced. The heater is
+switched between bias+d and bias-d around temp by manageAutotunePID, which manageTemperatures
+calls instead of the heat manager. So the other heaters, moves and commands continue meanwhile.
+The target temperature of the controller is kept, its heat manager takes over again at the end.
+*/
 void TemperatureController::autotunePID(float temp,uint8_t controllerId,bool storeValues)
 {
-    float currentTemp;
-    int cycles=0;
-    bool heating = true;
-
-    uint32_t temp_millis = HAL::timeInMilliseconds();
-    uint32_t t1=temp_millis;
-    uint32_t t2=temp_millis;
-    int32_t t_high;
-    int32_t t_low;
-
-    int32_t bias=pidMax>>1;
-    int32_t d = pidMax>>1;
-    float Ku, Tu;
-    float Kp, Ki, Kd;
-    float maxTemp=20, minTemp=20;
-
     Com::printInfoFLN(Com::tPIDAutotuneStart);
-
-    Extruder::disableAllHeater(); // switch off all heaters.
-    autotuneIndex = controllerId;
+    if(autotuneIndex != 255)
+        pwm_pos[tempController[autotuneIndex]->pwmIndex] = 0;
+    autotuneTemp = temp;
+    autotuneStoreValues = storeValues;
+    autotuneModelRunning = false;
+    autotuneHeating = true;
+    autotuneCycles = 0;
+    autotuneT1 = autotuneT2 = autotuneReportTime = HAL::timeInMilliseconds();
+    autotuneBias = autotuneD = pidMax>>1;
+    autotuneMaxTemp = autotuneMinTemp = 20;
     pwm_pos[pwmIndex] = pidMax;
     if(controllerId<NUM_EXTRUDER)
     {
         extruder[controllerId].coolerPWM = extruder[controllerId].coolerSpeed;
         extruder[0].coolerPWM = extruder[0].coolerSpeed;
     }
-    for(;;)
-    {
-#if FEATURE_WATCHDOG
-        HAL::pingWatchdog();
-#endif // FEATURE_WATCHDOG
+    autotuneIndex = controllerId;
+}
+
+/** Ends the autotune. The heater is off until the heat manager sets it for the target temperature. */
+static void autotuneStop(TemperatureController *act)
+{
+    pwm_pos[act->pwmIndex] = 0;
+    autotuneIndex = 255;
+}
 
-        updateCurrentTemperature();
-        currentTemp = currentTemperatureC;
-        unsigned long time = HAL::timeInMilliseconds();
-        maxTemp=RMath::max(maxTemp,currentTemp);
-        minTemp=RMath::min(minTemp,currentTemp);
-        if(heating == true && currentTemp > temp)   // switch heating -> off
+/** \brief One step of the PID autotune, called every 100ms with the new temperature. */
+void TemperatureController::manageAutotunePID()
+{
+    float currentTemp = currentTemperatureC;
+    uint32_t time = HAL::timeInMilliseconds();
+    autotuneMaxTemp = RMath::max(autotuneMaxTemp,currentTemp);
+    autotuneMinTemp = RMath::min(autotuneMinTemp,currentTemp);
+    if(autotuneHeating && currentTemp > autotuneTemp)   // switch heating -> off
+    {
+        if(time - autotuneT2 > (autotuneIndex<NUM_EXTRUDER ? 2500 : 1500))
         {
-            if(time - t2 > (controllerId<NUM_EXTRUDER ? 2500 : 1500))
-            {
-                heating=false;
-                pwm_pos[pwmIndex] = (bias - d);
-                t1=time;
-                t_high=t1 - t2;
-                maxTemp=temp;
-            }
+            autotuneHeating = false;
+            pwm_pos[pwmIndex] = (autotuneBias - autotuneD);
+            autotuneT1 = time;
+            autotuneHigh = autotuneT1 - autotuneT2;
+            autotuneMaxTemp = autotuneTemp;
         }
-        if(heating == false && currentTemp < temp)
+    }
+    if(!autotuneHeating && currentTemp < autotuneTemp)
+    {
+        if(time - autotuneT1 > (autotuneIndex<NUM_EXTRUDER ? 5000 : 3000))
         {
-            if(time - t1 > (controllerId<NUM_EXTRUDER ? 5000 : 3000))
+            autotuneHeating = true;
+            autotuneT2 = time;
+            autotuneLow = autotuneT2 - autotuneT1; // half wave length
+            if(autotuneCycles > 0)
             {
-                heating=true;
-                t2=time;
-                t_low=t2 - t1; // half wave length
-                if(cycles > 0)
+                autotuneBias += (autotuneD*(autotuneHigh - autotuneLow))/(autotuneLow + autotuneHigh);
+                autotuneBias = constrain(autotuneBias, 20 ,pidMax-20);
+                if(autotuneBias > pidMax/2) autotuneD = pidMax - 1 - autotuneBias;
+                else autotuneD = autotuneBias;
+
+                Com::printF(Com::tAPIDBias,autotuneBias);
+                Com::printF(Com::tAPIDD,autotuneD);
+                Com::printF(Com::tAPIDMin,autotuneMinTemp);
+                Com::printFLN(Com::tAPIDMax,autotuneMaxTemp);
+                if(autotuneCycles > 2)
                 {
-                    bias += (d*(t_high - t_low))/(t_low + t_high);
-                    bias = constrain(bias, 20 ,pidMax-20);
-                    if(bias > pidMax/2) d = pidMax - 1 - bias;
-                    else d = bias;
-
-                    Com::printF(Com::tAPIDBias,bias);
-                    Com::printF(Com::tAPIDD,d);
-                    Com::printF(Com::tAPIDMin,minTemp);
-                    Com::printFLN(Com::tAPIDMax,maxTemp);
-                    if(cycles > 2)
-                    {
-                        // Parameter according Ziegler¡§CNichols method: http://en.wikipedia.org/wiki/Ziegler%E2%80%93Nichols_method
-                        Ku = (4.0*d)/(3.14159*(maxTemp-minTemp));
-                        Tu = ((float)(t_low + t_high)/1000.0);
-                        Com::printF(Com::tAPIDKu,Ku);
-                        Com::printFLN(Com::tAPIDTu,Tu);
-                        Kp = 0.6*Ku;
-                        Ki = 2*Kp/Tu;
-                        Kd = Kp*Tu*0.125;
-                        Com::printFLN(Com::tAPIDClassic);
-                        Com::printFLN(Com::tAPIDKp,Kp);
-                        Com::printFLN(Com::tAPIDKi,Ki);
-                        Com::printFLN(Com::tAPIDKd,Kd);
-                        /*
-                        Kp = 0.33*Ku;
-                        Ki = Kp/Tu;
-                        Kd = Kp*Tu/3;
-                        OUT_P_LN(" Some overshoot");
-                        OUT_P_F_LN(" Kp: ",Kp);
-                        OUT_P_F_LN(" Ki: ",Ki);
-                        OUT_P_F_LN(" Kd: ",Kd);
-                        Kp = 0.2*Ku;
-                        Ki = 2*Kp/Tu;
-                        Kd = Kp*Tu/3;
-                        OUT_P_LN(" No overshoot");
-                        OUT_P_F_LN(" Kp: ",Kp);
-                        OUT_P_F_LN(" Ki: ",Ki);
-                        OUT_P_F_LN(" Kd: ",Kd);
-                        */
-                    }
+                    // Parameter according Ziegler¡§CNichols method: http://en.wikipedia.org/wiki/Ziegler%E2%80%93Nichols_method
+                    float Ku = (4.0*autotuneD)/(3.14159*(autotuneMaxTemp-autotuneMinTemp));
+                    float Tu = ((float)(autotuneLow + autotuneHigh)/1000.0);
+                    Com::printF(Com::tAPIDKu,Ku);
+                    Com::printFLN(Com::tAPIDTu,Tu);
+                    autotuneKp = 0.6*Ku;
+                    autotuneKi = 2*autotuneKp/Tu;
+                    autotuneKd = autotuneKp*Tu*0.125;
+                    Com::printFLN(Com::tAPIDClassic);
+                    Com::printFLN(Com::tAPIDKp,autotuneKp);
+                    Com::printFLN(Com::tAPIDKi,autotuneKi);
+                    Com::printFLN(Com::tAPIDKd,autotuneKd);
+                    /*
+                    Kp = 0.33*Ku;
+                    Ki = Kp/Tu;
+                    Kd = Kp*Tu/3;
+                    OUT_P_LN(" Some overshoot");
+                    OUT_P_F_LN(" Kp: ",Kp);
+                    OUT_P_F_LN(" Ki: ",Ki);
+                    OUT_P_F_LN(" Kd: ",Kd);
+                    Kp = 0.2*Ku;
+                    Ki = 2*Kp/Tu;
+                    Kd = Kp*Tu/3;
+                    OUT_P_LN(" No overshoot");
+                    OUT_P_F_LN(" Kp: ",Kp);
+                    OUT_P_F_LN(" Ki: ",Ki);
+                    OUT_P_F_LN(" Kd: ",Kd);
+                    */
                 }
-                pwm_pos[pwmIndex] = (bias + d);
-                cycles++;
-                minTemp=temp;
             }
+            pwm_pos[pwmIndex] = (autotuneBias + autotuneD);
+            autotuneCycles++;
+            autotuneMinTemp = autotuneTemp;
         }
-        if(currentTemp > (temp + 20))
+    }
+    if(currentTemp > (autotuneTemp + 20))
+    {
+        Com::printErrorFLN(Com::tAPIDFailedHigh);
+        autotuneStop(this);
+        return;
+    }
+    if(time - autotuneReportTime > 1000)
+    {
+        autotuneReportTime = time;
+        Commands::printTemperatures();
+    }
+    if(((time - autotuneT1) + (time - autotuneT2)) > (10L*60L*1000L*2L))   // 20 Minutes
+    {
+        Com::printErrorFLN(Com::tAPIDFailedTimeout);
+        autotuneStop(this);
+        return;
+    }
+    if(autotuneCycles > 5)
+    {
+        Com::printInfoFLN(Com::tAPIDFinished);
+        autotuneStop(this);
+        if(autotuneStoreValues)
         {
-            Com::printErrorFLN(Com::tAPIDFailedHigh);
-            Extruder::disableAllHeater();
-            return;
+            pidPGain = autotuneKp;
+            pidIGain = autotuneKi;
+            pidDGain = autotuneKd;
+            heatManager = 1;
+            updateTempControlVars();
+            EEPROM::storeDataIntoEEPROM();
         }
-        if(time - temp_millis > 1000)
+    }
+}
+
+/** \brief Heater output of the model predictive heat manager 4.
+
+Heater block and sensor are modeled by two temperatures. Every call advances the model by the
+100ms since the last call with the last output and the filament extruded, then moves it half way
+to the measured temperature. The output is the power bringing the block to the target in the next
+step plus the losses at target temperature, including the filament of the moves queued for the
+next MPC_FEED_FORWARD_TIME seconds. So the heater follows a rising flow before the nozzle cools down.
+\param flow Filament speed of the move in print in mm/s.
+\param flowAhead Average filament speed of the queued moves in mm/s.
+*/
+uint8_t TemperatureController::modelOutput(float flow,float flowAhead)
+{
+    if(mpcHeaterPower <= 0 || mpcHeatCapacity <= 0) // No model, fall back to bang bang
+        return currentTemperature < targetTemperature ? pidMax : 0;
+    if((flags & TEMPERATURE_CONTROLLER_FLAG_MODEL) == 0)
+    {
+        mpcBlockTemp = mpcSensorTemp = currentTemperatureC;
+        mpcAmbientTemp = RMath::min(currentTemperatureC,(float)MPC_AMBIENT_TEMPERATURE);
+        flags |= TEMPERATURE_CONTROLLER_FLAG_MODEL;
+    }
+    float loss = (mpcAmbientLoss + mpcFilamentHeat * flow) * (mpcBlockTemp - mpcAmbientTemp);
+    mpcBlockTemp += (mpcHeaterPower * pwm_pos[pwmIndex] * 0.0039216f - loss) * 0.1f / mpcHeatCapacity;
+    mpcSensorTemp += (mpcBlockTemp - mpcSensorTemp) * mpcSensorResponse * 0.1f;
+    float error = currentTemperatureC - mpcSensorTemp;
+    // Close to the target a lasting error means the losses are wrong, correct them with the ambient temperature
+    if(targetTemperatureC >= 20.0f && fabs(targetTemperatureC - currentTemperatureC) < 5.0f)
+        mpcAmbientTemp = constrain(mpcAmbientTemp + 2.0f * error,0.0f,targetTemperatureC);
+    mpcBlockTemp += 0.5f * error;
+    mpcSensorTemp += 0.5f * error;
+    if(targetTemperatureC < 20.0f) return 0; // off is off
+    float power = (targetTemperatureC - mpcBlockTemp) * mpcHeatCapacity * 10.0f
+                  + (mpcAmbientLoss + mpcFilamentHeat * flowAhead) * (targetTemperatureC - mpcAmbientTemp);
+    float output = power * 255.0f / mpcHeaterPower;
+    if(output <= 0) return 0;
+    if(output >= pidMax) return pidMax;
+    return (uint8_t)output;
+}
+
+// State of the model autotune of controller autotuneIndex
+static uint8_t modelState; ///< 0 = cooling down, 1 = heating with pidMax, 2 = holding the temperature
+static uint16_t modelTicks;
+static uint16_t modelSampleTicks; ///< 100ms steps per sample, doubles when samples are full
+static uint8_t modelNumSamples;
+static float modelSamples[16]; ///< Mean temperatures of equal intervals while heating
+static float modelSum;
+static float modelAmbient;
+static float modelRiseTemp;
+static float modelEnergy; ///< Heater energy since heating started in J
+static float modelExcess; ///< Integral of temperature above ambient since heating started in K*s
+static float modelHoldEnergy; ///< Heater energy of the last minute of holding in J
+static float modelHoldExcess;
+
+/** \brief Starts measuring the model of heat manager 4.
+
+Like autotunePID the measurement runs in manageTemperatures, it ends with a new target temperature
+of the controller. It waits until the heater has cooled down to ambient temperature, heats with
+pidMax up to temp and then holds the temperature for 90 seconds with a proportional output.
+The mean heater power of the last minute gives the ambient loss at steady state, the energy
+balance of the whole measurement the heat capacity. Only the delay of the heating curve is fitted,
+by least squares over the samples of the early rise, and gives the sensor response.
+The filament heat is not measured.
+*/
+void TemperatureController::autotuneModel(float temp,uint8_t controllerId,bool storeValues)
+{
+    Com::printInfoFLN(Com::tMPCAutotuneStart);
+    if(reportTempsensorError()) return;
+    if(autotuneIndex != 255)
+        pwm_pos[tempController[autotuneIndex]->pwmIndex] = 0;
+    autotuneTemp = temp;
+    autotuneStoreValues = storeValues;
+    autotuneModelRunning = true;
+    modelState = 0;
+    modelTicks = 0;
+    modelAmbient = currentTemperatureC;
+    autotuneT1 = autotuneReportTime = HAL::timeInMilliseconds();
+    pwm_pos[pwmIndex] = 0;
+    if(controllerId<NUM_EXTRUDER)
+    {
+        extruder[controllerId].coolerPWM = extruder[controllerId].coolerSpeed;
+        extruder[0].coolerPWM = extruder[0].coolerSpeed;
+    }
+    autotuneIndex = controllerId;
+}
+
+/** \brief One step of the model autotune, called every 100ms with the new temperature. */
+void TemperatureController::manageAutotuneModel()
+{
+    float currentTemp = currentTemperatureC;
+    uint32_t time = HAL::timeInMilliseconds();
+    if(time - autotuneReportTime > 1000)
+    {
+        autotuneReportTime = time;
+        Commands::printTemperatures();
+    }
+#ifdef MAXTEMP
+    bool tooHigh = currentTemp > MAXTEMP;
+#else
+    bool tooHigh = false;
+#endif
+    if(tooHigh || currentTemp > autotuneTemp + 20)
+    {
+        Com::printErrorFLN(Com::tMPCFailedHigh);
+        autotuneStop(this);
+        return;
+    }
+    if(time - autotuneT1 > 20L*60L*1000L)   // 20 Minutes
+    {
+        Com::printErrorFLN(Com::tMPCFailedTimeout);
+        autotuneStop(this);
+        return;
+    }
+    if(modelState == 0)   // cooled down when the temperature changed less then 1 degree in 30 seconds
+    {
+        if(++modelTicks < 300) return;
+        modelTicks = 0;
+        if(fabs(currentTemp - modelAmbient) < 1.0f)
         {
-            temp_millis = time;
-            Commands::printTemperatures();
+            modelState = 1;
+            modelNumSamples = 0;
+            modelSampleTicks = 10;
+            modelSum = modelEnergy = modelExcess = 0;
+            pwm_pos[pwmIndex] = pidMax;
+            autotuneT2 = time;
+            modelRiseTemp = currentTemp;
         }
-        if(((time - t1) + (time - t2)) > (10L*60L*1000L*2L))   // 20 Minutes
+        modelAmbient = currentTemp;
+        return;
+    }
+    // The output of the last 100ms heated the block to the current temperature
+    modelEnergy += mpcHeaterPower * pwm_pos[pwmIndex] * 0.0039216f * 0.1f;
+    modelExcess += (currentTemp - modelAmbient) * 0.1f;
+    if(modelState == 1)
+    {
+        if(currentTemp >= autotuneTemp)
         {
-            Com::printErrorFLN(Com::tAPIDFailedTimeout);
-            Extruder::disableAllHeater();
-            return;
+            modelState = 2;
+            modelTicks = 0;
+            modelHoldEnergy = modelHoldExcess = 0;
         }
-        if(cycles > 5)
+        else
         {
-            Com::printInfoFLN(Com::tAPIDFinished);
-            Extruder::disableAllHeater();
-            if(storeValues)
+            if(time - autotuneT2 > 60000)   // heater or sensor not working
+            {
+                if(currentTemp < modelRiseTemp + 2.0f)
+                {
+                    Com::printErrorFLN(Com::tMPCFailedNoRise);
+                    autotuneStop(this);
+                    return;
+                }
+                autotuneT2 = time;
+                modelRiseTemp = currentTemp;
+            }
+            modelSum += currentTemp;
+            if(++modelTicks < modelSampleTicks) return;
+            modelSamples[modelNumSamples++] = modelSum / modelSampleTicks;
+            modelSum = 0;
+            modelTicks = 0;
+            if(modelNumSamples == 16)   // merge pairs and sample half as often
             {
-                pidPGain = Kp;
-                pidIGain = Ki;
-                pidDGain = Kd;
-                heatManager = 1;
-                EEPROM::storeDataIntoEEPROM();
+                for(uint8_t i = 0; i < 8; i++)
+                    modelSamples[i] = 0.5f * (modelSamples[2 * i] + modelSamples[2 * i + 1]);
+                modelNumSamples = 8;
+                modelSampleTicks <<= 1;
             }
             return;
         }
-        UI_MEDIUM;
-        UI_SLOW;
+    }
+    if(modelTicks >= 300)   // settled, measure the loss
+    {
+        modelHoldEnergy += mpcHeaterPower * pwm_pos[pwmIndex] * 0.0039216f * 0.1f;
+        modelHoldExcess += (currentTemp - modelAmbient) * 0.1f;
+    }
+    if(++modelTicks < 900)
+    {
+        // Full power 4 degrees below temp down to off 4 degrees above
+        float output = (autotuneTemp + 4.0f - currentTemp) * pidMax * 0.125f;
+        pwm_pos[pwmIndex] = output <= 0 ? 0 : (output >= pidMax ? pidMax : (uint8_t)output);
+        return;
+    }
+    autotuneStop(this);
+    float rise = currentTemp - modelAmbient;
+    float loss = modelHoldExcess > 0 ? modelHoldEnergy / modelHoldExcess : 0;
+    float energyCapacity = rise > 0 ? (modelEnergy - loss * modelExcess) / rise : 0;
+    float asymptote = loss > 0 ? modelAmbient + mpcHeaterPower * pidMax / (255.0f * loss) : 0;
+    float sampleTime = modelSampleTicks * 0.1f;
+    float capacity = energyCapacity;
+    float sensorTime = 0;
+    // While heating the block was ahead of the sensor by sensorTime times the slope, that energy went
+    // into the loss integral. The sensor time comes from the delay of the heating curve, which in turn
+    // depends on the capacity, so both are refined twice.
+    for(uint8_t pass = 0; pass < 2; pass++)
+    {
+        capacity = energyCapacity - loss * sensorTime;
+        // Heating curve T(t) = asymptote - (asymptote - ambient) * exp(-(t - delay) / tau) of the measured
+        // model. The mean of the delays of the samples is their least squares fit. Samples between 10% and
+        // 50% of the rise are past the start of the sensor and depend least on tau.
+        float tau = loss > 0 && capacity > 0 ? capacity / loss : 0;
+        float delay = 0;
+        uint8_t n = 0;
+        for(uint8_t i = 0; i < modelNumSamples && tau > 0; i++)
+        {
+            float part = (modelSamples[i] - modelAmbient) / (autotuneTemp - modelAmbient);
+            if(part < 0.1f || part > 0.5f) continue;
+            delay += (i + 0.5f) * sampleTime + 0.05f + tau * log((asymptote - modelSamples[i]) / (asymptote - modelAmbient));
+            n++;
+        }
+        if(n < 3)
+        {
+            Com::printErrorFLN(Com::tMPCFailedCurve);
+            return;
+        }
+        delay /= n;
+        // A sensor following with time constant s delays the curve by -tau * log(1 - s / tau)
+        sensorTime = delay > 0 ? tau * (1.0f - exp(-delay / tau)) : 0;
+    }
+    capacity = energyCapacity - loss * sensorTime;
+    float response = sensorTime > 0.5f ? 1.0f / sensorTime : 2.0f;
+    Com::printFLN(Com::tMPCHeatCapacity,capacity);
+    Com::printFLN(Com::tMPCAmbientLoss,loss,4);
+    Com::printFLN(Com::tMPCSensorResponse,response,4);
+    Com::printInfoFLN(Com::tMPCFinished);
+    if(autotuneStoreValues)
+    {
+        mpcHeatCapacity = capacity;
+        mpcAmbientLoss = loss;
+        mpcSensorResponse = response;
+        heatManager = 4;
+        updateTempControlVars();
+        EEPROM::storeDataIntoEEPROM();
     }
 }
 #endif
@@ -1183,6 +1465,7 @@ Extruder extruder[NUM_EXTRUDER] =
             0,EXT0_TEMPSENSOR_TYPE,EXT0_SENSOR_INDEX,0,0,0,0,0,EXT0_HEAT_MANAGER
 #ifdef TEMP_PID
             ,0,EXT0_PID_INTEGRAL_DRIVE_MAX,EXT0_PID_INTEGRAL_DRIVE_MIN,EXT0_PID_P,EXT0_PID_I,EXT0_PID_D,EXT0_PID_MAX,0,0,0,{0,0,0,0}
+            ,EXT0_MPC_HEATER_POWER,EXT0_MPC_HEAT_CAPACITY,EXT0_MPC_AMBIENT_LOSS,EXT0_MPC_SENSOR_RESPONSE,EXT0_MPC_FILAMENT_HEAT,0,0,0
 #endif
         ,0}
         ,ext0_select_cmd,ext0_deselect_cmd,EXT0_EXTRUDER_COOLER_SPEED,0
@@ -1203,6 +1486,7 @@ Extruder extruder[NUM_EXTRUDER] =
             1,EXT1_TEMPSENSOR_TYPE,EXT1_SENSOR_INDEX,0,0,0,0,0,EXT1_HEAT_MANAGER
 #ifdef TEMP_PID
             ,0,EXT1_PID_INTEGRAL_DRIVE_MAX,EXT1_PID_INTEGRAL_DRIVE_MIN,EXT1_PID_P,EXT1_PID_I,EXT1_PID_D,EXT1_PID_MAX,0,0,0,{0,0,0,0}
+            ,EXT1_MPC_HEATER_POWER,EXT1_MPC_HEAT_CAPACITY,EXT1_MPC_AMBIENT_LOSS,EXT1_MPC_SENSOR_RESPONSE,EXT1_MPC_FILAMENT_HEAT,0,0,0
 #endif
         ,0}
         ,ext1_select_cmd,ext1_deselect_cmd,EXT1_EXTRUDER_COOLER_SPEED,0
@@ -1223,6 +1507,7 @@ Extruder extruder[NUM_EXTRUDER] =
             2,EXT2_TEMPSENSOR_TYPE,EXT2_SENSOR_INDEX,0,0,0,0,0,EXT2_HEAT_MANAGER
 #ifdef TEMP_PID
             ,0,EXT2_PID_INTEGRAL_DRIVE_MAX,EXT2_PID_INTEGRAL_DRIVE_MIN,EXT2_PID_P,EXT2_PID_I,EXT2_PID_D,EXT2_PID_MAX,0,0,0,{0,0,0,0}
+            ,EXT2_MPC_HEATER_POWER,EXT2_MPC_HEAT_CAPACITY,EXT2_MPC_AMBIENT_LOSS,EXT2_MPC_SENSOR_RESPONSE,EXT2_MPC_FILAMENT_HEAT,0,0,0
 #endif
         ,0}
         ,ext2_select_cmd,ext2_deselect_cmd,EXT2_EXTRUDER_COOLER_SPEED,0
@@ -1243,6 +1528,7 @@ Extruder extruder[NUM_EXTRUDER] =
             3,EXT3_TEMPSENSOR_TYPE,EXT3_SENSOR_INDEX,0,0,0,0,0,EXT3_HEAT_MANAGER
 #ifdef TEMP_PID
             ,0,EXT3_PID_INTEGRAL_DRIVE_MAX,EXT3_PID_INTEGRAL_DRIVE_MIN,EXT3_PID_P,EXT3_PID_I,EXT3_PID_D,EXT3_PID_MAX,0,0,0,{0,0,0,0}
+            ,EXT3_MPC_HEATER_POWER,EXT3_MPC_HEAT_CAPACITY,EXT3_MPC_AMBIENT_LOSS,EXT3_MPC_SENSOR_RESPONSE,EXT3_MPC_FILAMENT_HEAT,0,0,0
 #endif
         ,0}
         ,ext3_select_cmd,ext3_deselect_cmd,EXT3_EXTRUDER_COOLER_SPEED,0
@@ -1263,6 +1549,7 @@ Extruder extruder[NUM_EXTRUDER] =
             4,EXT4_TEMPSENSOR_TYPE,EXT4_SENSOR_INDEX,0,0,0,0,0,EXT4_HEAT_MANAGER
 #ifdef TEMP_PID
             ,0,EXT4_PID_INTEGRAL_DRIVE_MAX,EXT4_PID_INTEGRAL_DRIVE_MIN,EXT4_PID_P,EXT4_PID_I,EXT4_PID_D,EXT4_PID_MAX,0,0,0,{0,0,0,0}
+            ,EXT4_MPC_HEATER_POWER,EXT4_MPC_HEAT_CAPACITY,EXT4_MPC_AMBIENT_LOSS,EXT4_MPC_SENSOR_RESPONSE,EXT4_MPC_FILAMENT_HEAT,0,0,0
 #endif
         ,0}
         ,ext4_select_cmd,ext4_deselect_cmd,EXT4_EXTRUDER_COOLER_SPEED,0
@@ -1283,6 +1570,7 @@ Extruder extruder[NUM_EXTRUDER] =
             5,EXT5_TEMPSENSOR_TYPE,EXT5_SENSOR_INDEX,0,0,0,0,0,EXT5_HEAT_MANAGER
 #ifdef TEMP_PID
             ,0,EXT5_PID_INTEGRAL_DRIVE_MAX,EXT5_PID_INTEGRAL_DRIVE_MIN,EXT5_PID_P,EXT5_PID_I,EXT5_PID_D,EXT5_PID_MAX,0,0,0,{0,0,0,0}
+            ,EXT5_MPC_HEATER_POWER,EXT5_MPC_HEAT_CAPACITY,EXT5_MPC_AMBIENT_LOSS,EXT5_MPC_SENSOR_RESPONSE,EXT5_MPC_FILAMENT_HEAT,0,0,0
 #endif
         ,0}
         ,ext5_select_cmd,ext5_deselect_cmd,EXT5_EXTRUDER_COOLER_SPEED,0
@@ -1295,6 +1583,7 @@ Extruder extruder[NUM_EXTRUDER] =
 TemperatureController heatedBedController = {NUM_EXTRUDER,HEATED_BED_SENSOR_TYPE,BED_SENSOR_INDEX,0,0,0,0,0,HEATED_BED_HEAT_MANAGER
 #ifdef TEMP_PID
         ,0,HEATED_BED_PID_INTEGRAL_DRIVE_MAX,HEATED_BED_PID_INTEGRAL_DRIVE_MIN,HEATED_BED_PID_PGAIN,HEATED_BED_PID_IGAIN,HEATED_BED_PID_DGAIN,HEATED_BED_PID_MAX,0,0,0,{0,0,0,0}
+        ,0,0,0,0,0,0,0,0
 #endif
                                             ,0};
 #else
@@ -13,6 +13,7 @@ extern bool reportTempsensorError(); ///< Report defect sensors
 extern uint8_t manageMonitor;
 
 #define TEMPERATURE_CONTROLLER_FLAG_ALARM 1
+#define TEMPERATURE_CONTROLLER_FLAG_MODEL 2 ///< Model state of heat manager 4 is initialized
 /** TemperatureController manages one heater-temperature sensore loop. You can have up to
 4 loops allowing pid/bang bang for up to 3 extruder and the heated bed.
 
@@ -28,7 +29,7 @@ class TemperatureController
     float currentTemperatureC; ///< Current temperature in degC.
     float targetTemperatureC; ///< Target temperature in degC.
     uint32_t lastTemperatureUpdate; ///< Time in millis of the last temperature update.
-    int8_t heatManager; ///< How is temperature controled. 0 = on/off, 1 = PID-Control, 3 = deat time control
+    int8_t heatManager; ///< How is temperature controled. 0 = on/off, 1 = PID-Control, 3 = deat time control, 4 = model predictive
 #ifdef TEMP_PID
     float tempIState; ///< Temp. var. for PID computation.
     uint8_t pidDriveMax; ///< Used for windup in PID calculation.
@@ -41,6 +42,14 @@ class TemperatureController
     float tempIStateLimitMin;
     uint8_t tempPointer;
     float tempArray[4];
+    float mpcHeaterPower; ///< Heater power at full pwm in W for heat manager 4.
+    float mpcHeatCapacity; ///< Heat capacity of heater block and nozzle in J/K.
+    float mpcAmbientLoss; ///< Heat loss to the surrounding air in W/K.
+    float mpcSensorResponse; ///< Part of the block to sensor difference the sensor follows per second.
+    float mpcFilamentHeat; ///< Heat to warm 1 mm of filament by 1 K in J/(mm*K).
+    float mpcBlockTemp; ///< Modeled temperature of the heater block.
+    float mpcSensorTemp; ///< Modeled temperature at the sensor.
+    float mpcAmbientTemp; ///< Ambient temperature, adapted while the target is held.
 #endif
     uint8_t flags;
 
@@ -50,7 +59,11 @@ class TemperatureController
     inline bool isAlarm() {return flags & TEMPERATURE_CONTROLLER_FLAG_ALARM;}
     inline void setAlarm(bool on) {if(on) flags |= TEMPERATURE_CONTROLLER_FLAG_ALARM; else flags &= ~TEMPERATURE_CONTROLLER_FLAG_ALARM;}
 #ifdef TEMP_PID
+    uint8_t modelOutput(float flow,float flowAhead);
     void autotunePID(float temp,uint8_t controllerId,bool storeResult);
+    void manageAutotunePID();
+    void autotuneModel(float temp,uint8_t controllerId,bool storeResult);
+    void manageAutotuneModel();
 #endif
 };
 
@@ -334,6 +347,14 @@ extern TemperatureController heatedBedController;
 //extern Extruder *Extruder::current;
 extern TemperatureController *tempController[NUM_TEMPERATURE_LOOPS];
 extern uint8_t autotuneIndex;
+// Built-in thermistor tables, the host simulator writes their index for THERMISTOR_DENSE_INDEX
+extern const short * const temptables[12];
+extern const uint8_t temptables_num[12];
+extern uint8_t temptableFindRow(const short *temptable,uint8_t num,bool inFlash,int raw);
+extern float temptableRawToTemp(const short *temptable,uint8_t num,bool inFlash,int raw);
+#define THERMISTOR_INDEX_SHIFT 4
+#define THERMISTOR_INDEX_ENTRIES (4096 >> THERMISTOR_INDEX_SHIFT)
+extern float temptableIndexedRawToTemp(const short *temptable,const uint8_t *index,uint8_t num,int raw);
 
 
 #endif // EXTRUDER_H_INCLUDED
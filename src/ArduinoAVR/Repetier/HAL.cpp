@@ -1,6 +1,11 @@
 #include "Repetier.h"
 #include <compat/twi.h>
 
+// Without beeper M300 is not compiled in, so tone() does not take over timer 2
+#if !defined(BEEPER_PIN) || BEEPER_PIN<0
+#define HW_PWM_USE_TIMER_2 1
+#endif
+
 //extern "C" void __cxa_pure_virtual() { }
 
 HAL::HAL()
@@ -238,6 +243,84 @@ void HAL::setupTimer()
     TCCR1B =  (_BV(WGM12) | _BV(CS10)); // no prescaler == 0.0625 usec tick | 001 = clk/1
     OCR1A=65500; //start off with a slow frequency.
     TIMSK1 |= (1<<OCIE1A); // Enable interrupt
+#if HARDWARE_PWM
+    // Heater and fan outputs on free timer pins, the pwm interrupt only sets their duty cycle
+#if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1
+#if HW_PWM(EXT0_HEATER_PIN)
+    HW_PWM_START(EXT0_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1
+#if HW_PWM(EXT1_HEATER_PIN)
+    HW_PWM_START(EXT1_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2
+#if HW_PWM(EXT2_HEATER_PIN)
+    HW_PWM_START(EXT2_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3
+#if HW_PWM(EXT3_HEATER_PIN)
+    HW_PWM_START(EXT3_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4
+#if HW_PWM(EXT4_HEATER_PIN)
+    HW_PWM_START(EXT4_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5
+#if HW_PWM(EXT5_HEATER_PIN)
+    HW_PWM_START(EXT5_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if HEATED_BED_HEATER_PIN>-1 && HAVE_HEATED_BED
+#if HW_PWM(HEATED_BED_HEATER_PIN)
+    HW_PWM_START(HEATED_BED_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1 && EXT0_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT0_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT0_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1 && EXT1_EXTRUDER_COOLER_PIN>-1 && EXT1_EXTRUDER_COOLER_PIN!=EXT0_EXTRUDER_COOLER_PIN
+#if HW_PWM(EXT1_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT1_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2 && EXT2_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT2_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT2_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3 && EXT3_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT3_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT3_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4 && EXT4_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT4_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT4_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5 && EXT5_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT5_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT5_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if FAN_BOARD_PIN>-1
+#if HW_PWM(FAN_BOARD_PIN)
+    HW_PWM_START(FAN_BOARD_PIN,0);
+#endif
+#endif
+#if FAN_PIN>-1 && FEATURE_FAN_CONTROL
+#if HW_PWM(FAN_PIN)
+    HW_PWM_START(FAN_PIN,0);
+#endif
+#endif
+#endif
 #if FEATURE_SERVO
 #if SERVO0_PIN>-1
     SET_OUTPUT(SERVO0_PIN);
@@ -268,6 +351,87 @@ void HAL::setupTimer()
 #endif
 }
 
+void HAL::hardwarePwmOff()
+{
+#if HARDWARE_PWM
+#if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1
+#if HW_PWM(EXT0_HEATER_PIN)
+    HW_PWM_STOP(EXT0_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1
+#if HW_PWM(EXT1_HEATER_PIN)
+    HW_PWM_STOP(EXT1_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2
+#if HW_PWM(EXT2_HEATER_PIN)
+    HW_PWM_STOP(EXT2_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3
+#if HW_PWM(EXT3_HEATER_PIN)
+    HW_PWM_STOP(EXT3_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4
+#if HW_PWM(EXT4_HEATER_PIN)
+    HW_PWM_STOP(EXT4_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5
+#if HW_PWM(EXT5_HEATER_PIN)
+    HW_PWM_STOP(EXT5_HEATER_PIN);
+#endif
+#endif
+#if HEATED_BED_HEATER_PIN>-1 && HAVE_HEATED_BED
+#if HW_PWM(HEATED_BED_HEATER_PIN)
+    HW_PWM_STOP(HEATED_BED_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1 && EXT0_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT0_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT0_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1 && EXT1_EXTRUDER_COOLER_PIN>-1 && EXT1_EXTRUDER_COOLER_PIN!=EXT0_EXTRUDER_COOLER_PIN
+#if HW_PWM(EXT1_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT1_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2 && EXT2_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT2_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT2_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3 && EXT3_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT3_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT3_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4 && EXT4_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT4_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT4_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5 && EXT5_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT5_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT5_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if FAN_BOARD_PIN>-1
+#if HW_PWM(FAN_BOARD_PIN)
+    HW_PWM_STOP(FAN_BOARD_PIN);
+#endif
+#endif
+#if FAN_PIN>-1 && FEATURE_FAN_CONTROL
+#if HW_PWM(FAN_PIN)
+    HW_PWM_STOP(FAN_PIN);
+#endif
+#endif
+#endif
+}
+
 void HAL::showStartReason()
 {
     // Check startup - does nothing if bootloader sets MCUSR to 0
@@ -324,9 +488,42 @@ void HAL::analogStart()
         ADCSRB &= ~_BV(MUX5);
 #endif
     ADMUX = (ADMUX & ~(0x1F)) | (channel & 7);
+#if ANALOG_INTERRUPT_SAMPLING
+    // The timer 0 overflow starts the following conversions, 976 per second at 16 MHz.
+    // The millis interrupt clears its flag, so every overflow triggers a conversion.
+    ADCSRB = (ADCSRB & ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0))) | _BV(ADTS2);
+    ADCSRA |= _BV(ADIE) | _BV(ADATE) | _BV(ADSC);
+#else
     ADCSRA |= _BV(ADSC); // start conversion without interrupt!
 #endif
+#endif
+}
+
+#if ANALOG_INPUTS>0 && ANALOG_INTERRUPT_SAMPLING
+/** Adds the finished conversion, so the PWM timer no longer polls the ADC. The timer 0
+overflow triggers the conversions, which keeps this interrupt at a quarter of the PWM timer
+rate. A channel change here applies to the next conversion, because that starts with the
+next overflow. Interrupts stay enabled for the stepper. */
+ISR(ADC_vect, ISR_NOBLOCK)
+{
+    osAnalogInputBuildup[osAnalogInputPos] += ADCW;
+    if(++osAnalogInputCounter[osAnalogInputPos]>=_BV(ANALOG_INPUT_SAMPLE))
+    {
+        analogInputSample(osAnalogInputPos,osAnalogInputBuildup[osAnalogInputPos]);
+        osAnalogInputBuildup[osAnalogInputPos] = 0;
+        osAnalogInputCounter[osAnalogInputPos] = 0;
+        if(++osAnalogInputPos>=ANALOG_INPUTS) osAnalogInputPos = 0;
+        uint8_t channel = pgm_read_byte(&osAnalogInputChannels[osAnalogInputPos]);
+#if defined(ADCSRB) && defined(MUX5)
+        if(channel & 8)  // Reading channel 0-7 or 8-15?
+            ADCSRB |= _BV(MUX5);
+        else
+            ADCSRB &= ~_BV(MUX5);
+#endif
+        ADMUX = (ADMUX & ~(0x1F)) | (channel & 7);
+    }
 }
+#endif
 
 /*************************************************************************
 * Title:    I2C master library using hardware TWI interface
@@ -679,9 +876,27 @@ ISR(TIMER1_COMPA_vect)
     if(doExit) return;
     insideTimer1 = 1;
     OCR1A = 61000;
+#if STEP_TIMING_QUEUE
+    if(PrintLine::hasQueuedSteps())
+    {
+        setTimer(PrintLine::sendQueuedStep());
+    }
+    else
+#endif
     if(PrintLine::hasLines())
     {
-        setTimer(PrintLine::bresenhamStep());
+#if STEP_EVENT_RING
+        long delay = PrintLine::nextStepEvent();
+#else
+        long delay = PrintLine::bresenhamStep();
+#endif
+        // CTC mode, TCNT1 counts from the compare match and restarts at the OCR1A = 61000 set above.
+        // A compare flag set again means the interrupt ran past it.
+        uint16_t ticks = TCNT1;
+        if(TIFR1 & _BV(OCF1A))
+            ticks = (ticks < 65535 - 61000 ? ticks + 61000 : 65535);
+        PrintLine::recordStepTicks(ticks);
+        setTimer(delay);
     }
     else
     if(FEATURE_BABYSTEPPING && Printer::zBabystepsMissing) {
@@ -738,6 +953,9 @@ ISR(TIMER1_COMPA_vect)
 #define HEATER_PWM_STEP 4
 #define HEATER_PWM_MASK 252
 #endif
+/** Duty cycle of a heater on a hardware pwm output, with the same resolution as the software pwm.
+The largest value HEATER_PWM_MASK leaves the heater on all the time. */
+#define HEATER_HW_PWM(v) (((v) & HEATER_PWM_MASK) == HEATER_PWM_MASK ? 255 : ((v) & HEATER_PWM_MASK))
 
 /**
 This timer is called 3906 timer per second. It is used to update pwm values for heater and some other frequent jobs.
@@ -752,108 +970,198 @@ ISR(PWM_TIMER_VECTOR)
     if(pwm_count_heater == 0)
     {
 #if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1
+#if HW_PWM(EXT0_HEATER_PIN)
+        HW_PWM_WRITE(EXT0_HEATER_PIN,HEATER_HW_PWM(pwm_pos[0]));
+#else
         if((pwm_pos_set[0] = (pwm_pos[0] & HEATER_PWM_MASK))>0) WRITE(EXT0_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1
+#if HW_PWM(EXT1_HEATER_PIN)
+        HW_PWM_WRITE(EXT1_HEATER_PIN,HEATER_HW_PWM(pwm_pos[1]));
+#else
         if((pwm_pos_set[1] = (pwm_pos[1] & HEATER_PWM_MASK))>0) WRITE(EXT1_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2
+#if HW_PWM(EXT2_HEATER_PIN)
+        HW_PWM_WRITE(EXT2_HEATER_PIN,HEATER_HW_PWM(pwm_pos[2]));
+#else
         if((pwm_pos_set[2] = (pwm_pos[2] & HEATER_PWM_MASK))>0) WRITE(EXT2_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3
+#if HW_PWM(EXT3_HEATER_PIN)
+        HW_PWM_WRITE(EXT3_HEATER_PIN,HEATER_HW_PWM(pwm_pos[3]));
+#else
         if((pwm_pos_set[3] = (pwm_pos[3] & HEATER_PWM_MASK))>0) WRITE(EXT3_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4
+#if HW_PWM(EXT4_HEATER_PIN)
+        HW_PWM_WRITE(EXT4_HEATER_PIN,HEATER_HW_PWM(pwm_pos[4]));
+#else
         if((pwm_pos_set[4] = (pwm_pos[4] & HEATER_PWM_MASK))>0) WRITE(EXT4_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5
+#if HW_PWM(EXT5_HEATER_PIN)
+        HW_PWM_WRITE(EXT5_HEATER_PIN,HEATER_HW_PWM(pwm_pos[5]));
+#else
         if((pwm_pos_set[5] = (pwm_pos[5] & HEATER_PWM_MASK))>0) WRITE(EXT5_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if HEATED_BED_HEATER_PIN>-1 && HAVE_HEATED_BED
+#if HW_PWM(HEATED_BED_HEATER_PIN)
+        HW_PWM_WRITE(HEATED_BED_HEATER_PIN,pwm_pos[NUM_EXTRUDER]);
+#else
         if((pwm_pos_set[NUM_EXTRUDER] = pwm_pos[NUM_EXTRUDER])>0) WRITE(HEATED_BED_HEATER_PIN,!HEATER_PINS_INVERTED);
+#endif
 #endif
     }
     if(pwm_count==0)
     {
 #if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1 && EXT0_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT0_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT0_EXTRUDER_COOLER_PIN,extruder[0].coolerPWM);
+#else
         if((pwm_cooler_pos_set[0] = extruder[0].coolerPWM)>0) WRITE(EXT0_EXTRUDER_COOLER_PIN,1);
 #endif
+#endif
 #if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1
 #if EXT1_EXTRUDER_COOLER_PIN>-1 && EXT1_EXTRUDER_COOLER_PIN!=EXT0_EXTRUDER_COOLER_PIN
+#if HW_PWM(EXT1_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT1_EXTRUDER_COOLER_PIN,extruder[1].coolerPWM);
+#else
         if((pwm_cooler_pos_set[1] = extruder[1].coolerPWM)>0) WRITE(EXT1_EXTRUDER_COOLER_PIN,1);
 #endif
 #endif
+#endif
 #if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2
 #if EXT2_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT2_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT2_EXTRUDER_COOLER_PIN,extruder[2].coolerPWM);
+#else
         if((pwm_cooler_pos_set[2] = extruder[2].coolerPWM)>0) WRITE(EXT2_EXTRUDER_COOLER_PIN,1);
 #endif
 #endif
+#endif
 #if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3
 #if EXT3_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT3_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT3_EXTRUDER_COOLER_PIN,extruder[3].coolerPWM);
+#else
         if((pwm_cooler_pos_set[3] = extruder[3].coolerPWM)>0) WRITE(EXT3_EXTRUDER_COOLER_PIN,1);
 #endif
 #endif
+#endif
 #if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4
 #if EXT4_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT4_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT4_EXTRUDER_COOLER_PIN,extruder[4].coolerPWM);
+#else
         if((pwm_cooler_pos_set[4] = pwm_pos[4].coolerPWM)>0) WRITE(EXT4_EXTRUDER_COOLER_PIN,1);
 #endif
 #endif
+#endif
 #if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5
 #if EXT5_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT5_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT5_EXTRUDER_COOLER_PIN,extruder[5].coolerPWM);
+#else
         if((pwm_cooler_pos_set[5] = extruder[5].coolerPWM)>0) WRITE(EXT5_EXTRUDER_COOLER_PIN,1);
 #endif
 #endif
+#endif
 #if FAN_BOARD_PIN>-1
+#if HW_PWM(FAN_BOARD_PIN)
+        HW_PWM_WRITE(FAN_BOARD_PIN,pwm_pos[NUM_EXTRUDER+1]);
+#else
         if((pwm_pos_set[NUM_EXTRUDER+1] = pwm_pos[NUM_EXTRUDER+1])>0) WRITE(FAN_BOARD_PIN,1);
 #endif
+#endif
 #if FAN_PIN>-1 && FEATURE_FAN_CONTROL
+#if HW_PWM(FAN_PIN)
+        HW_PWM_WRITE(FAN_PIN,pwm_pos[NUM_EXTRUDER+2]);
+#else
         if((pwm_pos_set[NUM_EXTRUDER+2] = pwm_pos[NUM_EXTRUDER+2])>0) WRITE(FAN_PIN,1);
+#endif
 #endif
     }
 #if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1
+#if !HW_PWM(EXT0_HEATER_PIN)
     if(pwm_pos_set[0] == pwm_count_heater && pwm_pos_set[0]!=HEATER_PWM_MASK) WRITE(EXT0_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT0_EXTRUDER_COOLER_PIN>-1
+#if !HW_PWM(EXT0_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[0] == pwm_count && pwm_cooler_pos_set[0]!=255) WRITE(EXT0_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1
+#if !HW_PWM(EXT1_HEATER_PIN)
     if(pwm_pos_set[1] == pwm_count_heater && pwm_pos_set[1]!=HEATER_PWM_MASK) WRITE(EXT1_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT1_EXTRUDER_COOLER_PIN>-1 && EXT1_EXTRUDER_COOLER_PIN!=EXT0_EXTRUDER_COOLER_PIN
+#if !HW_PWM(EXT1_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[1] == pwm_count && pwm_cooler_pos_set[1]!=255) WRITE(EXT1_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2
+#if !HW_PWM(EXT2_HEATER_PIN)
     if(pwm_pos_set[2] == pwm_count_heater && pwm_pos_set[2]!=HEATER_PWM_MASK) WRITE(EXT2_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT2_EXTRUDER_COOLER_PIN>-1
+#if !HW_PWM(EXT2_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[2] == pwm_count && pwm_cooler_pos_set[2]!=255) WRITE(EXT2_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3
+#if !HW_PWM(EXT3_HEATER_PIN)
     if(pwm_pos_set[3] == pwm_count_heater && pwm_pos_set[3]!=HEATER_PWM_MASK) WRITE(EXT3_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT3_EXTRUDER_COOLER_PIN>-1
+#if !HW_PWM(EXT3_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[3] == pwm_count && pwm_cooler_pos_set[3]!=255) WRITE(EXT3_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4
+#if !HW_PWM(EXT4_HEATER_PIN)
     if(pwm_pos_set[4] == pwm_count_heater && pwm_pos_set[4]!=HEATER_PWM_MASK) WRITE(EXT4_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT4_EXTRUDER_COOLER_PIN>-1
+#if !HW_PWM(EXT4_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[4] == pwm_count && pwm_cooler_pos_set[4]!=255) WRITE(EXT4_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5
+#if !HW_PWM(EXT5_HEATER_PIN)
     if(pwm_pos_set[5] == pwm_count_heater && pwm_pos_set[5]!=HEATER_PWM_MASK) WRITE(EXT5_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT5_EXTRUDER_COOLER_PIN>-1
+#if !HW_PWM(EXT5_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[5] == pwm_count && pwm_cooler_pos_set[5]!=255) WRITE(EXT5_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if FAN_BOARD_PIN>-1
+#if !HW_PWM(FAN_BOARD_PIN)
     if(pwm_pos_set[NUM_EXTRUDER+1] == pwm_count && pwm_pos_set[NUM_EXTRUDER+1]!=255) WRITE(FAN_BOARD_PIN,0);
 #endif
+#endif
 #if FAN_PIN>-1 && FEATURE_FAN_CONTROL
+#if !HW_PWM(FAN_PIN)
     if(pwm_pos_set[NUM_EXTRUDER+2] == pwm_count && pwm_pos_set[NUM_EXTRUDER+2]!=255) WRITE(FAN_PIN,0);
 #endif
+#endif
 #if HEATED_BED_HEATER_PIN>-1 && HAVE_HEATED_BED
+#if !HW_PWM(HEATED_BED_HEATER_PIN)
     if(pwm_pos_set[NUM_EXTRUDER] == pwm_count_heater && pwm_pos_set[NUM_EXTRUDER]!=HEATER_PWM_MASK) WRITE(HEATED_BED_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #endif
     HAL::allowInterrupts();
     counterPeriodical++; // Appxoimate a 100ms timer
@@ -863,7 +1171,7 @@ ISR(PWM_TIMER_VECTOR)
         executePeriodical=1;
     }
 // read analog values
-#if ANALOG_INPUTS>0
+#if ANALOG_INPUTS>0 && !ANALOG_INTERRUPT_SAMPLING
     if((ADCSRA & _BV(ADSC))==0)   // Conversion finished?
     {
         osAnalogInputBuildup[osAnalogInputPos] += ADCW;
@@ -968,7 +1276,7 @@ ISR(EXTRUDER_TIMER_VECTOR)
   Modified to use only 1 queue with fixed length by Repetier
 */
 
-ring_buffer rx_buffer = { { 0 }, 0, 0};
+ring_buffer rx_buffer = { { 0 }, 0, 0, 0, 0};
 ring_buffer_tx tx_buffer = { { 0 }, 0, 0};
 
 inline void rf_store_char(unsigned char c, ring_buffer *buffer)
@@ -983,7 +1291,11 @@ inline void rf_store_char(unsigned char c, ring_buffer *buffer)
     {
         buffer->buffer[buffer->head] = c;
         buffer->head = i;
+        uint8_t used = (uint8_t)(i - buffer->tail) & SERIAL_BUFFER_MASK;
+        if(used > buffer->highWater) buffer->highWater = used;
     }
+    else
+        buffer->overflows++;
 }
 #if !defined(USART0_RX_vect) && defined(USART1_RX_vect)
 // do nothing - on the 32u4 the first USART is USART1
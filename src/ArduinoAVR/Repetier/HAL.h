@@ -141,8 +141,11 @@ typedef uint8_t flag8_t;
   Modified to use only 1 queue with fixed length by Repetier
 */
 
-#define SERIAL_BUFFER_SIZE 128
-#define SERIAL_BUFFER_MASK 127
+#if (SERIAL_RX_BUFFER_SIZE & (SERIAL_RX_BUFFER_SIZE - 1)) || SERIAL_RX_BUFFER_SIZE < 32 || SERIAL_RX_BUFFER_SIZE > 256
+#error SERIAL_RX_BUFFER_SIZE must be a power of 2 between 32 and 256
+#endif
+#define SERIAL_BUFFER_SIZE SERIAL_RX_BUFFER_SIZE
+#define SERIAL_BUFFER_MASK (SERIAL_RX_BUFFER_SIZE - 1)
 #define SERIAL_TX_BUFFER_SIZE 64
 #define SERIAL_TX_BUFFER_MASK 63
 
@@ -151,6 +154,8 @@ struct ring_buffer
     unsigned char buffer[SERIAL_BUFFER_SIZE];
     volatile uint8_t head;
     volatile uint8_t tail;
+    uint8_t highWater; ///< Highest number of bytes waiting since the last reset.
+    uint16_t overflows; ///< Received bytes lost because the buffer was full.
 };
 struct ring_buffer_tx
 {
@@ -197,6 +202,9 @@ public:
 };
 extern RFHardwareSerial RFSerial;
 #define RFSERIAL RFSerial
+/** The receive ring can be read in place, see SERIAL_RX_ZERO_COPY. */
+#define SERIAL_RX_RING
+#define SERIAL_RX_BUFFER_MASK SERIAL_BUFFER_MASK
 //extern ring_buffer tx_buffer;
 #define WAIT_OUT_EMPTY while(tx_buffer.head != tx_buffer.tail) {}
 #else
@@ -543,6 +551,47 @@ public:
     {
         RFSERIAL.flush();
     }
+#ifdef SERIAL_RX_RING
+    /** \brief Start of the receive ring. Bytes from serialRxTail() on are received but not consumed. */
+    static inline uint8_t *serialRxData()
+    {
+        return RFSERIAL._rx_buffer->buffer;
+    }
+    static inline uint16_t serialRxTail()
+    {
+        return RFSERIAL._rx_buffer->tail;
+    }
+    /** \brief Number of received bytes starting at serialRxTail(). */
+    static inline uint16_t serialRxAvailable()
+    {
+        return (uint8_t)(RFSERIAL._rx_buffer->head - RFSERIAL._rx_buffer->tail) & SERIAL_RX_BUFFER_MASK;
+    }
+    /** \brief Frees n bytes at the tail. Their content must not be used afterwards. */
+    static inline void serialRxConsume(uint16_t n)
+    {
+        __asm volatile("" ::: "memory"); // all reads of the freed bytes must be done before
+        RFSERIAL._rx_buffer->tail = (RFSERIAL._rx_buffer->tail + n) & SERIAL_RX_BUFFER_MASK;
+    }
+    static inline uint32_t serialRxOverflows()
+    {
+        uint16_t n;
+        BEGIN_INTERRUPT_PROTECTED
+        n = RFSERIAL._rx_buffer->overflows;
+        END_INTERRUPT_PROTECTED
+        return n;
+    }
+    static inline uint16_t serialRxHighWater()
+    {
+        return RFSERIAL._rx_buffer->highWater;
+    }
+    static inline void serialRxResetStatistics()
+    {
+        BEGIN_INTERRUPT_PROTECTED
+        RFSERIAL._rx_buffer->overflows = 0;
+        RFSERIAL._rx_buffer->highWater = 0;
+        END_INTERRUPT_PROTECTED
+    }
+#endif
     static void setupTimer();
     static void showStartReason();
     static int getFreeRam();
@@ -674,6 +723,8 @@ public:
     static void servoMicroseconds(uint8_t servo,int ms);
 #endif
     static void analogStart();
+    /** \brief Switches the hardware pwm outputs off for an emergency stop. */
+    static void hardwarePwmOff();
 protected:
 private:
 };
@@ -703,4 +754,81 @@ private:
 #define PWM_TIMSK TIMSK0
 #define PWM_OCIE OCIE0B
 //#endif
+
+/** \brief Hardware pwm outputs of the pins.
+
+HW_PWM_PIN_<pin> is the timer whose output compare unit HW_PWM_CHANNEL_<pin> drives the pin.
+Timer 0 (pwm and extruder interrupt) and timer 1 (steppers) are not listed, timer 2 is
+used by tone() for the beeper and timer 3 by the servos. HW_PWM_USE_TIMER_2 is set in HAL.cpp,
+the beeper pin of the controller is only known after ui.h.
+*/
+#if defined (__AVR_ATmega1280__) || defined (__AVR_ATmega2560__)
+#define HW_PWM_PIN_2 3
+#define HW_PWM_CHANNEL_2 B
+#define HW_PWM_PIN_3 3
+#define HW_PWM_CHANNEL_3 C
+#define HW_PWM_PIN_5 3
+#define HW_PWM_CHANNEL_5 A
+#define HW_PWM_PIN_6 4
+#define HW_PWM_CHANNEL_6 A
+#define HW_PWM_PIN_7 4
+#define HW_PWM_CHANNEL_7 B
+#define HW_PWM_PIN_8 4
+#define HW_PWM_CHANNEL_8 C
+#define HW_PWM_PIN_9 2
+#define HW_PWM_CHANNEL_9 B
+#define HW_PWM_PIN_10 2
+#define HW_PWM_CHANNEL_10 A
+#define HW_PWM_PIN_44 5
+#define HW_PWM_CHANNEL_44 C
+#define HW_PWM_PIN_45 5
+#define HW_PWM_CHANNEL_45 B
+#define HW_PWM_PIN_46 5
+#define HW_PWM_CHANNEL_46 A
+#define HW_PWM_USE_TIMER_4 1
+#define HW_PWM_USE_TIMER_5 1
+#elif defined (__AVR_ATmega644__) || defined (__AVR_ATmega644P__) || defined (__AVR_ATmega644PA__) || defined (__AVR_ATmega1284P__)
+#define HW_PWM_PIN_14 2
+#define HW_PWM_CHANNEL_14 B
+#define HW_PWM_PIN_15 2
+#define HW_PWM_CHANNEL_15 A
+#endif
+#if !FEATURE_SERVO
+#define HW_PWM_USE_TIMER_3 1
+#endif
+// Clock select of the timers, 8 bit phase correct pwm at F_CPU/510/prescaler
+#if HEATER_PWM_SPEED<2
+#define HW_PWM_CLOCK_2 (_BV(CS22) | _BV(CS21) | _BV(CS20)) // prescaler 1024 = 30.6 Hz
+#define HW_PWM_CLOCK_16 (_BV(CS32) | _BV(CS30)) // same bits for timer 3, 4 and 5
+#else
+#define HW_PWM_CLOCK_2 (_BV(CS22) | _BV(CS21)) // prescaler 256 = 122.5 Hz
+#define HW_PWM_CLOCK_16 _BV(CS32)
+#endif
+#define HW_PWM_CLOCK_3 HW_PWM_CLOCK_16
+#define HW_PWM_CLOCK_4 HW_PWM_CLOCK_16
+#define HW_PWM_CLOCK_5 HW_PWM_CLOCK_16
+
+#define _HW_PWM_TIMER(IO) HW_PWM_PIN_ ## IO
+#define HW_PWM_TIMER(IO) _HW_PWM_TIMER(IO)
+#define _HW_PWM_CHANNEL(IO) HW_PWM_CHANNEL_ ## IO
+#define HW_PWM_CHANNEL(IO) _HW_PWM_CHANNEL(IO)
+#define _HW_PWM_USE(t) HW_PWM_USE_TIMER_ ## t
+#define HW_PWM_USE(t) _HW_PWM_USE(t)
+/// True if HARDWARE_PWM is enabled and the pin has a free timer output. Use it in #if only.
+#define HW_PWM(IO) (HARDWARE_PWM && HW_PWM_USE(HW_PWM_TIMER(IO)))
+#define __HW_PWM_OCR(t,c) OCR ## t ## c
+#define _HW_PWM_OCR(t,c) __HW_PWM_OCR(t,c)
+/// Output compare register setting the duty cycle of pin IO
+#define HW_PWM_OCR(IO) _HW_PWM_OCR(HW_PWM_TIMER(IO),HW_PWM_CHANNEL(IO))
+/// Sets the duty cycle 0-255 of pin IO, it starts with the next pwm period
+#define HW_PWM_WRITE(IO,v) HW_PWM_OCR(IO) = (v)
+#define __HW_PWM_START(t,c,inverted) do {TCCR ## t ## A = (TCCR ## t ## A & ~_BV(WGM ## t ## 1)) | _BV(WGM ## t ## 0) | \
+    _BV(COM ## t ## c ## 1) | ((inverted) ? _BV(COM ## t ## c ## 0) : 0); TCCR ## t ## B = HW_PWM_CLOCK_ ## t; OCR ## t ## c = 0;} while(0)
+#define _HW_PWM_START(t,c,inverted) __HW_PWM_START(t,c,inverted)
+/// Connects pin IO to its compare unit with duty cycle 0. inverted outputs are high while off.
+#define HW_PWM_START(IO,inverted) _HW_PWM_START(HW_PWM_TIMER(IO),HW_PWM_CHANNEL(IO),inverted)
+#define __HW_PWM_STOP(t,c) TCCR ## t ## A &= ~(_BV(COM ## t ## c ## 1) | _BV(COM ## t ## c ## 0))
+#define _HW_PWM_STOP(t,c) __HW_PWM_STOP(t,c)
+/// Disconnects pin IO from the timer, WRITE sets the pin again.
+#define HW_PWM_STOP(IO) _HW_PWM_STOP(HW_PWM_TIMER(IO),HW_PWM_CHANNEL(IO))
 #endif // HAL_H
@@ -64,6 +64,9 @@ public:
     static float maxTravelAccelerationMMPerSquareSecond[];
     static unsigned long maxPrintAccelerationStepsPerSquareSecond[];
     static unsigned long maxTravelAccelerationStepsPerSquareSecond[];
+#if FIXED_POINT_PLANNER
+    static uint16_t maxFeedrateInterval[]; ///< Shortest step interval in ticks allowed by maxFeedrate, used by the integer planner. 0 if it exceeds 16 bit.
+#endif
     static uint8_t relativeCoordinateMode;    ///< Determines absolute (false) or relative Coordinates (true).
     static uint8_t relativeExtruderCoordinateMode;  ///< Determines Absolute or Relative E Codes while in Absolute Coordinates mode. E is always relative in Relative Coordinates mode.
 
@@ -617,6 +620,13 @@ public:
     }
     static void constrainDestinationCoords();
     static void updateDerivedParameter();
+#if FIXED_POINT_PLANNER
+    static inline void updateMaxFeedrateInterval(uint8_t axis)
+    {
+        float interval = (float)F_CPU / (axisStepsPerMM[axis] * maxFeedrate[axis]) + 0.5f;
+        maxFeedrateInterval[axis] = (interval < 65535.0f ? (uint16_t)interval : 0); // 0 = too slow for 16 bit, use the float path
+    }
+#endif
     static void updateCurrentPosition(bool copyLastCmd = false);
     static void kill(uint8_t only_steppers);
     static void updateAdvanceFlags();
@@ -35,6 +35,17 @@ SDCard::SDCard()
     sdactive = false;
     savetosd = false;
     Printer::setAutomount(false);
+#if MOTION_STREAM
+    motionStream = false;
+#endif
+#if SD_DIR_INDEX
+    dirIndexValid = false;
+    restartDirIndex();
+#endif
+#if SD_READ_AHEAD
+    readAheadUnderruns = readAheadBlocks = readAheadStreams = 0;
+    resetReadAhead();
+#endif
 }
 
 void SDCard::automount()
@@ -88,6 +99,10 @@ void SDCard::initsd()
     }
     sdactive = true;
     Printer::setMenuMode(MENU_MODE_SD_MOUNTED,true);
+#if SD_DIR_INDEX
+    dirIndexValid = false; // index of the previous card
+    restartDirIndex();
+#endif
 
     fat.chdir();
     if(selectFile("init.g",true))
@@ -110,6 +125,10 @@ void SDCard::unmount()
     savetosd = false;
     Printer::setAutomount(false);
     Printer::setMenuMode(MENU_MODE_SD_MOUNTED+MENU_MODE_SD_PAUSED+MENU_MODE_SD_PRINTING,false);
+#if SD_DIR_INDEX
+    dirIndexValid = false;
+    restartDirIndex();
+#endif
 #if UI_DISPLAY_TYPE!=0 && SDSUPPORT
     uid.cwd[0]='/';
     uid.cwd[1]=0;
@@ -162,127 +181,79 @@ void SDCard::stopPrint()
     Com::printFLN(PSTR("SD print stopped by user."));
 }
 
-void SDCard::writeCommand(GCode *code)
+/** Continues reading the selected file at newpos (M26). Motion streams can only continue
+at the start of a record, position 0 means their first record. */
+void SDCard::setIndex(uint32_t newpos)
 {
-    unsigned int sum1=0,sum2=0; // for fletcher-16 checksum
-    uint8_t buf[100];
-    uint8_t p=2;
-    file.writeError = false;
-    int params = 128 | (code->params & ~1);
-    *(int*)buf = params;
-    if(code->isV2())   // Read G,M as 16 bit value
-    {
-        *(int*)&buf[p] = code->params2;
-        p+=2;
-        if(code->hasString())
-            buf[p++] = strlen(code->text);
-        if(code->hasM())
-        {
-            *(int*)&buf[p] = code->M;
-            p+=2;
-        }
-        if(code->hasG())
-        {
-            *(int*)&buf[p]= code->G;
-            p+=2;
-        }
-    }
-    else
+    if(!sdactive) return;
+#if MOTION_STREAM
+    if(motionStream)
     {
-        if(code->hasM())
+        if(newpos == 0)
+            newpos = sizeof(MotionStreamHeader);
+        else if(newpos < sizeof(MotionStreamHeader) || (newpos - sizeof(MotionStreamHeader)) % sizeof(MotionRecord))
         {
-            buf[p++] = (uint8_t)code->M;
+            Com::printErrorFLN(PSTR("Position is no motion stream record"));
+            return;
         }
-        if(code->hasG())
-        {
-            buf[p++] = (uint8_t)code->G;
-        }
-    }
-    if(code->hasX())
-    {
-        *(float*)&buf[p] = code->X;
-        p+=4;
-    }
-    if(code->hasY())
-    {
-        *(float*)&buf[p] = code->Y;
-        p+=4;
     }
-    if(code->hasZ())
-    {
-        *(float*)&buf[p] = code->Z;
-        p+=4;
-    }
-    if(code->hasE())
-    {
-        *(float*)&buf[p] = code->E;
-        p+=4;
-    }
-    if(code->hasF())
-    {
-        *(float*)&buf[p] = code->F;
-        p+=4;
-    }
-    if(code->hasT())
-    {
-        buf[p++] = code->T;
-    }
-    if(code->hasS())
-    {
-        *(long int*)&buf[p] = code->S;
-        p+=4;
-    }
-    if(code->hasP())
-    {
-        *(long int*)&buf[p] = code->P;
-        p+=4;
-    }
-    if(code->hasI())
-    {
-        *(float*)&buf[p] = code->I;
-        p+=4;
-    }
-    if(code->hasJ())
-    {
-        *(float*)&buf[p] = code->J;
-        p+=4;
-    }
-    if(code->hasString())   // read 16 uint8_t into string
+#endif
+    sdpos = newpos;
+    file.seekSet(sdpos);
+#if SD_READ_AHEAD
+    resetReadAhead();
+#endif
+}
+
+#if SD_BUFFERED_UPLOAD
+/** Writes the gathered upload bytes. Whole buffers are written with one
+multiple block write, because they start at a block boundary. Clusters are
+allocated SD_BUFFERED_UPLOAD at a time, so the FAT block is not rewritten for
+every cluster and the file stays contiguous. */
+void SDCard::flushUpload()
+{
+    uint32_t pos = file.curPosition();
+    if(pos + uploadPos > uploadAllocated)
     {
-        char *sp = code->text;
-        if(code->isV2())
-        {
-            uint8_t i = strlen(code->text);
-            for(; i; i--) buf[p++] = *sp++;
-        }
+        uint32_t clusterBytes = (uint32_t)fat.vol()->blocksPerCluster() << 9;
+        if(file.preAllocate(SD_BUFFERED_UPLOAD))
+            uploadAllocated = ((pos + clusterBytes - 1) / clusterBytes + SD_BUFFERED_UPLOAD) * clusterBytes;
         else
-        {
-            for(uint8_t i=0; i<16; ++i) buf[p++] = *sp++;
-        }
-    }
-    uint8_t *ptr = buf;
-    uint8_t len = p;
-    while (len)
-    {
-        uint8_t tlen = len > 21 ? 21 : len;
-        len -= tlen;
-        do
-        {
-            sum1 += *ptr++;
-            if(sum1>=255) sum1-=255;
-            sum2 += sum1;
-            if(sum2>=255) sum2-=255;
-        }
-        while (--tlen);
+            uploadAllocated = 0xFFFFFFFF; // no contiguous space, write allocates single clusters
     }
-    buf[p++] = sum1;
-    buf[p++] = sum2;
-    if(params == 128)
+    file.write(readAheadBuffer[0],uploadPos);
+    uploadPos = 0;
+}
+#endif
+
+void SDCard::writeCommand(GCode *code)
+{
+    uint8_t buf[100];
+    file.writeError = false;
+    uint8_t p = code->writeBinary(buf);
+    if(p == 0)
     {
         Com::printErrorFLN(Com::tAPIDFinished);
     }
     else
+    {
+#if SD_BUFFERED_UPLOAD
+        // The read ahead buffers are free while uploading
+        uint8_t *upload = readAheadBuffer[0];
+        uint16_t n = sizeof(readAheadBuffer) - uploadPos;
+        if(n > p) n = p;
+        memcpy(upload + uploadPos,buf,n);
+        uploadPos += n;
+        if(uploadPos == sizeof(readAheadBuffer))
+        {
+            flushUpload();
+            memcpy(upload,buf + n,p - n);
+            uploadPos = p - n;
+        }
+#else
         file.write(buf,p);
+#endif
+    }
     if (file.writeError)
     {
         Com::printFLN(Com::tErrorWritingToFile);
@@ -366,6 +337,19 @@ bool SDCard::selectFile(char *filename, bool silent)
         }
         sdpos = 0;
         filesize = file.fileSize();
+#if SD_EXTENT_CACHE
+        file.buildExtents(&extents);
+#endif
+#if MOTION_STREAM
+        if(!checkMotionStream())
+        {
+            file.close();
+            return false;
+        }
+#endif
+#if SD_READ_AHEAD
+        resetReadAhead();
+#endif
         Com::printFLN(Com::tFileSelected);
         return true;
     }
@@ -377,6 +361,322 @@ bool SDCard::selectFile(char *filename, bool silent)
     }
 }
 
+#if SD_READ_AHEAD
+/** Drops the buffered blocks. The next readByte starts reading at sdpos. */
+void SDCard::resetReadAhead()
+{
+    readAheadPos = sdpos & ~(uint32_t)511;
+    readAheadFirst = readAheadCount = 0;
+    streamLeft = 0;
+    readAheadStarted = false;
+}
+
+/** Reads the next block of the file into a free buffer. */
+bool SDCard::readAheadBlock()
+{
+    uint32_t pos = readAheadPos + ((uint32_t)readAheadCount << 9);
+    if(readAheadCount >= SD_READ_AHEAD || pos >= filesize) return false;
+    if(streamLeft == 0)
+    {
+        // Runs are limited so a fragmented FAT is not searched at once
+        streamLeft = 64;
+        if(!file.contiguousBlocks(pos, &streamBlock, &streamLeft))
+        {
+            streamLeft = 0;
+            return false;
+        }
+    }
+    if(fat.card()->streamBlock() != streamBlock)
+        readAheadStreams++;
+    uint8_t idx = readAheadFirst + readAheadCount;
+    if(idx >= SD_READ_AHEAD) idx -= SD_READ_AHEAD;
+    if(!file.readStreamBlock(streamBlock, readAheadBuffer[idx]))
+    {
+        streamLeft = 0;
+        return false;
+    }
+    streamBlock++;
+    streamLeft--;
+    readAheadCount++;
+    readAheadBlocks++;
+    return true;
+}
+
+/** Called between commands. Reads at most one block so the other periodical
+actions are not delayed by more than one block transfer. */
+void SDCard::fillReadAhead()
+{
+    if(sdmode)
+        readAheadBlock();
+}
+
+/** Called by readByte if no block is buffered. */
+bool SDCard::waitReadAhead()
+{
+    if(readAheadStarted) readAheadUnderruns++;
+    readAheadStarted = true;
+    return readAheadBlock();
+}
+#endif
+
+#if MOTION_STREAM
+/** Reads size bytes at sdpos and advances sdpos. */
+bool SDCard::readMotionData(uint8_t *buf,uint8_t size)
+{
+    if(sdpos + size > filesize) return false;
+#if SD_READ_AHEAD
+    for(uint8_t i = 0; i < size; i++)
+    {
+        int n = readByte();
+        if(n < 0) return false;
+        buf[i] = n;
+        sdpos++;
+    }
+#else
+    if(file.read(buf,size) != size) return false;
+    sdpos += size;
+#endif
+    return true;
+}
+
+/** The moves of a motion stream are printer steps, autolevel and tool offsets can not be applied to them. */
+static bool motionStreamTransformed()
+{
+    if(!Printer::isAutolevelActive() && Printer::offsetX == 0 && Printer::offsetY == 0) return false;
+    Com::printErrorFLN(PSTR("Motion streams can not be printed with autolevel or tool offsets"));
+    return true;
+}
+
+/** Sets motionStream for the file just opened and skips the header.
+Returns false for motion streams converted for another printer or while autolevel or a tool offset is active. */
+bool SDCard::checkMotionStream()
+{
+    MotionStreamHeader header;
+    motionStream = false;
+    if(filesize < sizeof(header) || file.read(&header,sizeof(header)) != sizeof(header) ||
+            header.magic != MOTION_STREAM_MAGIC)
+    {
+        file.seekSet(0);
+        return true;
+    }
+    bool ok = header.recordSize == sizeof(MotionRecord) && header.driveSystem == DRIVE_SYSTEM;
+    for(uint8_t i = 0; i < 4; i++)
+        if(fabs(header.axisStepsPerMM[i] - Printer::axisStepsPerMM[i]) > 0.001f * Printer::axisStepsPerMM[i])
+            ok = false;
+    if(!ok)
+    {
+        Com::printErrorFLN(PSTR("Motion stream was converted for other steps per mm or drive system"));
+        return false;
+    }
+    if(motionStreamTransformed()) return false;
+    motionStream = true;
+    sdpos = sizeof(header);
+    return true;
+}
+
+/** Executes a command record, data holds all its records. */
+void SDCard::executeMotionCommand(uint8_t *data)
+{
+    GCode code;
+    uint8_t oldSize = GCode::binaryCommandSize;
+    GCode::binaryCommandSize = data[1];
+    bool ok = code.parseBinary(data + 2,false);
+    GCode::binaryCommandSize = oldSize;
+    if(!ok)
+    {
+        Com::printErrorFLN(Com::tSDReadError);
+        return;
+    }
+    Printer::updateCurrentPosition(true); // moves of the stream only updated the steps
+    Commands::executeGCode(&code);
+}
+
+/** Queues the moves of a motion stream until the path planner is full. Called
+from the command loop instead of reading G-code lines from the file. */
+void SDCard::feedMotionStream()
+{
+    union
+    {
+        MotionRecord record;
+        uint8_t data[MOTION_COMMAND_RECORDS * sizeof(MotionRecord)];
+    } buf;
+    while(sdmode && PrintLine::queuedLines() < MOVE_CACHE_SIZE)
+    {
+        if(sdpos >= filesize)
+        {
+            sdmode = false;
+            Printer::updateCurrentPosition(true);
+            Com::printFLN(Com::tDonePrinting);
+            Printer::setMenuMode(MENU_MODE_SD_PRINTING,false);
+            return;
+        }
+        if(!readMotionData(buf.data,sizeof(MotionRecord)))
+        {
+            Com::printErrorFLN(Com::tSDReadError);
+            sdmode = false;
+            return;
+        }
+        MotionRecord &r = buf.record;
+        if(r.type == MOTION_RECORD_MOVE)
+        {
+            Printer::destinationSteps[X_AXIS] = r.steps[X_AXIS];
+            Printer::destinationSteps[Y_AXIS] = r.steps[Y_AXIS];
+            Printer::destinationSteps[Z_AXIS] = r.steps[Z_AXIS];
+            long e = r.steps[E_AXIS];
+            if(Printer::debugDryrun()
+#if MIN_EXTRUDER_TEMP > 30
+                    || Extruder::current->tempControl.currentTemperatureC < MIN_EXTRUDER_TEMP
+#endif
+                    || labs(e) > EXTRUDE_MAXLENGTH * Printer::axisStepsPerMM[E_AXIS]
+              )
+                e = 0;
+            Printer::destinationSteps[E_AXIS] = Printer::currentPositionSteps[E_AXIS] + e;
+            Printer::feedrate = r.feedrate * (float)Printer::feedrateMultiply * 0.01f;
+#if NONLINEAR_SYSTEM
+            PrintLine::queueDeltaMove(r.flags & MOTION_FLAG_CHECK_ENDSTOPS,r.flags & MOTION_FLAG_PATH_OPTIMIZE,
+                                      r.flags & MOTION_FLAG_SOFT_ENDSTOP);
+#else
+            PrintLine::queueCartesianMove(r.flags & MOTION_FLAG_CHECK_ENDSTOPS,r.flags & MOTION_FLAG_PATH_OPTIMIZE);
+#endif
+        }
+        else if(r.type == MOTION_RECORD_COMMAND && r.flags + 2 <= sizeof(buf.data))
+        {
+            uint8_t size = (r.flags + 2 + sizeof(MotionRecord) - 1) / sizeof(MotionRecord) * sizeof(MotionRecord);
+            if(size > sizeof(MotionRecord) &&
+                    !readMotionData(buf.data + sizeof(MotionRecord),size - sizeof(MotionRecord)))
+            {
+                Com::printErrorFLN(Com::tSDReadError);
+                sdmode = false;
+                return;
+            }
+            executeMotionCommand(buf.data);
+            if(motionStreamTransformed()) // e.g. G29 or a tool change of the stream
+            {
+                sdmode = false;
+                return;
+            }
+        }
+        else
+        {
+            Com::printErrorFLN(PSTR("Unknown motion stream record"));
+            sdmode = false;
+            return;
+        }
+    }
+}
+#endif
+
+#if SD_DIR_INDEX
+/** Hash of a long filename, directories get a different one than files of the same name. */
+static uint16_t dirNameHash(const char *name,bool subdir)
+{
+    uint16_t hash = subdir ? 0x5555 : 5381;
+    while(*name)
+        hash = (hash << 5) + hash + (uint8_t)*name++;
+    return hash;
+}
+
+/** Indexes the working directory for the file browser. An index of the same
+directory is kept, so it is only built again after a directory change. */
+void SDCard::startDirIndex(bool listDirs)
+{
+    SdBaseFile *dir = fat.vwd();
+    if(dirIndexValid && dirIndexListDirs == listDirs && dirIndexDir.firstCluster() == dir->firstCluster())
+        return;
+    dirIndexDir = *dir;
+    dirIndexListDirs = listDirs;
+    dirIndexValid = true;
+    restartDirIndex();
+}
+
+/** Builds the index again, e.g. after files were added. */
+void SDCard::restartDirIndex()
+{
+    dirIndexFiles = 0;
+    dirIndexNext = 0;
+    dirIndexComplete = !dirIndexValid;
+}
+
+/** Adds the next file of the directory to the index. Called from
+checkForPeriodicalActions, so building the index does not block the
+command loop. Returns false when the index is complete. */
+bool SDCard::fillDirIndex()
+{
+    if(dirIndexComplete || savetosd) return false;
+    dir_t *p;
+    dirIndexDir.seekSet((uint32_t)dirIndexNext << 5);
+    if(dirIndexFiles == 254 || (p = dirIndexDir.getLongFilename(NULL, tempLongFilename, 0, NULL)) == NULL)
+    {
+        dirIndexComplete = true;
+        return false;
+    }
+    uint16_t start = dirIndexNext;
+    dirIndexNext = dirIndexDir.curPosition() >> 5;
+    if(!dirIndexListDirs && DIR_IS_SUBDIR(p) && !(p->name[0]=='.' && p->name[1]=='.'))
+        return true;
+    if(dirIndexFiles < SD_DIR_INDEX)
+    {
+        dirIndexEntry[dirIndexFiles] = start;
+        dirIndexHash[dirIndexFiles] = dirNameHash(tempLongFilename, DIR_IS_SUBDIR(p));
+    }
+    dirIndexFiles++;
+    return true;
+}
+
+/** Copies the name of the n-th listed file to name, directories end with '/'.
+Files past SD_DIR_INDEX are found by scanning from the last indexed one.
+Returns false if the file is not indexed yet or the directory changed since,
+in that case the index is built again. */
+bool SDCard::getDirIndexName(uint8_t n,char *name)
+{
+    if(!dirIndexValid || n >= dirIndexFiles) return false;
+    uint8_t i = (n < SD_DIR_INDEX ? n : SD_DIR_INDEX - 1);
+    uint8_t skip = n - i;
+    bool first = true;
+    dir_t *p;
+    dirIndexDir.seekSet((uint32_t)dirIndexEntry[i] << 5);
+    while((p = dirIndexDir.getLongFilename(NULL, tempLongFilename, 0, NULL)) != NULL)
+    {
+        if(!dirIndexListDirs && DIR_IS_SUBDIR(p) && !(p->name[0]=='.' && p->name[1]=='.'))
+            continue;
+        if(first && dirNameHash(tempLongFilename, DIR_IS_SUBDIR(p)) != dirIndexHash[i])
+            break;
+        first = false;
+        if(skip)
+        {
+            skip--;
+            continue;
+        }
+        strcpy(name, tempLongFilename);
+        if(DIR_IS_SUBDIR(p)) strcat(name, "/"); // Set marker for directory
+        return true;
+    }
+    restartDirIndex();
+    return false;
+}
+
+/** Removes the n-th file after it was deleted. The following files keep
+their start entries, the scan skips the deleted entries in front of them. */
+void SDCard::removeDirIndex(uint8_t n)
+{
+    if(!dirIndexValid || n >= dirIndexFiles) return;
+    if(n < SD_DIR_INDEX)
+    {
+        if(dirIndexFiles > SD_DIR_INDEX) // the file moving into the last slot is not known
+        {
+            restartDirIndex();
+            return;
+        }
+        for(; n + 1 < dirIndexFiles; n++)
+        {
+            dirIndexEntry[n] = dirIndexEntry[n + 1];
+            dirIndexHash[n] = dirIndexHash[n + 1];
+        }
+    }
+    dirIndexFiles--;
+}
+#endif
+
 void SDCard::printStatus()
 {
     if(sdactive)
@@ -394,6 +694,12 @@ void SDCard::startWrite(char *filename)
     if(!sdactive) return;
     file.close();
     sdmode = false;
+#if MOTION_STREAM
+    motionStream = false;
+#endif
+#if SD_READ_AHEAD
+    resetReadAhead();
+#endif
     fat.chdir();
     if(!file.open(filename, O_CREAT | O_APPEND | O_WRITE | O_TRUNC))
     {
@@ -403,16 +709,39 @@ void SDCard::startWrite(char *filename)
     {
         UI_STATUS(UI_TEXT_UPLOADING);
         savetosd = true;
+        uploadStart = HAL::timeInMilliseconds();
+#if SD_BUFFERED_UPLOAD
+        uploadPos = 0;
+        uploadAllocated = 0;
+#endif
         Com::printFLN(Com::tWritingToFile,filename);
     }
 }
 void SDCard::finishWrite()
 {
     if(!savetosd) return; // already closed or never opened
+    file.writeError = false;
+#if SD_BUFFERED_UPLOAD
+    if(uploadPos)
+        flushUpload(); // the last partial block goes through the cache
+    if(uploadAllocated && uploadAllocated != 0xFFFFFFFF)
+        file.truncate(file.fileSize()); // free the clusters allocated in advance
+#endif
     file.sync();
+    if (file.writeError)
+        Com::printFLN(Com::tErrorWritingToFile);
+    uint32_t size = file.fileSize();
     file.close();
     savetosd = false;
+#if SD_DIR_INDEX
+    restartDirIndex(); // the new file may use a free entry in the middle of the directory
+#endif
     Com::printFLN(Com::tDoneSavingFile);
+    millis_t time = HAL::timeInMilliseconds() - uploadStart;
+    Com::printF(PSTR("Upload bytes:"),size);
+    Com::printF(PSTR(" ms:"),(uint32_t)time);
+    Com::printF(PSTR(" KB/s:"),time ? (float)size / (float)time * 0.9765625f : 0.0f,1); // bytes/ms * 1000/1024
+    Com::println();
     UI_CLEAR_STATUS;
 }
 void SDCard::deleteFile(char *filename)
@@ -431,6 +760,9 @@ void SDCard::deleteFile(char *filename)
         else
             Com::printFLN(Com::tDeletionFailed);
     }
+#if SD_DIR_INDEX
+    restartDirIndex();
+#endif
 }
 void SDCard::makeDirectory(char *filename)
 {
@@ -440,6 +772,9 @@ void SDCard::makeDirectory(char *filename)
     if(fat.mkdir(filename))
     {
         Com::printFLN(Com::tDirectoryCreated);
+#if SD_DIR_INDEX
+        restartDirIndex();
+#endif
     }
     else
     {
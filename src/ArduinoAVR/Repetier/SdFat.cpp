@@ -407,6 +407,9 @@ dir_t* SdBaseFile::cacheDirEntry(uint8_t action) {
 bool SdBaseFile::close() {
   bool rtn = sync();
   type_ = FAT_FILE_TYPE_CLOSED;
+#if SD_EXTENT_CACHE
+  extents_ = 0;
+#endif  // SD_EXTENT_CACHE
   return rtn;
 }
 //------------------------------------------------------------------------------
@@ -1379,6 +1382,9 @@ bool SdBaseFile::openCachedEntry(uint8_t dirIndex, uint8_t oflag) {
   // remember location of directory entry on SD
   dirBlock_ = vol_->cacheBlockNumber();
   dirIndex_ = dirIndex;
+#if SD_EXTENT_CACHE
+  extents_ = 0;
+#endif  // SD_EXTENT_CACHE
 
   // copy first cluster number for directory fields
   firstCluster_ = (uint32_t)p->firstClusterHigh << 16;
@@ -1574,6 +1580,9 @@ bool SdBaseFile::openRoot(SdVolume* vol) {
     goto fail;
   }
   vol_ = vol;
+#if SD_EXTENT_CACHE
+  extents_ = 0;
+#endif  // SD_EXTENT_CACHE
   if (vol->fatType() == 16 || (FAT12_SUPPORT && vol->fatType() == 12)) {
     type_ = FAT_FILE_TYPE_ROOT_FIXED;
     firstCluster_ = 0;
@@ -1879,6 +1888,11 @@ int SdBaseFile::read(void* buf, size_t nbyte) {
           // use first cluster in file
           curCluster_ = firstCluster_;
         } else {
+#if SD_EXTENT_CACHE
+          // the extent cache avoids the FAT read, which would evict the data block
+          if (extentCluster(curPosition_ >> (vol_->clusterSizeShift_ + 9), &curCluster_, 0)) {
+          } else
+#endif  // SD_EXTENT_CACHE
           // get next cluster from FAT
           if (!vol_->fatGet(curCluster_, &curCluster_)) {
             DBG_FAIL_MACRO;
@@ -2110,6 +2124,206 @@ bool SdBaseFile::findSpace(dir_t *dir, int8_t cVFATNeeded, int8_t *pcVFATFound,
   }
 }
 
+#if SD_BUFFERED_UPLOAD
+//------------------------------------------------------------------------------
+/** Append free clusters to the end of the cluster chain.
+ *
+ * \param[in] count Number of consecutive clusters to allocate.
+ *
+ * write() uses the clusters before it allocates new ones. truncate() frees
+ * the clusters not needed when the file is complete.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ * Reasons for failure include no \a count free consecutive clusters.
+ */
+bool SdBaseFile::preAllocate(uint32_t count) {
+  uint32_t last = curCluster_ ? curCluster_ : firstCluster_;
+  uint32_t next;
+  if (!isFile() || !(flags_ & O_WRITE)) {
+    DBG_FAIL_MACRO;
+    goto fail;
+  }
+  // find the end of the chain
+  while (last) {
+    if (!vol_->fatGet(last, &next)) {
+      DBG_FAIL_MACRO;
+      goto fail;
+    }
+    if (vol_->isEOC(next)) break;
+    last = next;
+  }
+  if (!vol_->allocContiguous(count, &last)) {
+    DBG_FAIL_MACRO;
+    goto fail;
+  }
+  if (firstCluster_ == 0) {
+    firstCluster_ = last;
+    flags_ |= F_FILE_DIR_DIRTY;
+  }
+  return true;
+
+ fail:
+  return false;
+}
+#endif  // SD_BUFFERED_UPLOAD
+#if SD_EXTENT_CACHE
+//------------------------------------------------------------------------------
+/** Record the runs of consecutive clusters of the file.
+ *
+ * \param[out] cache Receives the runs. It is used by read(), seekSet() and
+ * contiguousBlocks() until the file is closed or opened again, so data reads
+ * find their block without reading the FAT.
+ *
+ * The cluster chain is walked once. A file with more than SD_EXTENT_CACHE
+ * runs is only covered up to the last run, clusters after it are looked up
+ * in the FAT as before.
+ *
+ * \return The value one, true, is returned if the cache covers the whole
+ * file, the value zero, false, is returned otherwise.
+ */
+bool SdBaseFile::buildExtents(SdExtentCache* cache) {
+  uint32_t cluster = firstCluster_;
+  uint32_t index = 0;
+  uint32_t next;
+  cache->count = 0;
+  cache->clusters = 0;
+  extents_ = 0;
+  if (!isFile() || cluster == 0) return false;
+  while (1) {
+    if (cache->count == 0 || cluster != cache->cluster[cache->count - 1] +
+        (index - cache->fileCluster[cache->count - 1])) {
+      if (cache->count == SD_EXTENT_CACHE) break;
+      cache->fileCluster[cache->count] = index;
+      cache->cluster[cache->count++] = cluster;
+    }
+    cache->clusters = ++index;
+    if (!vol_->fatGet(cluster, &next)) {
+      DBG_FAIL_MACRO;
+      break;
+    }
+    if (vol_->isEOC(next)) {
+      extents_ = cache;
+      return true;
+    }
+    cluster = next;
+  }
+  // keep the runs found so far, the last one may continue after cache->clusters
+  extents_ = cache->clusters ? cache : 0;
+  return false;
+}
+//------------------------------------------------------------------------------
+/** Look up a cluster of the file in the extent cache.
+ *
+ * \param[in] index Cluster index in the file.
+ * \param[out] cluster Volume cluster.
+ * \param[out] run If not NULL, number of consecutive clusters from it.
+ *
+ * \return The value one, true, is returned if the cache contains the cluster.
+ */
+bool SdBaseFile::extentCluster(uint32_t index, uint32_t* cluster, uint32_t* run) {
+  if (!extents_ || index >= extents_->clusters) return false;
+  uint8_t i = extents_->count - 1;
+  while (extents_->fileCluster[i] > index) i--;
+  *cluster = extents_->cluster[i] + (index - extents_->fileCluster[i]);
+  if (run) {
+    *run = (i + 1 < extents_->count ? extents_->fileCluster[i + 1] : extents_->clusters) - index;
+  }
+  return true;
+}
+#endif  // SD_EXTENT_CACHE
+#if SD_READ_AHEAD
+//------------------------------------------------------------------------------
+/** Find the run of consecutive device blocks holding the file data at \a pos.
+ *
+ * \param[in] pos Block aligned file position.
+ * \param[out] block First device block of the run.
+ * \param[in,out] count Maximum length of the run, returns its length.
+ *
+ * The run ends at the end of the file, after \a count blocks or where the
+ * cluster chain is not contiguous. The file position is set to the end of
+ * the run, so following calls only look at the FAT entries of new clusters.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ */
+bool SdBaseFile::contiguousBlocks(uint32_t pos, uint32_t* block, uint16_t* count) {
+  uint32_t cluster;
+  uint32_t next;
+  uint32_t left;
+  uint16_t n;
+  uint8_t blockOfCluster;
+  if ((pos & 0X1FF) || pos >= fileSize_ || !seekSet(pos)) {
+    DBG_FAIL_MACRO;
+    goto fail;
+  }
+  left = ((fileSize_ - pos) + 511) >> 9;
+  if (left < *count) *count = left;
+  if (type_ == FAT_FILE_TYPE_ROOT_FIXED) {
+    *block = vol_->rootDirStart() + (pos >> 9);
+    curPosition_ = pos + ((uint32_t)*count << 9);
+    if (curPosition_ > fileSize_) curPosition_ = fileSize_;
+    return true;
+  }
+  blockOfCluster = vol_->blockOfCluster(pos);
+#if SD_EXTENT_CACHE
+  if (extentCluster(pos >> (vol_->clusterSizeShift_ + 9), &cluster, &left)) {
+    *block = vol_->clusterStartBlock(cluster) + blockOfCluster;
+    left = (left << vol_->clusterSizeShift_) - blockOfCluster;
+    if (left < *count) *count = left;
+    curCluster_ = cluster + ((blockOfCluster + *count - 1) >> vol_->clusterSizeShift_);
+    curPosition_ = pos + ((uint32_t)*count << 9);
+    if (curPosition_ > fileSize_) curPosition_ = fileSize_;
+    return true;
+  }
+#endif  // SD_EXTENT_CACHE
+  if (blockOfCluster != 0) {
+    cluster = curCluster_;
+  } else if (pos == 0) {
+    cluster = firstCluster_;
+  } else if (!vol_->fatGet(curCluster_, &cluster)) {
+    DBG_FAIL_MACRO;
+    goto fail;
+  }
+  *block = vol_->clusterStartBlock(cluster) + blockOfCluster;
+  n = vol_->blocksPerCluster() - blockOfCluster;
+  while (n < *count) {
+    if (!vol_->fatGet(cluster, &next)) {
+      DBG_FAIL_MACRO;
+      goto fail;
+    }
+    if (next != cluster + 1) break;
+    cluster = next;
+    n += vol_->blocksPerCluster();
+  }
+  if (n < *count) *count = n;
+  curCluster_ = cluster;
+  curPosition_ = pos + ((uint32_t)*count << 9);
+  if (curPosition_ > fileSize_) curPosition_ = fileSize_;
+  return true;
+
+ fail:
+  return false;
+}
+//------------------------------------------------------------------------------
+/** Read a device block of this file, see contiguousBlocks().
+ *
+ * Consecutive blocks are read with one multiple block read, a block that
+ * is in the volume cache is copied from there.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ */
+bool SdBaseFile::readStreamBlock(uint32_t block, uint8_t* dst) {
+  if (block == vol_->cacheBlockNumber()) {
+    cache_t* pc = vol_->cacheFetch(block, SdVolume::CACHE_FOR_READ);
+    if (!pc) return false;
+    memcpy(dst, pc->data, 512);
+    return true;
+  }
+  return vol_->sdCard()->readStreamBlock(block, dst);
+}
+#endif  // SD_READ_AHEAD
 //------------------------------------------------------------------------------
 /** Read the next directory entry from a directory file.
  *
@@ -2511,6 +2725,13 @@ bool SdBaseFile::seekSet(uint32_t pos) {
   // calculate cluster index for cur and new position
   nCur = (curPosition_ - 1) >> (vol_->clusterSizeShift_ + 9);
   nNew = (pos - 1) >> (vol_->clusterSizeShift_ + 9);
+#if SD_EXTENT_CACHE
+  if (extentCluster(nNew, &nCur, 0)) {
+    curCluster_ = nCur;
+    curPosition_ = pos;
+    goto done;
+  }
+#endif  // SD_EXTENT_CACHE
 
   if (nNew < nCur || curPosition_ == 0) {
     // must follow chain from first cluster
@@ -3189,6 +3410,13 @@ static uint16_t CRC_CCITT(const uint8_t* data, size_t n) {
 //------------------------------------------------------------------------------
 // send command and return error code.  Return zero for OK
 uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
+#if SD_READ_AHEAD
+  // any other command ends an open multiple block read
+  if (streamBlock_ != 0XFFFFFFFF && cmd != CMD12) {
+    streamBlock_ = 0XFFFFFFFF;
+    readStop();
+  }
+#endif  // SD_READ_AHEAD
   // select card
   chipSelectLow();
 
@@ -3334,6 +3562,9 @@ bool Sd2Card::eraseSingleBlockEnable() {
  */
 bool Sd2Card::init(uint8_t sckRateID, uint8_t chipSelectPin) {
   errorCode_ = type_ = 0;
+#if SD_READ_AHEAD
+  streamBlock_ = 0XFFFFFFFF;
+#endif  // SD_READ_AHEAD
   chipSelectPin_ = chipSelectPin;
   // 16-bit init start time allows over a minute
   uint16_t t0 = (uint16_t)HAL::timeInMilliseconds();
@@ -3543,6 +3774,34 @@ bool Sd2Card::readStop() {
   chipSelectHigh();
   return false;
 }
+#if SD_READ_AHEAD
+//------------------------------------------------------------------------------
+/** Read a 512 byte block with a multiple block read.
+ *
+ * \param[in] blockNumber Logical block to be read.
+ * \param[out] dst Pointer to the location that will receive the data.
+ *
+ * A new CMD18 sequence is only started if \a blockNumber does not follow
+ * the block read last. The sequence stays open until the next command for
+ * the card, so consecutive blocks cost neither a command nor the access time.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ */
+bool Sd2Card::readStreamBlock(uint32_t blockNumber, uint8_t* dst) {
+  if (blockNumber != streamBlock_) {
+    // readStart ends an open sequence
+    if (!readStart(blockNumber)) return false;
+  }
+  streamBlock_ = 0XFFFFFFFF;
+  if (!readData(dst)) {
+    readStop();
+    return false;
+  }
+  streamBlock_ = blockNumber + 1;
+  return true;
+}
+#endif  // SD_READ_AHEAD
 //------------------------------------------------------------------------------
 /**
  * Set the SPI clock rate.
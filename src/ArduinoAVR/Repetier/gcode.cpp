@@ -43,6 +43,17 @@ int8_t   GCode::waitingForResend=-1; ///< Waiting for line to be resend. -1 = no
 volatile uint8_t GCode::bufferLength=0; ///< Number of commands stored in gcode_buffer
 millis_t GCode::timeOfLastDataPacket=0; ///< Time, when we got the last data packet. Used to detect missing uint8_ts.
 uint8_t  GCode::formatErrors=0;
+bool     GCode::okWindow=false; ///< Append the free places of commandsBuffered to every ok, set with M576.
+millis_t GCode::timeOfLastResend=0; ///< Time of the last resend request.
+#if BINARY_PROTOCOL_V3
+uint8_t  GCode::framePos=0; ///< Position of the next move of a v3 frame in commandReceiving, 0 = no frame.
+uint8_t  GCode::frameEnd; ///< Position of the checksum of the v3 frame.
+int32_t  GCode::frameBase[4]={0,0,0,0}; ///< Last X, Y, Z and E sent by the host in micrometres.
+#endif
+#if SERIAL_RX_ZERO_COPY
+uint16_t GCode::serialRxScanned=0; ///< Bytes at the tail of the receive ring that belong to an incomplete command.
+bool     GCode::serialRxInComment=false; ///< Skipping the comment of a command that was already parsed.
+#endif
 
 /** \page Repetier-protocol
 
@@ -87,18 +98,39 @@ Gcode Letter to Bit and Datatype:
 - S : Bit 10 : 32 Bit Value
 - P : Bit 11 : 32 Bit Integer
 - V2 : Bit 12 : Version 2 command for additional commands/sizes
-- Ext : Bit 13 : There are 2 more uint8_ts following with Bits, only for future versions
+- Ext : Bit 13 : Version 3 frame, see below
 - Int :Bit 14 : Marks it as internal command,
 - Text : Bit 15 : 16 Byte ASCII String terminated with 0
 Second word if V2:
 - I : Bit 0 : 32-Bit float
 - J : Bit 1 : 32-Bit float
 - R : Bit 2 : 32-Bit float
+
+A version 3 frame packs several G0/G1 moves with one checksum (BINARY_PROTOCOL_V3):
+- Bitfield : Bit 7 and 13 set, bit 0 if a 16 bit line number follows the size.
+- Size : 8 bit, bytes of the whole frame including bitfield and checksum, max. MAX_CMD_SIZE.
+- Moves, each starting with a flag byte
+  - Bit 0-3 : X, Y, Z, E follow as 16 bit signed micrometres relative to the last position sent
+  - Bit 4 : F follows as 16 bit unsigned mm/min, otherwise the last feedrate is used.
+  - Bit 5 : G0 instead of G1
+  - Bit 6 : X, Y, Z, E are 32 bit absolute micrometres instead.
+- Fletcher-16 checksum of the frame.
+
+The last position sent is also taken from the X, Y, Z, E values of G0, G1 and G92 in other
+formats. The coordinates are absolute, so the host must not use it with G91 or M83.
+A frame is acknowledged with one ok, its moves enter the command buffer as places get free.
 */
 uint8_t GCode::computeBinarySize(char *ptr)  // unsigned int bitfield) {
 {
     uint8_t s = 4; // include checksum and bitfield
     uint16_t bitfield = *(uint16_t*)ptr;
+#if BINARY_PROTOCOL_V3
+    if((bitfield & 12288) == 8192)   // Version 3 frame stores its size
+    {
+        s = ptr[2];
+        return (s < 5 || s > MAX_CMD_SIZE ? 255 : s);
+    }
+#endif
     if(bitfield & 1) s+=2;
     if(bitfield & 8) s+=4;
     if(bitfield & 16) s+=4;
@@ -128,18 +160,56 @@ uint8_t GCode::computeBinarySize(char *ptr)  // unsigned int bitfield) {
     return s;
 }
 
-void GCode::requestResend()
+/** \brief Requests the line after lastLineNumber again.
+
+\param failed Line that failed its checksum. Its line number, if it was read, tells if it was in flight behind
+the line already requested.
+*/
+void GCode::requestResend(GCode *failed)
 {
     HAL::serialFlush();
     commandsReceivingWritePosition=0;
+    millis_t time = HAL::timeInMilliseconds();
+    if(okWindow && waitingForResend>=0 && time-timeOfLastResend<200 && failed != NULL && failed->hasN() &&
+            static_cast<uint16_t>(failed->N - ((lastLineNumber + 1) & 0xffff) - 1) < 39)
+    {
+        // A streaming host has more lines in flight. It already goes back to the requested line,
+        // asking again would make it resend the same lines twice. A corrupted requested line is asked again.
+        sendOk();
+        return;
+    }
+    timeOfLastResend = time;
     if(sendAsBinary)
         waitingForResend = 30;
     else
         waitingForResend = 14;
     Com::println();
     Com::printFLN(Com::tResend,lastLineNumber+1);
-    Com::printFLN(Com::tOk);
+    sendOk();
+}
+/** \brief Sends ok. In ok window mode (M576 S1) the free places in commandsBuffered follow as B<n>.
+
+A host can then keep that many further commands in flight instead of waiting for the ok of each line.
+Commands it already sent after the acknowledged line count against the free places.
+*/
+void GCode::sendOk(bool withLineNumber)
+{
+#ifdef ACK_WITH_LINENUMBER
+    if(withLineNumber)
+        Com::printF(Com::tOkSpace,actLineNumber);
+    else
+#endif
+        Com::printF(Com::tOk);
+    if(okWindow)
+        Com::printF(PSTR(" B"),(int)(GCODE_BUFFER_SIZE - bufferLength));
+    Com::println();
+}
+#if BINARY_PROTOCOL_V3
+static inline int32_t frameMicrons(float value)
+{
+    return static_cast<int32_t>(value * 1000.0f + (value < 0 ? -0.5f : 0.5f));
 }
+#endif
 /**
   Check if result is plausible. If it is, an ok is send and the command is stored in queue.
   If not, a resend and ok is send.
@@ -151,7 +221,7 @@ void GCode::checkAndPushCommand()
         if(M==110)   // Reset line number
         {
             lastLineNumber = actLineNumber;
-            Com::printFLN(Com::tOk);
+            sendOk();
             waitingForResend = -1;
             return;
         }
@@ -175,7 +245,7 @@ void GCode::checkAndPushCommand()
                 // we have seen that line already. So we assume it is a repeated resend and we ignore it
                 commandsReceivingWritePosition = 0;
                 Com::printFLN(Com::tSkip,actLineNumber);
-                Com::printFLN(Com::tOk);
+                sendOk();
             }
             else
             if(waitingForResend<0)   // after a resend, we have to skip the garbage in buffers, no message for this
@@ -189,24 +259,109 @@ void GCode::checkAndPushCommand()
             }
             else
             {
-                --waitingForResend;
+                if(!okWindow) // a streaming host may have many lines in flight, skip all of them
+                    --waitingForResend;
                 commandsReceivingWritePosition = 0;
                 Com::printFLN(Com::tSkip,actLineNumber);
-                Com::printFLN(Com::tOk);
+                sendOk();
             }
             return;
         }
         lastLineNumber = actLineNumber;
     }
-    pushCommand();
-#ifdef ACK_WITH_LINENUMBER
-    Com::printFLN(Com::tOkSpace,actLineNumber);
-#else
-    Com::printFLN(Com::tOk);
-#endif
+    queueCommand();
+    sendOk(true);
     wasLastCommandReceivedAsBinary = sendAsBinary;
     waitingForResend = -1; // everything is ok.
 }
+/** \brief Queues the command just parsed from serial or sdcard.
+
+A v3 frame stays in commandReceiving, readFromSerial pushes its moves with pushFrameMoves
+before it reads more. Other moves set the position the next frame is relative to.
+*/
+void GCode::queueCommand()
+{
+#if BINARY_PROTOCOL_V3
+    if(isV3Frame())   // moves are pushed by pushFrameMoves
+    {
+        framePos = (hasN() ? 5 : 3);
+        frameEnd = binaryCommandSize - 2;
+        return;
+    }
+    if(hasG() && (G <= 1 || G == 92)) // next frame is relative to this position
+    {
+        if(hasX()) frameBase[X_AXIS] = frameMicrons(X);
+        if(hasY()) frameBase[Y_AXIS] = frameMicrons(Y);
+        if(hasZ()) frameBase[Z_AXIS] = frameMicrons(Z);
+        if(hasE()) frameBase[E_AXIS] = frameMicrons(E);
+    }
+#endif
+    pushCommand();
+}
+#if BINARY_PROTOCOL_V3
+/** \brief Moves the next position of a v3 frame by the values at p. */
+static float frameAxis(int32_t &base,uint8_t *&p,bool absolute)
+{
+    if(absolute)
+    {
+        base = *(int32_t *)p;
+        p += 4;
+    }
+    else
+    {
+        base += *(int16_t *)p;
+        p += 2;
+    }
+    return base / 1000.0f; // same float as parsing the decimal value
+}
+/** \brief Pushes the moves of the current v3 frame while the command buffer has free places. */
+void GCode::pushFrameMoves()
+{
+    while(framePos && bufferLength < GCODE_BUFFER_SIZE)
+    {
+        if(framePos >= frameEnd)
+        {
+            framePos = 0;
+            break;
+        }
+        uint8_t *p = &commandReceiving[framePos];
+        uint8_t flags = *p++;
+        bool absolute = (flags & 64) != 0;
+        GCode *act = &commandsBuffered[bufferWriteIndex];
+        act->params = 4;
+        act->params2 = 0;
+        act->G = (flags & 32 ? 0 : 1);
+        if(flags & 1)
+        {
+            act->X = frameAxis(frameBase[X_AXIS], p, absolute);
+            act->params |= 8;
+        }
+        if(flags & 2)
+        {
+            act->Y = frameAxis(frameBase[Y_AXIS], p, absolute);
+            act->params |= 16;
+        }
+        if(flags & 4)
+        {
+            act->Z = frameAxis(frameBase[Z_AXIS], p, absolute);
+            act->params |= 32;
+        }
+        if(flags & 8)
+        {
+            act->E = frameAxis(frameBase[E_AXIS], p, absolute);
+            act->params |= 64;
+        }
+        if(flags & 16)
+        {
+            act->F = *(uint16_t *)p;
+            p += 2;
+            act->params |= 256;
+        }
+        framePos = p - commandReceiving;
+        pushCommand();
+    }
+}
+#endif
 void GCode::pushCommand()
 {
 #ifndef ECHO_ON_EXECUTE
@@ -307,7 +462,17 @@ void GCode::readFromSerial()
     if(bufferLength>=GCODE_BUFFER_SIZE) return; // all buffers full
     if(waitUntilAllCommandsAreParsed && bufferLength) return;
     waitUntilAllCommandsAreParsed=false;
+#if BINARY_PROTOCOL_V3
+    if(framePos)
+    {
+        pushFrameMoves();
+        if(framePos) return;
+    }
+#endif
     millis_t time = HAL::timeInMilliseconds();
+#if SERIAL_RX_ZERO_COPY
+    if(readFromSerialRing(time)) return;
+#else
     if(!HAL::serialByteAvailable())
     {
         if((waitingForResend>=0 || commandsReceivingWritePosition>0) && time-timeOfLastDataPacket>200)
@@ -357,7 +522,7 @@ void GCode::readFromSerial()
                 if(act->parseBinary(commandReceiving,true))   // Success
                     act->checkAndPushCommand();
                 else
-                    requestResend();
+                    requestResend(act);
                 commandsReceivingWritePosition = 0;
                 return;
             }
@@ -379,7 +544,7 @@ void GCode::readFromSerial()
                 if(act->parseAscii((char *)commandReceiving,true))   // Success
                     act->checkAndPushCommand();
                 else
-                    requestResend();
+                    requestResend(act);
                 commandsReceivingWritePosition = 0;
                 return;
             }
@@ -395,13 +560,22 @@ void GCode::readFromSerial()
             return;
         }
     }
+#endif // SERIAL_RX_ZERO_COPY
 #if SDSUPPORT
     if(!sd.sdmode || commandsReceivingWritePosition!=0)   // not reading or incoming serial command
         return;
+#if MOTION_STREAM
+    if(sd.motionStream) // read by Commands::commandLoop
+        return;
+#endif
     while( sd.filesize > sd.sdpos && commandsReceivingWritePosition < MAX_CMD_SIZE)    // consume data until no data or buffer full
     {
         timeOfLastDataPacket = HAL::timeInMilliseconds();
+#if SD_READ_AHEAD
+        int n = sd.readByte();
+#else
         int n = sd.file.read();
+#endif
         if(n==-1)
         {
             Com::printFLN(Com::tSDReadError);
@@ -409,7 +583,12 @@ void GCode::readFromSerial()
 
             // Second try in case of recoverable errors
             sd.file.seekSet(sd.sdpos);
+#if SD_READ_AHEAD
+            sd.resetReadAhead();
+            n = sd.readByte();
+#else
             n = sd.file.read();
+#endif
             if(n==-1)
             {
                 Com::printErrorFLN(PSTR("SD error did not recover!"));
@@ -435,7 +614,7 @@ void GCode::readFromSerial()
             {
                 GCode *act = &commandsBuffered[bufferWriteIndex];
                 if(act->parseBinary(commandReceiving,false))   // Success, silently ignore illegal commands
-                    pushCommand();
+                    act->queueCommand();
                 commandsReceivingWritePosition = 0;
                 return;
             }
@@ -458,7 +637,7 @@ void GCode::readFromSerial()
                 }
                 GCode *act = &commandsBuffered[bufferWriteIndex];
                 if(act->parseAscii((char *)commandReceiving,false))   // Success
-                    pushCommand();
+                    act->queueCommand();
                 commandsReceivingWritePosition = 0;
                 return;
             }
@@ -477,6 +656,127 @@ void GCode::readFromSerial()
 #endif
 }
 
+/**
+  Converts the command into the binary format with checksum. buf needs 100 bytes.
+  Returns the size or 0 if the command has no parameters.
+*/
+uint8_t GCode::writeBinary(uint8_t *buf)
+{
+    unsigned int sum1=0,sum2=0; // for fletcher-16 checksum
+    uint8_t p=2;
+    int params = 128 | (this->params & ~1);
+    if(params == 128) return 0;
+    *(int*)buf = params;
+    if(isV2())   // Read G,M as 16 bit value
+    {
+        *(int*)&buf[p] = params2;
+        p+=2;
+        if(hasString())
+            buf[p++] = strlen(text);
+        if(hasM())
+        {
+            *(int*)&buf[p] = M;
+            p+=2;
+        }
+        if(hasG())
+        {
+            *(int*)&buf[p]= G;
+            p+=2;
+        }
+    }
+    else
+    {
+        if(hasM())
+        {
+            buf[p++] = (uint8_t)M;
+        }
+        if(hasG())
+        {
+            buf[p++] = (uint8_t)G;
+        }
+    }
+    if(hasX())
+    {
+        *(float*)&buf[p] = X;
+        p+=4;
+    }
+    if(hasY())
+    {
+        *(float*)&buf[p] = Y;
+        p+=4;
+    }
+    if(hasZ())
+    {
+        *(float*)&buf[p] = Z;
+        p+=4;
+    }
+    if(hasE())
+    {
+        *(float*)&buf[p] = E;
+        p+=4;
+    }
+    if(hasF())
+    {
+        *(float*)&buf[p] = F;
+        p+=4;
+    }
+    if(hasT())
+    {
+        buf[p++] = T;
+    }
+    if(hasS())
+    {
+        *(long int*)&buf[p] = S;
+        p+=4;
+    }
+    if(hasP())
+    {
+        *(long int*)&buf[p] = P;
+        p+=4;
+    }
+    if(hasI())
+    {
+        *(float*)&buf[p] = I;
+        p+=4;
+    }
+    if(hasJ())
+    {
+        *(float*)&buf[p] = J;
+        p+=4;
+    }
+    if(hasString())   // read 16 uint8_t into string
+    {
+        char *sp = text;
+        if(isV2())
+        {
+            uint8_t i = strlen(text);
+            for(; i; i--) buf[p++] = *sp++;
+        }
+        else
+        {
+            for(uint8_t i=0; i<16; ++i) buf[p++] = *sp++;
+        }
+    }
+    uint8_t *ptr = buf;
+    uint8_t len = p;
+    while (len)
+    {
+        uint8_t tlen = len > 21 ? 21 : len;
+        len -= tlen;
+        do
+        {
+            sum1 += *ptr++;
+            if(sum1>=255) sum1-=255;
+            sum2 += sum1;
+            if(sum2>=255) sum2-=255;
+        }
+        while (--tlen);
+    }
+    buf[p++] = sum1;
+    buf[p++] = sum2;
+    return p;
+}
+
 /**
   Converts a binary uint8_tfield containing one GCode line into a GCode structure.
   Returns true if checksum was correct.
@@ -509,8 +809,43 @@ bool GCode::parseBinary(uint8_t *buffer,bool fromSerial)
         {
             Com::printErrorFLN(Com::tWrongChecksum);
         }
+        params = 0; // no line number for requestResend
         return false;
     }
+#if BINARY_PROTOCOL_V3
+    if((*(uint16_t *)buffer & 12288) == 8192)   // Version 3 frame
+    {
+        params = 8192 | (buffer[0] & 1);
+        params2 = 0;
+        p = buffer + 3;
+        if(hasN())
+        {
+            actLineNumber = N = *(uint16_t *)p;
+            p += 2;
+        }
+        // Check that the moves end exactly at the checksum, so pushFrameMoves can trust them
+        uint8_t *end = buffer + binaryCommandSize - 2;
+        while(p < end)
+        {
+            uint8_t flags = *p++;
+            if(flags & 128) break;
+            uint8_t axisSize = (flags & 64 ? 4 : 2);
+            for(uint8_t i = 0; i < 4; i++)
+                if(flags & (1 << i)) p += axisSize;
+            if(flags & 16) p += 2;
+        }
+        if(p != end)
+        {
+            if(Printer::debugErrors())
+                Com::printErrorFLN(Com::tFormatError);
+            return false;
+        }
+        if(buffer != commandReceiving) // keep the frame until all moves are pushed
+            memcpy(commandReceiving, buffer, binaryCommandSize);
+        formatErrors = 0;
+        return true;
+    }
+#endif
     p = buffer;
     params = *(unsigned int *)p;
     p+=2;
@@ -617,8 +952,256 @@ bool GCode::parseBinary(uint8_t *buffer,bool fromSerial)
     return true;
 }
 
+#if SERIAL_RX_ZERO_COPY
+/** \brief Copies len bytes from the receive ring starting offset bytes after the tail. */
+static void copyFromSerialRing(uint8_t *dest,uint16_t offset,uint16_t len)
+{
+    uint8_t *ring = HAL::serialRxData();
+    uint16_t pos = (HAL::serialRxTail() + offset) & SERIAL_RX_BUFFER_MASK;
+    uint16_t first = RMath::min(len, static_cast<uint16_t>(SERIAL_RX_BUFFER_SIZE - pos));
+    memcpy(dest, ring + pos, first);
+    memcpy(dest + first, ring, len - first);
+}
+/** \brief Parses the commands in the serial receive ring where they are.
+
+Instead of copying every byte into commandReceiving, the ring is scanned for the end of the next
+command. A complete command is parsed directly from the ring and only then the bytes are freed.
+Only commands wrapping around the end of the ring and commands with a text argument, which must
+survive until they are executed, are copied to commandReceiving. All complete commands are read
+as long as commandsBuffered has space. Otherwise it behaves like the byte wise version.
+Returns true if serial data was processed or is pending, so the sd card must wait.
+*/
+bool GCode::readFromSerialRing(millis_t time)
+{
+    uint16_t avail = HAL::serialRxAvailable();
+    if(avail == serialRxScanned) // nothing new arrived
+    {
+        if((waitingForResend>=0 || avail>0) && time-timeOfLastDataPacket>200)
+        {
+            HAL::serialRxConsume(avail); // Something is wrong, a started line was not continued
+            serialRxScanned = 0;
+            serialRxInComment = false;
+            requestResend();
+            timeOfLastDataPacket = time;
+        }
+#ifdef WAITING_IDENTIFIER
+        else if(bufferLength == 0 && time-timeOfLastDataPacket>1000)   // Don't do it if buffer is not empty. It may be a slow executing command.
+        {
+            Com::printFLN(Com::tWait); // Unblock communication in case the last ok was not received correct.
+            timeOfLastDataPacket = time;
+        }
+#endif
+        return avail > 0;
+    }
+    timeOfLastDataPacket = time;
+    uint8_t *ring = HAL::serialRxData();
+    while(avail > serialRxScanned && bufferLength < GCODE_BUFFER_SIZE && !waitUntilAllCommandsAreParsed)
+    {
+        uint16_t tail = HAL::serialRxTail();
+        if(serialRxInComment) // drop the comment up to the line end
+        {
+            uint16_t i = 0;
+            while(i < avail)
+            {
+                uint8_t ch = ring[(tail + i++) & SERIAL_RX_BUFFER_MASK];
+                if(ch == 0 || ch == '\n' || ch == '\r')
+                {
+                    serialRxInComment = false;
+                    break;
+                }
+            }
+            HAL::serialRxConsume(i);
+            avail -= i;
+            continue;
+        }
+        if(serialRxScanned == 0) // start of a new command
+        {
+            uint8_t first = ring[tail];
+            if(waitingForResend>=0 && wasLastCommandReceivedAsBinary)
+            {
+                if(!first)
+                    waitingForResend--;   // Skip 30 zeros to get in sync
+                else
+                    waitingForResend = 30;
+                HAL::serialRxConsume(1);
+                avail--;
+                continue;
+            }
+            if(!first) // Ignore zeros
+            {
+                HAL::serialRxConsume(1);
+                avail--;
+                continue;
+            }
+            sendAsBinary = (first & 128)!=0;
+        }
+        GCode *act = &commandsBuffered[bufferWriteIndex];
+        uint8_t *cmd;
+        uint16_t length; // bytes the command occupies in the ring
+        bool ok;
+        if(sendAsBinary)
+        {
+            uint8_t header[5];
+            serialRxScanned = avail;
+            if(avail < 4) break;
+            copyFromSerialRing(header, 0, RMath::min(avail, static_cast<uint16_t>(5)));
+            length = binaryCommandSize = computeBinarySize((char*)header);
+            if(length > MAX_CMD_SIZE)
+            {
+                HAL::serialRxConsume(RMath::min(avail, static_cast<uint16_t>(MAX_CMD_SIZE)));
+                serialRxScanned = 0;
+                requestResend();
+                return true;
+            }
+            if(avail < length) break;
+            if(tail + length <= SERIAL_RX_BUFFER_SIZE)
+                cmd = ring + tail;
+            else
+            {
+                copyFromSerialRing(commandReceiving, 0, length);
+                cmd = commandReceiving;
+            }
+            ok = act->parseBinary(cmd,true);
+        }
+        else     // Ascii command
+        {
+            uint16_t end = serialRxScanned;
+            uint8_t ch = 0;
+            while(end < avail)
+            {
+                ch = ring[(tail + end) & SERIAL_RX_BUFFER_MASK];
+                if(ch == 0 || ch == '\n' || ch == '\r' || ch == ':' || ch == ';') break;
+                end++;
+            }
+            if(end >= MAX_CMD_SIZE)
+            {
+                HAL::serialRxConsume(end);
+                serialRxScanned = 0;
+                requestResend();
+                return true;
+            }
+            serialRxScanned = end;
+            if(end == avail) break; // line not complete
+            length = end + 1;
+            serialRxInComment = (ch == ';'); // ignore new data until lineend
+            if(end == 0)   // empty line ignore
+            {
+                HAL::serialRxConsume(1);
+                avail--;
+                continue;
+            }
+            if(tail + end < SERIAL_RX_BUFFER_SIZE)
+                cmd = ring + tail;
+            else
+            {
+                copyFromSerialRing(commandReceiving, 0, end);
+                cmd = commandReceiving;
+            }
+            cmd[end] = 0;
+            ok = act->parseAscii((char *)cmd,true);
+        }
+        if(ok)   // Success
+        {
+            if(act->hasString() && cmd != commandReceiving) // text must survive until the command is executed
+            {
+                memcpy(commandReceiving, cmd, length);
+                act->text = (char*)commandReceiving + (act->text - (char*)cmd);
+            }
+            act->checkAndPushCommand();
+        }
+        else
+            requestResend(act);
+        HAL::serialRxConsume(length);
+        avail -= length;
+        serialRxScanned = 0;
+#if BINARY_PROTOCOL_V3
+        if(framePos)
+            pushFrameMoves();
+#endif
+    }
+    return true;
+}
+#endif
+
+#if FAST_ASCII_PARSER
+/** Powers of ten for the fraction digits accepted by scanFloatValue. */
+static const uint32_t scanPow10[10] = {1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL};
+
+/** \brief Reads a decimal number [+-]digits[.digits] and moves s behind it.
+
+Leading blanks are skipped like strtod does. Up to 9 significant digits with up to 9 fraction digits are collected
+as one integer and divided once by the power of ten in double. The division of two exact values is rounded like
+strtod rounds the decimal number, so the float is the same as with strtod. Longer numbers are read by strtod.
+On AVR, where double is float, numbers with more than 7 digits can be off by one bit. If no digit is found, s is
+not moved and the format error is set.
+*/
+float GCode::scanFloatValue(char *&s)
+{
+    char *p = s;
+    while(*p == ' ' || *p == '\t') p++;
+    bool negative = (*p == '-');
+    if(negative || *p == '+') p++;
+    uint32_t mantissa = 0;
+    uint8_t significant = 0, fraction = 0;
+    char *digits = p;
+    for(uint8_t d; (d = *p - '0') <= 9; p++)
+    {
+        mantissa = mantissa * 10 + d;
+        if(mantissa) significant++;
+    }
+    if(*p == '.')
+    {
+        p++;
+        for(uint8_t d; (d = *p - '0') <= 9; p++)
+        {
+            mantissa = mantissa * 10 + d;
+            if(mantissa) significant++;
+            fraction++;
+        }
+        if(p == digits + 1) // only the point
+            p = digits;
+    }
+    if(p == digits)
+    {
+        setFormatError();
+        return 0;
+    }
+    if(significant > 9 || fraction > 9) // mantissa may have overflown
+        return static_cast<float>(strtod(s, &s));
+    s = p;
+    float f = static_cast<float>(static_cast<double>(mantissa) / static_cast<double>(scanPow10[fraction]));
+    return negative ? -f : f;
+}
+
+/** \brief Reads a decimal integer [+-]digits and moves s behind it.
+
+Works like scanFloatValue without the fraction.
+*/
+long GCode::scanLongValue(char *&s)
+{
+    char *p = s;
+    while(*p == ' ' || *p == '\t') p++;
+    bool negative = (*p == '-');
+    if(negative || *p == '+') p++;
+    char *digits = p;
+    uint32_t l = 0;
+    for(uint8_t d; (d = *p - '0') <= 9; p++)
+        l = l * 10 + d;
+    if(p == digits)
+    {
+        setFormatError();
+        return 0;
+    }
+    s = p;
+    return negative ? -static_cast<long>(l) : static_cast<long>(l);
+}
+#endif
+
 /**
   Converts a ascii GCode line into a GCode structure.
+
+With FAST_ASCII_PARSER the line is read once from left to right. Every parameter letter is followed
+by its number, the first occurrence of a letter counts. The scan stops at the checksum.
 */
 bool GCode::parseAscii(char *line,bool fromSerial)
 {
@@ -626,6 +1209,114 @@ bool GCode::parseAscii(char *line,bool fromSerial)
     char *pos;
     params = 0;
     params2 = 0;
+#if FAST_ASCII_PARSER
+    pos = line;
+    char c;
+    while((c = *pos) != 0 && c != '*')
+    {
+        pos++;
+        switch(c)
+        {
+        case 'N':
+            if(hasN()) break;
+            actLineNumber = scanLongValue(pos);
+            params |=1;
+            N = actLineNumber & 0xffff;
+            break;
+        case 'M':
+            if(hasM()) break;
+            M = scanLongValue(pos) & 0xffff;
+            params |= 2;
+            if(M>255) params |= 4096;
+            if(M == 23 || M == 28 || M == 29 || M == 30 || M == 32 || M == 117)
+            {
+                // after M command we got a filename for sd card management
+                char *sp = pos;
+                while(*sp && *sp!=' ') sp++; // search next whitespace
+                while(*sp==' ') sp++; // skip leading whitespaces
+                text = sp;
+                while(*sp)
+                {
+                    if((M != 117 && *sp==' ') || *sp=='*') break; // end of filename reached
+                    sp++;
+                }
+                *sp = 0; // Removes checksum, but we don't care. Could also be part of the string.
+                waitUntilAllCommandsAreParsed = true; // don't risk string be deleted
+                params |= 32768;
+                pos = sp; // ends the scan
+            }
+            break;
+        case 'G':
+            if(hasG()) break;
+            G = scanLongValue(pos) & 0xffff;
+            params |= 4;
+            if(G>255) params |= 4096;
+            break;
+        case 'X':
+            if(hasX()) break;
+            X = scanFloatValue(pos);
+            params |= 8;
+            break;
+        case 'Y':
+            if(hasY()) break;
+            Y = scanFloatValue(pos);
+            params |= 16;
+            break;
+        case 'Z':
+            if(hasZ()) break;
+            Z = scanFloatValue(pos);
+            params |= 32;
+            break;
+        case 'E':
+            if(hasE()) break;
+            E = scanFloatValue(pos);
+            params |= 64;
+            break;
+        case 'F':
+            if(hasF()) break;
+            F = scanFloatValue(pos);
+            params |= 256;
+            break;
+        case 'T':
+            if(hasT()) break;
+            T = scanLongValue(pos) & 0xff;
+            params |= 512;
+            break;
+        case 'S':
+            if(hasS()) break;
+            S = scanLongValue(pos);
+            params |= 1024;
+            break;
+        case 'P':
+            if(hasP()) break;
+            P = scanLongValue(pos);
+            params |= 2048;
+            break;
+        case 'I':
+            if(hasI()) break;
+            I = scanFloatValue(pos);
+            params2 |= 1;
+            params |= 4096; // Needs V2 for saving
+            break;
+        case 'J':
+            if(hasJ()) break;
+            J = scanFloatValue(pos);
+            params2 |= 2;
+            params |= 4096; // Needs V2 for saving
+            break;
+        case 'R':
+            if(hasR()) break;
+            R = scanFloatValue(pos);
+            params2 |= 4;
+            params |= 4096; // Needs V2 for saving
+            break;
+        }
+    }
+    if(*pos == '*')   // checksum
+    {
+        char *cs = pos + 1;
+        uint8_t checksum_given = scanLongValue(cs);
+#else
     if((pos = strchr(line,'N'))!=0)   // Line number detected
     {
         actLineNumber = parseLongValue(++pos);
@@ -725,6 +1416,7 @@ bool GCode::parseAscii(char *line,bool fromSerial)
     if((pos = strchr(line,'*'))!=0)   // checksum
     {
         uint8_t checksum_given = parseLongValue(pos+1);
+#endif
         uint8_t checksum = 0;
         while(line!=pos) checksum ^= *line++;
 #if FEATURE_CHECKSUM_FORCED
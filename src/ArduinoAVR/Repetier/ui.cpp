@@ -1150,7 +1150,7 @@ void UIDisplay::parse(char *txt,bool ram)
             }
             if(c2=='B')
             {
-                addInt((int)PrintLine::linesCount,2);
+                addInt((int)PrintLine::queuedLines(),2);
                 break;
             }
             if(c2=='f')
@@ -1247,6 +1247,8 @@ void UIDisplay::parse(char *txt,bool ram)
                     addStringP(PSTR(UI_TEXT_STRING_HM_DEADTIME));
                 else if(hm == 2)
                     addStringP(PSTR(UI_TEXT_STRING_HM_SLOWBANG));
+                else if(hm == 4)
+                    addStringP(PSTR(UI_TEXT_STRING_HM_MODEL));
                 else
                     addStringP(PSTR(UI_TEXT_STRING_HM_BANGBANG));
             }
@@ -1392,10 +1394,18 @@ void UIDisplay::setStatus(char *txt,bool error)
 }
 
 const UIMenu * const ui_pages[UI_NUM_PAGES] PROGMEM = UI_PAGES;
+#if SD_DIR_INDEX
+// The list grows while the directory index is built
+#define nFilesOnCard sd.dirIndexFiles
+#else
 uint8_t nFilesOnCard;
+#endif
 void UIDisplay::updateSDFileCount()
 {
-#if SDSUPPORT
+#if SD_DIR_INDEX
+    sd.fat.chdir(cwd); // printing or uploading may have changed it
+    sd.startDirIndex(folderLevel<SD_MAX_FOLDER_DEPTH);
+#elif SDSUPPORT
     dir_t* p = NULL;
     byte offset = menuTop[menuLevel];
     SdBaseFile *root = sd.fat.vwd();
@@ -1417,7 +1427,10 @@ void UIDisplay::updateSDFileCount()
 
 void getSDFilenameAt(byte filePos,char *filename)
 {
-#if SDSUPPORT
+    *filename = 0;
+#if SD_DIR_INDEX
+    sd.getDirIndexName(filePos, filename);
+#elif SDSUPPORT
     dir_t* p;
     byte c=0;
     SdBaseFile *root = sd.fat.vwd();
@@ -1473,7 +1486,34 @@ void UIDisplay::goDir(char *name)
 
 void sdrefresh(uint8_t &r,char cache[UI_ROWS][MAX_COLS+1])
 {
-#if SDSUPPORT
+#if SD_DIR_INDEX
+    byte offset = uid.menuTop[uid.menuLevel];
+    byte length;
+    char filename[LONG_FILENAME_LENGTH+1];
+
+    // Index the visible files now, the rest is done in the background
+    while(sd.dirIndexFiles+1 < offset+UI_ROWS && sd.fillDirIndex()) {}
+    while (r+offset<nFilesOnCard+1 && r<UI_ROWS && sd.getDirIndexName(r+offset-1, filename))
+    {
+        uid.col=0;
+        if(r+offset == uid.menuPos[uid.menuLevel])
+            printCols[uid.col++] = CHAR_SELECTOR;
+        else
+            printCols[uid.col++] = ' ';
+        // print file name with possible blank fill
+        length = strlen(filename);
+        if(uid.isDirname(filename))
+        {
+            printCols[uid.col++] = 6; // Prepend folder symbol
+            length--;
+        }
+        length = RMath::min((int)length, MAX_COLS-uid.col);
+        memcpy(printCols+uid.col, filename, length);
+        uid.col += length;
+        printCols[uid.col] = 0;
+        strcpy(cache[r++],printCols);
+    }
+#elif SDSUPPORT
     dir_t* p = NULL;
     byte offset = uid.menuTop[uid.menuLevel];
     SdBaseFile *root;
@@ -1939,6 +1979,8 @@ void UIDisplay::okAction()
         char filename[LONG_FILENAME_LENGTH+1];
 
         getSDFilenameAt(filePos, filename);
+        if(!*filename) // directory changed, the list is built again
+            return;
         if(isDirname(filename))   // Directory change selected
         {
             goDir(filename);
@@ -1978,6 +2020,9 @@ void UIDisplay::okAction()
                 sd.file.close();
                 if(sd.fat.remove(filename))
                 {
+#if SD_DIR_INDEX
+                    sd.removeDirIndex(filePos);
+#endif
                     Com::printFLN(Com::tFileDeleted);
                     BEEP_LONG
                 }
@@ -2425,7 +2470,7 @@ void UIDisplay::nextPreviousAction(int8_t next)
         Extruder::selectExtruderById(Extruder::current->id);
         break;
     case UI_ACTION_EXTR_HEATMANAGER:
-        INCREMENT_MIN_MAX(Extruder::current->tempControl.heatManager,1,0,3);
+        INCREMENT_MIN_MAX(Extruder::current->tempControl.heatManager,1,0,4);
         break;
     case UI_ACTION_EXTR_WATCH_PERIOD:
         INCREMENT_MIN_MAX(Extruder::current->watchPeriod,1,0,999);
@@ -2922,7 +2967,7 @@ void UIDisplay::executeAction(int action)
             Com::printFLN(PSTR(" Recv. Write Pos:"),(int)GCode::commandsReceivingWritePosition);
             Com::printF(PSTR("Min. XY Speed:"),Printer::minimumSpeed);
             Com::printF(PSTR(" Min. Z Speed:"),Printer::minimumZSpeed);
-            Com::printF(PSTR(" Buffer:"),PrintLine::linesCount);
+            Com::printF(PSTR(" Buffer:"),(int)PrintLine::queuedLines());
             Com::printF(PSTR(" Lines pos:"),(int)PrintLine::linesPos);
             Com::printFLN(PSTR(" Write Pos:"),(int)PrintLine::linesWritePos);
             Com::printFLN(PSTR("Wait loop:"),debugWaitLoop);
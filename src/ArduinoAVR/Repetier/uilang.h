@@ -254,6 +254,7 @@
 #define UI_TEXT_POWER            "ATX power on/off"
 #define UI_TEXT_STRING_HM_DEADTIME     "Dead Time"
 #define UI_TEXT_STRING_HM_SLOWBANG     "SlowBang"
+#define UI_TEXT_STRING_HM_MODEL        "Model"
 #define UI_TEXT_STOP_PRINT "Stop Print"
 #define UI_TEXT_Z_BABYSTEPPING "Z Babystepping"
 
@@ -431,6 +432,7 @@
 #define UI_TEXT_POWER            "ATX Netzteil an/aus"
 #define UI_TEXT_STRING_HM_DEADTIME     "Totzeit"
 #define UI_TEXT_STRING_HM_SLOWBANG     "Langs.BB"
+#define UI_TEXT_STRING_HM_MODEL        "Modell"
 #define UI_TEXT_STOP_PRINT "Druck abbrechen"
 #define UI_TEXT_Z_BABYSTEPPING "Z Babyschritte"
 
@@ -1361,6 +1363,7 @@
 #define UI_TEXT_POWER               "ATX power on/off"
 #define UI_TEXT_STRING_HM_DEADTIME  "PWM"
 #define UI_TEXT_STRING_HM_SLOWBANG  "Tout ou Rien"
+#define UI_TEXT_STRING_HM_MODEL     "Modele"
 #define UI_TEXT_STOP_PRINT          "Arret Impress."
 
 #endif
@@ -1531,6 +1534,7 @@
 #define UI_TEXT_POWER            "Zapnout ATX zdroj"
 #define UI_TEXT_STRING_HM_DEADTIME     "Dead Time"
 #define UI_TEXT_STRING_HM_SLOWBANG     "SlowBang"
+#define UI_TEXT_STRING_HM_MODEL        "Model"
 #define UI_TEXT_STOP_PRINT "Zastavit tisk"
 
 #endif
@@ -1705,6 +1709,7 @@
 #define UI_TEXT_POWER            "ATX power on/off"
 #define UI_TEXT_STRING_HM_DEADTIME     "Dead Time"
 #define UI_TEXT_STRING_HM_SLOWBANG     "SlowBang"
+#define UI_TEXT_STRING_HM_MODEL        "Model"
 #define UI_TEXT_STOP_PRINT "Stop Print"
 
 #endif
@@ -24,6 +24,8 @@
 const int sensitive_pins[] PROGMEM = SENSITIVE_PINS; // Sensitive pin list for M42
 int Commands::lowestRAMValue = MAX_RAM;
 int Commands::lowestRAMValueSend = MAX_RAM;
+millis_t Commands::statisticsInterval = 0;
+millis_t Commands::lastStatistics = 0;
 
 void Commands::commandLoop()
 {
@@ -35,6 +37,11 @@ void Commands::commandLoop()
 
         GCode::readFromSerial();
         GCode *code = GCode::peekCurrentCommand();
+#if MOTION_STREAM
+        // Not in readFromSerial, which also runs while commands wait
+        if(!code && sd.sdmode && sd.motionStream)
+            sd.feedMotionStream();
+#endif
         //UI_SLOW; // do longer timed user interface action
         UI_MEDIUM; // do check encoder
         if(code)
@@ -65,9 +72,29 @@ void Commands::commandLoop()
 
 void Commands::checkForPeriodicalActions()
 {
+#if CPU_ARCH==ARCH_HOST
+    HAL::simulateInterrupts(); // Host simulator runs the timers while we wait
+#endif
+#if STEP_EVENT_RING
+    PrintLine::fillStepRing();
+#endif
+#if DELTA_LAZY_SEGMENTS
+    PrintLine::fillDeltaSegments();
+#endif
+#if SD_READ_AHEAD
+    sd.fillReadAhead();
+#endif
+#if SD_DIR_INDEX
+    sd.fillDirIndex();
+#endif
     if(!executePeriodical) return;
     executePeriodical=0;
     Extruder::manageTemperatures();
+    if(statisticsInterval && HAL::timeInMilliseconds() - lastStatistics >= statisticsInterval)
+    {
+        lastStatistics = HAL::timeInMilliseconds();
+        printQueueStatistics();
+    }
     if(--counter250ms==0)
     {
         if(manageMonitor<=1+NUM_EXTRUDER)
@@ -144,6 +171,27 @@ void Commands::printCurrentPosition()
     //Com::printF(PSTR("OffX:"),Printer::offsetX); // to debug offset handling
     //Com::printFLN(PSTR(" OffY:"),Printer::offsetY);
 }
+/** Reports why a print may have slowed down (M539): how often the move queue ran
+empty, moves slowed down for a low queue, the planner depth, the longest stepper
+interrupt and lost serial bytes / late SD blocks. */
+void Commands::printQueueStatistics()
+{
+    Com::printF(PSTR("Queue empty:"),(long)PrintLine::queueEmptyEvents);
+    Com::printF(PSTR(" slowed:"),(long)PrintLine::cacheLowSlowdowns);
+    Com::printF(PSTR(" replan max:"),(int)PrintLine::maxReplanned);
+    Com::printF(PSTR(" avg:"),PrintLine::plannerUpdates ? (float)PrintLine::replannedLines / (float)PrintLine::plannerUpdates : 0.0f,2);
+    Com::printF(PSTR(" ISR max us:"),(float)PrintLine::maxStepTicks * (1000000.0f / (float)F_CPU),1);
+#if STEP_EVENT_RING
+    Com::printF(PSTR(" step ring underruns:"),(long)PrintLine::stepRingUnderruns);
+#endif
+#ifdef SERIAL_RX_RING
+    Com::printF(PSTR(" RX overflows:"),(long)HAL::serialRxOverflows());
+#endif
+#if SD_READ_AHEAD
+    Com::printF(PSTR(" SD underruns:"),(long)sd.readAheadUnderruns);
+#endif
+    Com::println();
+}
 void Commands::printTemperatures(bool showRaw)
 {
     float temp = Extruder::current->tempControl.currentTemperatureC;
@@ -426,6 +474,9 @@ void microstepInit()
 void Commands::executeGCode(GCode *com)
 {
     uint32_t codenum; //throw away variable
+#if CPU_ARCH==ARCH_HOST
+    if(HAL::motionStream) HAL::motionStreamCommand(com); // -M converts the input to a motion stream
+#endif
 #ifdef INCLUDE_DEBUG_COMMUNICATION
     if(Printer::debugCommunication())
     {
@@ -1080,8 +1131,20 @@ void Commands::executeGCode(GCode *com)
             int cont = 0;
             if(com->hasS()) temp = com->S;
             if(com->hasP()) cont = com->P;
-            if(cont>=NUM_TEMPERATURE_LOOPS) cont = NUM_TEMPERATURE_LOOPS;
+            if(cont>=NUM_TEMPERATURE_LOOPS) cont = NUM_TEMPERATURE_LOOPS-1;
             tempController[cont]->autotunePID(temp,cont,com->hasX());
+#endif
+        }
+        break;
+        case 306: // Measure heater model for heat manager 4
+        {
+#if defined(TEMP_PID) && NUM_EXTRUDER>0
+            int temp = 200;
+            int cont = 0;
+            if(com->hasS()) temp = com->S;
+            if(com->hasP()) cont = com->P;
+            if(cont>=NUM_EXTRUDER) cont = NUM_EXTRUDER-1;
+            tempController[cont]->autotuneModel(temp,cont,com->hasX());
 #endif
         }
         break;
@@ -1458,7 +1521,7 @@ void Commands::executeGCode(GCode *com)
 #endif
 #ifdef DEBUG_QUEUE_MOVE
         case 533: // Write move data
-            Com::printF(PSTR("Buf:"),(int)PrintLine::linesCount);
+            Com::printF(PSTR("Buf:"),(int)PrintLine::queuedLines());
             Com::printF(PSTR(",LP:"),(int)PrintLine::linesPos);
             Com::printFLN(PSTR(",WP:"),(int)PrintLine::linesWritePos);
             if(PrintLine::cur == NULL) {
@@ -1490,6 +1553,77 @@ void Commands::executeGCode(GCode *com)
                 Printer::maxRealJerk = 0;
             break;
 #endif
+#if STEP_EVENT_RING
+        case 536: // Step event ring statistics, S resets them
+            Com::printF(PSTR("Step ring underruns:"),(long)PrintLine::stepRingUnderruns);
+            Com::printF(PSTR(" min. fill:"),(int)PrintLine::stepRingMinFill);
+            Com::printFLN(PSTR(" size:"),(int)STEP_EVENT_RING_SIZE);
+            if(com->hasS())
+            {
+                PrintLine::stepRingUnderruns = 0;
+                PrintLine::stepRingMinFill = STEP_EVENT_RING_SIZE;
+            }
+            break;
+#elif DELTA_LAZY_SEGMENTS
+        case 536: // Delta segment ring statistics, S resets them
+            Com::printF(PSTR("Delta segment underruns:"),(long)PrintLine::deltaRingUnderruns);
+            Com::printF(PSTR(" min. fill:"),(int)PrintLine::deltaRingMinFill);
+            Com::printFLN(PSTR(" size:"),(int)DELTA_LAZY_SEGMENTS_BUFFER);
+            if(com->hasS())
+            {
+                PrintLine::deltaRingUnderruns = 0;
+                PrintLine::deltaRingMinFill = DELTA_LAZY_SEGMENTS_BUFFER;
+            }
+            break;
+#endif
+#ifdef SERIAL_RX_RING
+        case 537: // Serial receive buffer statistics, S resets them
+            Com::printF(PSTR("Serial RX overflows:"),(long)HAL::serialRxOverflows());
+            Com::printF(PSTR(" high water:"),(long)HAL::serialRxHighWater());
+            Com::printFLN(PSTR(" size:"),(long)SERIAL_RX_BUFFER_SIZE);
+            if(com->hasS())
+                HAL::serialRxResetStatistics();
+            break;
+#endif
+#if SD_READ_AHEAD
+        case 538: // SD read ahead statistics, S resets them
+            Com::printF(PSTR("SD read ahead underruns:"),(long)sd.readAheadUnderruns);
+            Com::printF(PSTR(" blocks:"),(long)sd.readAheadBlocks);
+            Com::printF(PSTR(" streams:"),(long)sd.readAheadStreams);
+            Com::printFLN(PSTR(" buffers:"),(int)SD_READ_AHEAD);
+            if(com->hasS())
+                sd.readAheadUnderruns = sd.readAheadBlocks = sd.readAheadStreams = 0;
+            break;
+#endif
+        case 539: // Move queue statistics, S resets them, P<seconds> reports them periodically
+            if(com->hasP())
+            {
+                statisticsInterval = (millis_t)com->P * 1000;
+                lastStatistics = HAL::timeInMilliseconds();
+            }
+            printQueueStatistics();
+            if(com->hasS())
+            {
+                BEGIN_INTERRUPT_PROTECTED
+                PrintLine::queueEmptyEvents = PrintLine::cacheLowSlowdowns = 0;
+                PrintLine::plannerUpdates = PrintLine::replannedLines = 0;
+                PrintLine::maxReplanned = 0;
+                PrintLine::maxStepTicks = 0;
+                END_INTERRUPT_PROTECTED
+#ifdef SERIAL_RX_RING
+                HAL::serialRxResetStatistics();
+#endif
+#if SD_READ_AHEAD
+                sd.readAheadUnderruns = 0;
+#endif
+            }
+            break;
+        case 576: // M576 S1 - ok with free command buffer places for streaming hosts
+            if(com->hasS())
+                GCode::okWindow = com->S != 0;
+            Com::printF(PSTR("OkWindow:"),(int)GCode::okWindow);
+            Com::printFLN(PSTR(" size:"),(int)GCODE_BUFFER_SIZE);
+            break;
 /*        case 535:
             Com::printF(PSTR("Last commanded position:"),Printer::lastCmdPos[X_AXIS]);
             Com::printF(Com::tComma,Printer::lastCmdPos[Y_AXIS]);
@@ -1534,6 +1668,7 @@ void Commands::emergencyStop()
     for(uint8_t i=0; i<NUM_EXTRUDER+3; i++)
         pwm_pos[i] = 0;
     pwm_pos[0] = pwm_pos[NUM_EXTRUDER] = pwm_pos[NUM_EXTRUDER+1] = pwm_pos[NUM_EXTRUDER+2]=0;
+    HAL::hardwarePwmOff(); // the pwm interrupt is blocked, so disconnect the timers before writing the pins
 #if EXT0_HEATER_PIN>-1
     WRITE(EXT0_HEATER_PIN,HEATER_PINS_INVERTED);
 #endif
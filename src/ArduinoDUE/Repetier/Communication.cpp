@@ -21,13 +21,18 @@
 
 #include "Repetier.h"
 
+#if BINARY_PROTOCOL_V3
+#define REPETIER_PROTOCOL_VERSION "3"
+#else
+#define REPETIER_PROTOCOL_VERSION "2"
+#endif
 #if DRIVE_SYSTEM==3
-FSTRINGVALUE(Com::tFirmware,"FIRMWARE_NAME:Repetier_" REPETIER_VERSION " FIRMWARE_URL:https://github.com/repetier/Repetier-Firmware/ PROTOCOL_VERSION:1.0 MACHINE_TYPE:Delta EXTRUDER_COUNT:" XSTR(NUM_EXTRUDER) " REPETIER_PROTOCOL:2")
+FSTRINGVALUE(Com::tFirmware,"FIRMWARE_NAME:Repetier_" REPETIER_VERSION " FIRMWARE_URL:https://github.com/repetier/Repetier-Firmware/ PROTOCOL_VERSION:1.0 MACHINE_TYPE:Delta EXTRUDER_COUNT:" XSTR(NUM_EXTRUDER) " REPETIER_PROTOCOL:" REPETIER_PROTOCOL_VERSION)
 #else
 #if DRIVE_SYSTEM==0
-FSTRINGVALUE(Com::tFirmware,"FIRMWARE_NAME:Repetier_" REPETIER_VERSION " FIRMWARE_URL:https://github.com/repetier/Repetier-Firmware/ PROTOCOL_VERSION:1.0 MACHINE_TYPE:Mendel EXTRUDER_COUNT:" XSTR(NUM_EXTRUDER) " REPETIER_PROTOCOL:2")
+FSTRINGVALUE(Com::tFirmware,"FIRMWARE_NAME:Repetier_" REPETIER_VERSION " FIRMWARE_URL:https://github.com/repetier/Repetier-Firmware/ PROTOCOL_VERSION:1.0 MACHINE_TYPE:Mendel EXTRUDER_COUNT:" XSTR(NUM_EXTRUDER) " REPETIER_PROTOCOL:" REPETIER_PROTOCOL_VERSION)
 #else
-FSTRINGVALUE(Com::tFirmware,"FIRMWARE_NAME:Repetier_" REPETIER_VERSION " FIRMWARE_URL:https://github.com/repetier/Repetier-Firmware/ PROTOCOL_VERSION:1.0 MACHINE_TYPE:Core_XY EXTRUDER_COUNT:" XSTR(NUM_EXTRUDER) " REPETIER_PROTOCOL:2")
+FSTRINGVALUE(Com::tFirmware,"FIRMWARE_NAME:Repetier_" REPETIER_VERSION " FIRMWARE_URL:https://github.com/repetier/Repetier-Firmware/ PROTOCOL_VERSION:1.0 MACHINE_TYPE:Core_XY EXTRUDER_COUNT:" XSTR(NUM_EXTRUDER) " REPETIER_PROTOCOL:" REPETIER_PROTOCOL_VERSION)
 #endif
 #endif
 FSTRINGVALUE(Com::tDebug,"Debug:");
@@ -162,6 +167,16 @@ FSTRINGVALUE(Com::tAPIDKd," Kd: ")
 FSTRINGVALUE(Com::tAPIDFailedHigh,"PID Autotune failed! Temperature to high")
 FSTRINGVALUE(Com::tAPIDFailedTimeout,"PID Autotune failed! timeout")
 FSTRINGVALUE(Com::tAPIDFinished,"PID Autotune finished ! Place the Kp, Ki and Kd constants in the Configuration.h or EEPROM")
+FSTRINGVALUE(Com::tAutotuneStopped,"Autotune stopped by a new target temperature")
+FSTRINGVALUE(Com::tMPCAutotuneStart,"Model autotune start")
+FSTRINGVALUE(Com::tMPCHeatCapacity," heat capacity [J/K]: ")
+FSTRINGVALUE(Com::tMPCAmbientLoss," ambient loss [W/K]: ")
+FSTRINGVALUE(Com::tMPCSensorResponse," sensor response [1/s]: ")
+FSTRINGVALUE(Com::tMPCFailedCurve,"Model autotune failed! Heating curve not usable")
+FSTRINGVALUE(Com::tMPCFailedTimeout,"Model autotune failed! timeout")
+FSTRINGVALUE(Com::tMPCFailedHigh,"Model autotune failed! Temperature too high")
+FSTRINGVALUE(Com::tMPCFailedNoRise,"Model autotune failed! Temperature not rising")
+FSTRINGVALUE(Com::tMPCFinished,"Model autotune finished ! Place the values in the Configuration.h or EEPROM")
 FSTRINGVALUE(Com::tMTEMPColon,"MTEMP:")
 FSTRINGVALUE(Com::tHeatedBed,"heated bed")
 FSTRINGVALUE(Com::tExtruderSpace,"extruder ")
@@ -323,7 +338,7 @@ FSTRINGVALUE(Com::tEPRStepsPerMM,"steps per mm")
 FSTRINGVALUE(Com::tEPRMaxFeedrate,"max. feedrate [mm/s]")
 FSTRINGVALUE(Com::tEPRStartFeedrate,"start feedrate [mm/s]")
 FSTRINGVALUE(Com::tEPRAcceleration,"acceleration [mm/s^2]")
-FSTRINGVALUE(Com::tEPRHeatManager,"heat manager [0-3]")
+FSTRINGVALUE(Com::tEPRHeatManager,"heat manager [0-4]")
 FSTRINGVALUE(Com::tEPRDriveMax,"PID drive max")
 FSTRINGVALUE(Com::tEPRDriveMin,"PID drive min")
 FSTRINGVALUE(Com::tEPRPGain,"PID P-gain/dead-time")
@@ -338,6 +353,11 @@ FSTRINGVALUE(Com::tEPRDistanceRetractHeating,"distance to retract when heating [
 FSTRINGVALUE(Com::tEPRExtruderCoolerSpeed,"extruder cooler speed [0-255]")
 FSTRINGVALUE(Com::tEPRAdvanceK,"advance K [0=off]")
 FSTRINGVALUE(Com::tEPRAdvanceL,"advance L [0=off]")
+FSTRINGVALUE(Com::tEPRMPCHeaterPower,"model heater power [W]")
+FSTRINGVALUE(Com::tEPRMPCHeatCapacity,"model heat capacity [J/K]")
+FSTRINGVALUE(Com::tEPRMPCAmbientLoss,"model ambient loss [W/K]")
+FSTRINGVALUE(Com::tEPRMPCSensorResponse,"model sensor response [1/s]")
+FSTRINGVALUE(Com::tEPRMPCFilamentHeat,"model filament heat [J/(mm*K)]")
 
 #endif
 #if SDSUPPORT
@@ -412,7 +432,7 @@ void Com::printF(FSTRINGPARAM(text),int value) {
     printF(text);
     print(value);
 }
-void Com::printF(FSTRINGPARAM(text),int32_t value) {
+void Com::printF(FSTRINGPARAM(text),long value) {
     printF(text);
     print(value);
 }
@@ -425,7 +445,7 @@ void Com::printFLN(FSTRINGPARAM(text),int value) {
     print(value);
     println();
 }
-void Com::printFLN(FSTRINGPARAM(text),int32_t value) {
+void Com::printFLN(FSTRINGPARAM(text),long value) {
     printF(text);
     print(value);
     println();
@@ -476,7 +496,7 @@ void Com::printArrayFLN(FSTRINGPARAM(text),float *arr,uint8_t n,uint8_t digits)
         printF(Com::tSpace,arr[i],digits);
     println();
 }
-void Com::printArrayFLN(FSTRINGPARAM(text),int32_t *arr,uint8_t n) {
+void Com::printArrayFLN(FSTRINGPARAM(text),long *arr,uint8_t n) {
     printF(text);
     for(uint8_t i=0; i<n; i++)
         printF(Com::tSpace,arr[i]);
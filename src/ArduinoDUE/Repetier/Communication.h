@@ -162,6 +162,16 @@ FSTRINGVAR(tAPIDKd)
 FSTRINGVAR(tAPIDFailedHigh)
 FSTRINGVAR(tAPIDFailedTimeout)
 FSTRINGVAR(tAPIDFinished)
+FSTRINGVAR(tAutotuneStopped)
+FSTRINGVAR(tMPCAutotuneStart)
+FSTRINGVAR(tMPCHeatCapacity)
+FSTRINGVAR(tMPCAmbientLoss)
+FSTRINGVAR(tMPCSensorResponse)
+FSTRINGVAR(tMPCFailedCurve)
+FSTRINGVAR(tMPCFailedTimeout)
+FSTRINGVAR(tMPCFailedHigh)
+FSTRINGVAR(tMPCFailedNoRise)
+FSTRINGVAR(tMPCFinished)
 FSTRINGVAR(tMTEMPColon)
 FSTRINGVAR(tHeatedBed)
 FSTRINGVAR(tExtruderSpace)
@@ -326,6 +336,11 @@ FSTRINGVAR(tEPRDistanceRetractHeating)
 FSTRINGVAR(tEPRExtruderCoolerSpeed)
 FSTRINGVAR(tEPRAdvanceK)
 FSTRINGVAR(tEPRAdvanceL)
+FSTRINGVAR(tEPRMPCHeaterPower)
+FSTRINGVAR(tEPRMPCHeatCapacity)
+FSTRINGVAR(tEPRMPCAmbientLoss)
+FSTRINGVAR(tEPRMPCSensorResponse)
+FSTRINGVAR(tEPRMPCFilamentHeat)
 #endif
 #if SDSUPPORT
 FSTRINGVAR(tSDRemoved)
@@ -363,11 +378,11 @@ static void printFLN(FSTRINGPARAM(text));
 static void printF(FSTRINGPARAM(text));
 static void printF(FSTRINGPARAM(text),int value);
 static void printF(FSTRINGPARAM(text),const char *msg);
-static void printF(FSTRINGPARAM(text),int32_t value);
+static void printF(FSTRINGPARAM(text),long value);
 static void printF(FSTRINGPARAM(text),uint32_t value);
 static void printF(FSTRINGPARAM(text),float value,uint8_t digits=2);
 static void printFLN(FSTRINGPARAM(text),int value);
-static void printFLN(FSTRINGPARAM(text),int32_t value);
+static void printFLN(FSTRINGPARAM(text),long value);
 static void printFLN(FSTRINGPARAM(text),uint32_t value);
 static void printFLN(FSTRINGPARAM(text),const char *msg);
 static void printFLN(FSTRINGPARAM(text),float value,uint8_t digits=2);
@@ -375,7 +390,7 @@ static void printArrayFLN(FSTRINGPARAM(text),float *arr,uint8_t n=4,uint8_t digi
 static void printArrayFLN(FSTRINGPARAM(text),long *arr,uint8_t n=4);
 static void print(long value);
 static inline void print(uint32_t value) {printNumber(value);}
-static inline void print(int value) {print((int32_t)value);}
+static inline void print(int value) {print((long)value);}
 static void print(const char *text);
 static inline void print(char c) {HAL::serialWriteByte(c);}
 static void printFloat(float number, uint8_t digits);
@@ -118,6 +118,11 @@ void EEPROM::restoreEEPROMSettingsFromConfiguration()
     e->tempControl.pidIGain = EXT0_PID_I;
     e->tempControl.pidDGain = EXT0_PID_D;
     e->tempControl.pidMax = EXT0_PID_MAX;
+    e->tempControl.mpcHeaterPower = EXT0_MPC_HEATER_POWER;
+    e->tempControl.mpcHeatCapacity = EXT0_MPC_HEAT_CAPACITY;
+    e->tempControl.mpcAmbientLoss = EXT0_MPC_AMBIENT_LOSS;
+    e->tempControl.mpcSensorResponse = EXT0_MPC_SENSOR_RESPONSE;
+    e->tempControl.mpcFilamentHeat = EXT0_MPC_FILAMENT_HEAT;
 #endif
     e->yOffset = EXT0_Y_OFFSET;
     e->xOffset = EXT0_X_OFFSET;
@@ -148,6 +153,11 @@ void EEPROM::restoreEEPROMSettingsFromConfiguration()
     e->tempControl.pidIGain = EXT1_PID_I;
     e->tempControl.pidDGain = EXT1_PID_D;
     e->tempControl.pidMax = EXT1_PID_MAX;
+    e->tempControl.mpcHeaterPower = EXT1_MPC_HEATER_POWER;
+    e->tempControl.mpcHeatCapacity = EXT1_MPC_HEAT_CAPACITY;
+    e->tempControl.mpcAmbientLoss = EXT1_MPC_AMBIENT_LOSS;
+    e->tempControl.mpcSensorResponse = EXT1_MPC_SENSOR_RESPONSE;
+    e->tempControl.mpcFilamentHeat = EXT1_MPC_FILAMENT_HEAT;
 #endif
     e->yOffset = EXT1_Y_OFFSET;
     e->xOffset = EXT1_X_OFFSET;
@@ -178,6 +188,11 @@ void EEPROM::restoreEEPROMSettingsFromConfiguration()
     e->tempControl.pidIGain = EXT2_PID_I;
     e->tempControl.pidDGain = EXT2_PID_D;
     e->tempControl.pidMax = EXT2_PID_MAX;
+    e->tempControl.mpcHeaterPower = EXT2_MPC_HEATER_POWER;
+    e->tempControl.mpcHeatCapacity = EXT2_MPC_HEAT_CAPACITY;
+    e->tempControl.mpcAmbientLoss = EXT2_MPC_AMBIENT_LOSS;
+    e->tempControl.mpcSensorResponse = EXT2_MPC_SENSOR_RESPONSE;
+    e->tempControl.mpcFilamentHeat = EXT2_MPC_FILAMENT_HEAT;
 #endif
     e->yOffset = EXT2_Y_OFFSET;
     e->xOffset = EXT2_X_OFFSET;
@@ -208,6 +223,11 @@ void EEPROM::restoreEEPROMSettingsFromConfiguration()
     e->tempControl.pidIGain = EXT3_PID_I;
     e->tempControl.pidDGain = EXT3_PID_D;
     e->tempControl.pidMax = EXT3_PID_MAX;
+    e->tempControl.mpcHeaterPower = EXT3_MPC_HEATER_POWER;
+    e->tempControl.mpcHeatCapacity = EXT3_MPC_HEAT_CAPACITY;
+    e->tempControl.mpcAmbientLoss = EXT3_MPC_AMBIENT_LOSS;
+    e->tempControl.mpcSensorResponse = EXT3_MPC_SENSOR_RESPONSE;
+    e->tempControl.mpcFilamentHeat = EXT3_MPC_FILAMENT_HEAT;
 #endif
     e->yOffset = EXT3_Y_OFFSET;
     e->xOffset = EXT3_X_OFFSET;
@@ -238,6 +258,11 @@ void EEPROM::restoreEEPROMSettingsFromConfiguration()
     e->tempControl.pidIGain = EXT4_PID_I;
     e->tempControl.pidDGain = EXT4_PID_D;
     e->tempControl.pidMax = EXT4_PID_MAX;
+    e->tempControl.mpcHeaterPower = EXT4_MPC_HEATER_POWER;
+    e->tempControl.mpcHeatCapacity = EXT4_MPC_HEAT_CAPACITY;
+    e->tempControl.mpcAmbientLoss = EXT4_MPC_AMBIENT_LOSS;
+    e->tempControl.mpcSensorResponse = EXT4_MPC_SENSOR_RESPONSE;
+    e->tempControl.mpcFilamentHeat = EXT4_MPC_FILAMENT_HEAT;
 #endif
     e->yOffset = EXT4_Y_OFFSET;
     e->xOffset = EXT4_X_OFFSET;
@@ -268,6 +293,11 @@ void EEPROM::restoreEEPROMSettingsFromConfiguration()
     e->tempControl.pidIGain = EXT5_PID_I;
     e->tempControl.pidDGain = EXT5_PID_D;
     e->tempControl.pidMax = EXT5_PID_MAX;
+    e->tempControl.mpcHeaterPower = EXT5_MPC_HEATER_POWER;
+    e->tempControl.mpcHeatCapacity = EXT5_MPC_HEAT_CAPACITY;
+    e->tempControl.mpcAmbientLoss = EXT5_MPC_AMBIENT_LOSS;
+    e->tempControl.mpcSensorResponse = EXT5_MPC_SENSOR_RESPONSE;
+    e->tempControl.mpcFilamentHeat = EXT5_MPC_FILAMENT_HEAT;
 #endif
     e->yOffset = EXT5_Y_OFFSET;
     e->xOffset = EXT5_X_OFFSET;
@@ -388,6 +418,11 @@ void EEPROM::storeDataIntoEEPROM(uint8_t corrupted)
         HAL::eprSetFloat(o+EPR_EXTRUDER_PID_IGAIN,e->tempControl.pidIGain);
         HAL::eprSetFloat(o+EPR_EXTRUDER_PID_DGAIN,e->tempControl.pidDGain);
         HAL::eprSetByte(o+EPR_EXTRUDER_PID_MAX,e->tempControl.pidMax);
+        HAL::eprSetFloat(o+EPR_EXTRUDER_MPC_HEATER_POWER,e->tempControl.mpcHeaterPower);
+        HAL::eprSetFloat(o+EPR_EXTRUDER_MPC_HEAT_CAPACITY,e->tempControl.mpcHeatCapacity);
+        HAL::eprSetFloat(o+EPR_EXTRUDER_MPC_AMBIENT_LOSS,e->tempControl.mpcAmbientLoss);
+        HAL::eprSetFloat(o+EPR_EXTRUDER_MPC_SENSOR_RESPONSE,e->tempControl.mpcSensorResponse);
+        HAL::eprSetFloat(o+EPR_EXTRUDER_MPC_FILAMENT_HEAT,e->tempControl.mpcFilamentHeat);
 #endif
         HAL::eprSetInt32(o+EPR_EXTRUDER_X_OFFSET,e->xOffset);
         HAL::eprSetInt32(o+EPR_EXTRUDER_Y_OFFSET,e->yOffset);
@@ -543,6 +578,14 @@ void EEPROM::readDataFromEEPROM()
         e->tempControl.pidIGain = HAL::eprGetFloat(o+EPR_EXTRUDER_PID_IGAIN);
         e->tempControl.pidDGain = HAL::eprGetFloat(o+EPR_EXTRUDER_PID_DGAIN);
         e->tempControl.pidMax = HAL::eprGetByte(o+EPR_EXTRUDER_PID_MAX);
+        if(version>7)   // older versions keep the values from Configuration.h
+        {
+            e->tempControl.mpcHeaterPower = HAL::eprGetFloat(o+EPR_EXTRUDER_MPC_HEATER_POWER);
+            e->tempControl.mpcHeatCapacity = HAL::eprGetFloat(o+EPR_EXTRUDER_MPC_HEAT_CAPACITY);
+            e->tempControl.mpcAmbientLoss = HAL::eprGetFloat(o+EPR_EXTRUDER_MPC_AMBIENT_LOSS);
+            e->tempControl.mpcSensorResponse = HAL::eprGetFloat(o+EPR_EXTRUDER_MPC_SENSOR_RESPONSE);
+            e->tempControl.mpcFilamentHeat = HAL::eprGetFloat(o+EPR_EXTRUDER_MPC_FILAMENT_HEAT);
+        }
 #endif
         e->xOffset = HAL::eprGetInt32(o+EPR_EXTRUDER_X_OFFSET);
         e->yOffset = HAL::eprGetInt32(o+EPR_EXTRUDER_Y_OFFSET);
@@ -796,6 +839,11 @@ void EEPROM::writeSettings()
         writeFloat(o+EPR_EXTRUDER_PID_IGAIN,Com::tEPRIGain,4);
         writeFloat(o+EPR_EXTRUDER_PID_DGAIN,Com::tEPRDGain,4);
         writeByte(o+EPR_EXTRUDER_PID_MAX,Com::tEPRPIDMaxValue);
+        writeFloat(o+EPR_EXTRUDER_MPC_HEATER_POWER,Com::tEPRMPCHeaterPower);
+        writeFloat(o+EPR_EXTRUDER_MPC_HEAT_CAPACITY,Com::tEPRMPCHeatCapacity);
+        writeFloat(o+EPR_EXTRUDER_MPC_AMBIENT_LOSS,Com::tEPRMPCAmbientLoss,4);
+        writeFloat(o+EPR_EXTRUDER_MPC_SENSOR_RESPONSE,Com::tEPRMPCSensorResponse,4);
+        writeFloat(o+EPR_EXTRUDER_MPC_FILAMENT_HEAT,Com::tEPRMPCFilamentHeat,4);
 #endif
         writeLong(o+EPR_EXTRUDER_X_OFFSET,Com::tEPRXOffset);
         writeLong(o+EPR_EXTRUDER_Y_OFFSET,Com::tEPRYOffset);
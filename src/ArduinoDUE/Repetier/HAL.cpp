@@ -34,6 +34,36 @@ extern long bresenham_step();
 
 char HAL::virtualEeprom[EEPROM_BYTES];  
 volatile uint8_t HAL::insideTimer1=0;
+#ifdef SERIAL_RX_RING
+uint8_t HAL::serialRxBuffer[SERIAL_RX_BUFFER_SIZE];
+volatile uint16_t HAL::serialRxHead = 0;
+volatile uint16_t HAL::serialRxTailPos = 0;
+uint32_t HAL::serialRxOverflowCount = 0;
+uint16_t HAL::serialRxHighWaterMark = 0;
+#endif
+
+/** sqrt((i + 16.5) * 2^26), seeds for the normalised argument of integerSqrt. */
+static const uint16_t sqrtSeed[48] =
+{
+    33276, 34270, 35235, 36175, 37091, 37985, 38858, 39712,
+    40548, 41368, 42171, 42959, 43733, 44494, 45242, 45977,
+    46702, 47415, 48117, 48809, 49492, 50166, 50830, 51486,
+    52134, 52773, 53405, 54030, 54647, 55258, 55862, 56459,
+    57051, 57636, 58215, 58789, 59357, 59919, 60477, 61029,
+    61576, 62119, 62657, 63190, 63719, 64243, 64763, 65279
+};
+
+uint32_t HAL::integerSqrt(uint32_t a)
+{
+    if(a == 0) return 0;
+    uint8_t shift = __builtin_clz(a) & 30; // even, so the root shifts by half of it
+    uint32_t r = sqrtSeed[((a << shift) >> 26) - 16] >> (shift >> 1);
+    r = (r + a / r) >> 1;
+    r = (r + a / r) >> 1; // >= floor(sqrt(a)), off by at most one
+    if(static_cast<uint64_t>(r) * r > a) r--;
+    if(a - r * r > r) r++; // a >= (r + 0.5)^2
+    return r;
+}
 #ifndef DUE_SOFTWARE_SPI
     int spiDueDividors[] = {10,21,42,84,168,255,255};
 #endif
@@ -95,6 +125,10 @@ void HAL::setupTimer() {
 
     // Timer for stepper motor control
     pmc_enable_periph_clk(TIMER1_TIMER_IRQ );
+    // cycle counter for the interrupt duration reported by M539
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
     NVIC_SetPriority((IRQn_Type)TIMER1_TIMER_IRQ, NVIC_EncodePriority(4, 1, 0));
       
     TC_Configure(TIMER1_TIMER, TIMER1_TIMER_CHANNEL, TC_CMR_WAVSEL_UP_RC | 
@@ -107,6 +141,85 @@ void HAL::setupTimer() {
     TIMER1_TIMER->TC_CHANNEL[TIMER1_TIMER_CHANNEL].TC_IDR = ~TC_IER_CPCS;
     NVIC_EnableIRQ((IRQn_Type)TIMER1_TIMER_IRQ); 
 
+#if HARDWARE_PWM
+    // Heater and fan outputs on pwm controller pins, the pwm interrupt only sets their duty cycle
+#if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1
+#if HW_PWM(EXT0_HEATER_PIN)
+    HW_PWM_START(EXT0_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1
+#if HW_PWM(EXT1_HEATER_PIN)
+    HW_PWM_START(EXT1_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2
+#if HW_PWM(EXT2_HEATER_PIN)
+    HW_PWM_START(EXT2_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3
+#if HW_PWM(EXT3_HEATER_PIN)
+    HW_PWM_START(EXT3_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4
+#if HW_PWM(EXT4_HEATER_PIN)
+    HW_PWM_START(EXT4_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5
+#if HW_PWM(EXT5_HEATER_PIN)
+    HW_PWM_START(EXT5_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if HEATED_BED_HEATER_PIN>-1 && HAVE_HEATED_BED
+#if HW_PWM(HEATED_BED_HEATER_PIN)
+    HW_PWM_START(HEATED_BED_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
+#endif
+#if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1 && EXT0_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT0_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT0_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1 && EXT1_EXTRUDER_COOLER_PIN>-1 && EXT1_EXTRUDER_COOLER_PIN!=EXT0_EXTRUDER_COOLER_PIN
+#if HW_PWM(EXT1_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT1_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2 && EXT2_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT2_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT2_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3 && EXT3_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT3_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT3_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4 && EXT4_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT4_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT4_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5 && EXT5_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT5_EXTRUDER_COOLER_PIN)
+    HW_PWM_START(EXT5_EXTRUDER_COOLER_PIN,0);
+#endif
+#endif
+#if FAN_BOARD_PIN>-1
+#if HW_PWM(FAN_BOARD_PIN)
+    HW_PWM_START(FAN_BOARD_PIN,0);
+#endif
+#endif
+#if FAN_PIN>-1 && FEATURE_FAN_CONTROL
+#if HW_PWM(FAN_PIN)
+    HW_PWM_START(FAN_PIN,0);
+#endif
+#endif
+#endif
+
     // Servo control
 #if FEATURE_SERVO
 #if SERVO0_PIN>-1
@@ -143,6 +256,13 @@ void HAL::setupTimer() {
 
 
 #if ANALOG_INPUTS>0
+#if ANALOG_INTERRUPT_SAMPLING
+// The PDC fills the buffers alternately, each with 2^ANALOG_INPUT_SAMPLE scans of all channels
+#define ADC_PDC_SAMPLES (ANALOG_INPUTS << ANALOG_INPUT_SAMPLE)
+static uint16_t adcPdcBuffer[2][ADC_PDC_SAMPLES];
+static uint8_t adcPdcFilled = 0; // buffer the PDC completes next
+static uint8_t adcChannelInput[16]; // analog input of each ADC channel
+#endif
 // Initialize ADC channels
 void HAL::analogStart(void)
 {
@@ -160,6 +280,9 @@ void HAL::analogStart(void)
   // osAnalogInputChannels
       //adcEnable |= (0x1u << adcChannel[i]);
       adcEnable |= (0x1u << osAnalogInputChannels[i]);
+#if ANALOG_INTERRUPT_SAMPLING
+      adcChannelInput[osAnalogInputChannels[i]] = i;
+#endif
   }
 
   // enable channels
@@ -185,14 +308,143 @@ void HAL::analogStart(void)
   ADC->ADC_IER = 0;             // no ADC interrupts
   ADC->ADC_CGR = 0;             // Gain = 1
   ADC->ADC_COR = 0;             // Single-ended, no offset
+#if ANALOG_INTERRUPT_SAMPLING
+  // Scan the channels continuously, the PDC stores the results tagged with
+  // their channel number and the ADC interrupt adds up a full buffer
+  ADC->ADC_MR = (ADC->ADC_MR & ~ADC_MR_FREERUN) | ADC_MR_FREERUN_ON;
+  ADC->ADC_EMR = ADC_EMR_TAG;
+  ADC->ADC_RPR = (uint32_t)adcPdcBuffer[0];
+  ADC->ADC_RCR = ADC_PDC_SAMPLES;
+  ADC->ADC_RNPR = (uint32_t)adcPdcBuffer[1];
+  ADC->ADC_RNCR = ADC_PDC_SAMPLES;
+  ADC->ADC_PTCR = ADC_PTCR_RXTEN;
+  ADC->ADC_IER = ADC_IER_ENDRX;
+  NVIC_SetPriority(ADC_IRQn, NVIC_EncodePriority(4, 3, 1));
+  NVIC_EnableIRQ(ADC_IRQn);
+#endif
   
   // start first conversion
   ADC->ADC_CR = ADC_CR_START;
 }
 
+#if ANALOG_INTERRUPT_SAMPLING
+/** Called when the PDC filled a buffer. The PDC continues with the other
+buffer, the filled one becomes its successor after the sums are taken. */
+void ADC_Handler()
+{
+  if((ADC->ADC_ISR & ADC_ISR_ENDRX) == 0) return;
+  uint16_t *buf = adcPdcBuffer[adcPdcFilled];
+  uint sum[ANALOG_INPUTS];
+  for(uint8_t i = 0; i < ANALOG_INPUTS; i++)
+      sum[i] = 0;
+  for(uint16_t i = 0; i < ADC_PDC_SAMPLES; i++)
+      sum[adcChannelInput[buf[i] >> 12]] += buf[i] & 0xfff;
+  ADC->ADC_RNPR = (uint32_t)buf;
+  ADC->ADC_RNCR = ADC_PDC_SAMPLES; // clears ENDRX
+  adcPdcFilled ^= 1;
+  for(uint8_t i = 0; i < ANALOG_INPUTS; i++)
+      analogInputSample(i, sum[i]);
+}
+#endif
+
 #endif
 
 // Print apparent cause of start/restart
+/** Configures a pwm controller channel for pin with a period of 255*HW_PWM_STEP clocks
+of MCK/1024. An inverted channel starts each period high. */
+void HAL::hardwarePwmStart(uint8_t pin,uint32_t channel,bool inverted)
+{
+    pmc_enable_periph_clk(ID_PWM);
+    PWMC_DisableChannel(PWM, channel);
+    PWMC_ConfigureChannel(PWM, channel, PWM_CMR_CPRE_MCK_DIV_1024, 0, inverted ? PWM_CMR_CPOL : 0);
+    PWMC_SetPeriod(PWM, channel, 255 * HW_PWM_STEP);
+    PWMC_SetDutyCycle(PWM, channel, 0);
+    PWMC_EnableChannel(PWM, channel);
+    PIO_Configure(g_APinDescription[pin].pPort, g_APinDescription[pin].ulPinType,
+                  g_APinDescription[pin].ulPin, g_APinDescription[pin].ulPinConfiguration);
+}
+
+void HAL::hardwarePwmOff()
+{
+#if HARDWARE_PWM
+#if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1
+#if HW_PWM(EXT0_HEATER_PIN)
+    HW_PWM_STOP(EXT0_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1
+#if HW_PWM(EXT1_HEATER_PIN)
+    HW_PWM_STOP(EXT1_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2
+#if HW_PWM(EXT2_HEATER_PIN)
+    HW_PWM_STOP(EXT2_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3
+#if HW_PWM(EXT3_HEATER_PIN)
+    HW_PWM_STOP(EXT3_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4
+#if HW_PWM(EXT4_HEATER_PIN)
+    HW_PWM_STOP(EXT4_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5
+#if HW_PWM(EXT5_HEATER_PIN)
+    HW_PWM_STOP(EXT5_HEATER_PIN);
+#endif
+#endif
+#if HEATED_BED_HEATER_PIN>-1 && HAVE_HEATED_BED
+#if HW_PWM(HEATED_BED_HEATER_PIN)
+    HW_PWM_STOP(HEATED_BED_HEATER_PIN);
+#endif
+#endif
+#if defined(EXT0_HEATER_PIN) && EXT0_HEATER_PIN>-1 && EXT0_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT0_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT0_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1 && EXT1_EXTRUDER_COOLER_PIN>-1 && EXT1_EXTRUDER_COOLER_PIN!=EXT0_EXTRUDER_COOLER_PIN
+#if HW_PWM(EXT1_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT1_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2 && EXT2_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT2_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT2_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3 && EXT3_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT3_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT3_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4 && EXT4_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT4_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT4_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5 && EXT5_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT5_EXTRUDER_COOLER_PIN)
+    HW_PWM_STOP(EXT5_EXTRUDER_COOLER_PIN);
+#endif
+#endif
+#if FAN_BOARD_PIN>-1
+#if HW_PWM(FAN_BOARD_PIN)
+    HW_PWM_STOP(FAN_BOARD_PIN);
+#endif
+#endif
+#if FAN_PIN>-1 && FEATURE_FAN_CONTROL
+#if HW_PWM(FAN_PIN)
+    HW_PWM_STOP(FAN_PIN);
+#endif
+#endif
+#endif
+}
+
 void HAL::showStartReason() {
     int mcu = (RSTC->RSTC_SR & RSTC_SR_RSTTYP_Msk) >> RSTC_SR_RSTTYP_Pos;
     switch (mcu){
@@ -669,9 +921,25 @@ void TIMER1_COMPA_VECTOR ()
     TC_GetStatus(TIMER1_TIMER, TIMER1_TIMER_CHANNEL);
     if(HAL::insideTimer1) return;
     HAL::insideTimer1 = 1;
+#if STEP_TIMING_QUEUE
+    if(PrintLine::hasQueuedSteps())
+    {
+        setTimer(PrintLine::sendQueuedStep());
+    }
+    else
+#endif
     if(PrintLine::hasLines())
     {
-        setTimer(PrintLine::bresenhamStep());
+        // the timer restarts at RC, so a long interrupt is timed with the free running cycle counter
+        uint32_t start = DWT->CYCCNT;
+#if STEP_EVENT_RING
+        long delay = PrintLine::nextStepEvent();
+#else
+        long delay = PrintLine::bresenhamStep();
+#endif
+        uint32_t ticks = (DWT->CYCCNT - start) / (F_CPU_TRUE / F_CPU);
+        PrintLine::recordStepTicks(ticks > 65535 ? 65535 : ticks);
+        setTimer(delay);
         HAL::allowInterrupts();
     }
     else
@@ -727,6 +995,36 @@ void TIMER1_COMPA_VECTOR ()
 #define HEATER_PWM_STEP 4
 #define HEATER_PWM_MASK 252
 #endif
+/** Duty cycle of a heater on a hardware pwm output, with the same resolution as the software pwm.
+The largest value HEATER_PWM_MASK leaves the heater on all the time. */
+#define HEATER_HW_PWM(v) (((v) & HEATER_PWM_MASK) == HEATER_PWM_MASK ? 255 : ((v) & HEATER_PWM_MASK))
+
+#ifdef SERIAL_RX_RING
+/** \brief Moves received bytes from the Arduino core into the receive ring.
+
+Called from the PWM timer. At 250000 baud about 7 bytes arrive between two calls, so the
+128 byte buffer of the core only needs to bridge the time the interrupt is blocked. If the
+ring is full, the bytes stay in the core buffer. A full core buffer means bytes may have been
+lost and counts as overflow.
+*/
+void HAL::serialReceive()
+{
+    int n = RFSERIAL.available();
+    if(n <= 0) return;
+    if(n >= SERIAL_BUFFER_SIZE - 1) serialRxOverflowCount++;
+    uint16_t head = serialRxHead;
+    uint16_t used = (head - serialRxTailPos) & SERIAL_RX_BUFFER_MASK;
+    while(n--)
+    {
+        if(used == SERIAL_RX_BUFFER_MASK) break; // keep the rest in the core buffer
+        serialRxBuffer[head] = RFSERIAL.read();
+        head = (head + 1) & SERIAL_RX_BUFFER_MASK;
+        used++;
+    }
+    serialRxHead = head;
+    if(used > serialRxHighWaterMark) serialRxHighWaterMark = used;
+}
+#endif
 
 /**
 This timer is called 3906 times per second. It is used to update
@@ -745,108 +1043,198 @@ void PWM_TIMER_VECTOR ()
     if(pwm_count==0)
     {
 #if EXT0_HEATER_PIN>-1
+#if HW_PWM(EXT0_HEATER_PIN)
+        HW_PWM_WRITE(EXT0_HEATER_PIN,HEATER_HW_PWM(pwm_pos[0]));
+#else
         if((pwm_pos_set[0] = (pwm_pos[0] & HEATER_PWM_MASK))>0) WRITE(EXT0_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1
+#if HW_PWM(EXT1_HEATER_PIN)
+        HW_PWM_WRITE(EXT1_HEATER_PIN,HEATER_HW_PWM(pwm_pos[1]));
+#else
         if((pwm_pos_set[1] = (pwm_pos[1] & HEATER_PWM_MASK))>0) WRITE(EXT1_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2
+#if HW_PWM(EXT2_HEATER_PIN)
+        HW_PWM_WRITE(EXT2_HEATER_PIN,HEATER_HW_PWM(pwm_pos[2]));
+#else
         if((pwm_pos_set[2] = (pwm_pos[2] & HEATER_PWM_MASK))>0) WRITE(EXT2_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3
+#if HW_PWM(EXT3_HEATER_PIN)
+        HW_PWM_WRITE(EXT3_HEATER_PIN,HEATER_HW_PWM(pwm_pos[3]));
+#else
         if((pwm_pos_set[3] = (pwm_pos[3] & HEATER_PWM_MASK))>0) WRITE(EXT3_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4
+#if HW_PWM(EXT4_HEATER_PIN)
+        HW_PWM_WRITE(EXT4_HEATER_PIN,HEATER_HW_PWM(pwm_pos[4]));
+#else
         if((pwm_pos_set[4] = (pwm_pos[4] & HEATER_PWM_MASK))>0) WRITE(EXT4_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5
+#if HW_PWM(EXT5_HEATER_PIN)
+        HW_PWM_WRITE(EXT5_HEATER_PIN,HEATER_HW_PWM(pwm_pos[5]));
+#else
         if((pwm_pos_set[5] = (pwm_pos[5] & HEATER_PWM_MASK))>0) WRITE(EXT5_HEATER_PIN,!HEATER_PINS_INVERTED);
 #endif
+#endif
 #if HEATED_BED_HEATER_PIN>-1 && HAVE_HEATED_BED
+#if HW_PWM(HEATED_BED_HEATER_PIN)
+        HW_PWM_WRITE(HEATED_BED_HEATER_PIN,pwm_pos[NUM_EXTRUDER]);
+#else
         if((pwm_pos_set[NUM_EXTRUDER] = pwm_pos[NUM_EXTRUDER])>0) WRITE(HEATED_BED_HEATER_PIN,!HEATER_PINS_INVERTED);
+#endif
 #endif
     }
     if(pwm_count==0)
     {
 #if EXT0_HEATER_PIN>-1 && EXT0_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT0_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT0_EXTRUDER_COOLER_PIN,extruder[0].coolerPWM);
+#else
         if((pwm_cooler_pos_set[0] = extruder[0].coolerPWM)>0) WRITE(EXT0_EXTRUDER_COOLER_PIN,1);
 #endif
+#endif
 #if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1
 #if EXT1_EXTRUDER_COOLER_PIN>-1 && EXT1_EXTRUDER_COOLER_PIN!=EXT0_EXTRUDER_COOLER_PIN
+#if HW_PWM(EXT1_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT1_EXTRUDER_COOLER_PIN,extruder[1].coolerPWM);
+#else
         if((pwm_cooler_pos_set[1] = extruder[1].coolerPWM)>0) WRITE(EXT1_EXTRUDER_COOLER_PIN,1);
 #endif
 #endif
+#endif
 #if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2
 #if EXT2_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT2_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT2_EXTRUDER_COOLER_PIN,extruder[2].coolerPWM);
+#else
         if((pwm_cooler_pos_set[2] = extruder[2].coolerPWM)>0) WRITE(EXT2_EXTRUDER_COOLER_PIN,1);
 #endif
 #endif
+#endif
 #if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3
 #if EXT3_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT3_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT3_EXTRUDER_COOLER_PIN,extruder[3].coolerPWM);
+#else
         if((pwm_cooler_pos_set[3] = extruder[3].coolerPWM)>0) WRITE(EXT3_EXTRUDER_COOLER_PIN,1);
 #endif
 #endif
+#endif
 #if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4
 #if EXT4_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT4_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT4_EXTRUDER_COOLER_PIN,extruder[4].coolerPWM);
+#else
         if((pwm_cooler_pos_set[4] = pwm_pos[4].coolerPWM)>0) WRITE(EXT4_EXTRUDER_COOLER_PIN,1);
 #endif
 #endif
+#endif
 #if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5
 #if EXT5_EXTRUDER_COOLER_PIN>-1
+#if HW_PWM(EXT5_EXTRUDER_COOLER_PIN)
+        HW_PWM_WRITE(EXT5_EXTRUDER_COOLER_PIN,extruder[5].coolerPWM);
+#else
         if((pwm_cooler_pos_set[5] = extruder[5].coolerPWM)>0) WRITE(EXT5_EXTRUDER_COOLER_PIN,1);
 #endif
 #endif
+#endif
 #if FAN_BOARD_PIN>-1
+#if HW_PWM(FAN_BOARD_PIN)
+        HW_PWM_WRITE(FAN_BOARD_PIN,pwm_pos[NUM_EXTRUDER+1]);
+#else
         if((pwm_pos_set[NUM_EXTRUDER+1] = pwm_pos[NUM_EXTRUDER+1])>0) WRITE(FAN_BOARD_PIN,1);
 #endif
+#endif
 #if FAN_PIN>-1 && FEATURE_FAN_CONTROL
+#if HW_PWM(FAN_PIN)
+        HW_PWM_WRITE(FAN_PIN,pwm_pos[NUM_EXTRUDER+2]);
+#else
         if((pwm_pos_set[NUM_EXTRUDER+2] = pwm_pos[NUM_EXTRUDER+2])>0) WRITE(FAN_PIN,1);
+#endif
 #endif
     }
 #if EXT0_HEATER_PIN>-1
+#if !HW_PWM(EXT0_HEATER_PIN)
     if(pwm_pos_set[0] == pwm_count_heater && pwm_pos_set[0]!=HEATER_PWM_MASK) WRITE(EXT0_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT0_EXTRUDER_COOLER_PIN>-1
+#if !HW_PWM(EXT0_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[0] == pwm_count && pwm_cooler_pos_set[0]!=255) WRITE(EXT0_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if defined(EXT1_HEATER_PIN) && EXT1_HEATER_PIN>-1 && NUM_EXTRUDER>1
+#if !HW_PWM(EXT1_HEATER_PIN)
     if(pwm_pos_set[1] == pwm_count_heater && pwm_pos_set[1]!=HEATER_PWM_MASK) WRITE(EXT1_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT1_EXTRUDER_COOLER_PIN>-1 && EXT1_EXTRUDER_COOLER_PIN!=EXT0_EXTRUDER_COOLER_PIN
+#if !HW_PWM(EXT1_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[1] == pwm_count && pwm_cooler_pos_set[1]!=255) WRITE(EXT1_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if defined(EXT2_HEATER_PIN) && EXT2_HEATER_PIN>-1 && NUM_EXTRUDER>2
+#if !HW_PWM(EXT2_HEATER_PIN)
     if(pwm_pos_set[2] == pwm_count_heater && pwm_pos_set[2]!=HEATER_PWM_MASK) WRITE(EXT2_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT2_EXTRUDER_COOLER_PIN>-1
+#if !HW_PWM(EXT2_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[2] == pwm_count && pwm_cooler_pos_set[2]!=255) WRITE(EXT2_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if defined(EXT3_HEATER_PIN) && EXT3_HEATER_PIN>-1 && NUM_EXTRUDER>3
+#if !HW_PWM(EXT3_HEATER_PIN)
     if(pwm_pos_set[3] == pwm_count_heater && pwm_pos_set[3]!=HEATER_PWM_MASK) WRITE(EXT3_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT3_EXTRUDER_COOLER_PIN>-1
+#if !HW_PWM(EXT3_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[3] == pwm_count && pwm_cooler_pos_set[3]!=255) WRITE(EXT3_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if defined(EXT4_HEATER_PIN) && EXT4_HEATER_PIN>-1 && NUM_EXTRUDER>4
+#if !HW_PWM(EXT4_HEATER_PIN)
     if(pwm_pos_set[4] == pwm_count_heater && pwm_pos_set[4]!=HEATER_PWM_MASK) WRITE(EXT4_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT4_EXTRUDER_COOLER_PIN>-1
+#if !HW_PWM(EXT4_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[4] == pwm_count && pwm_cooler_pos_set[4]!=255) WRITE(EXT4_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if defined(EXT5_HEATER_PIN) && EXT5_HEATER_PIN>-1 && NUM_EXTRUDER>5
+#if !HW_PWM(EXT5_HEATER_PIN)
     if(pwm_pos_set[5] == pwm_count_heater && pwm_pos_set[5]!=HEATER_PWM_MASK) WRITE(EXT5_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #if EXT5_EXTRUDER_COOLER_PIN>-1
+#if !HW_PWM(EXT5_EXTRUDER_COOLER_PIN)
     if(pwm_cooler_pos_set[5] == pwm_count && pwm_cooler_pos_set[5]!=255) WRITE(EXT5_EXTRUDER_COOLER_PIN,0);
 #endif
 #endif
+#endif
 #if FAN_BOARD_PIN>-1
+#if !HW_PWM(FAN_BOARD_PIN)
     if(pwm_pos_set[NUM_EXTRUDER+1] == pwm_count && pwm_pos_set[NUM_EXTRUDER+1]!=255) WRITE(FAN_BOARD_PIN,0);
 #endif
+#endif
 #if FAN_PIN>-1 && FEATURE_FAN_CONTROL
+#if !HW_PWM(FAN_PIN)
     if(pwm_pos_set[NUM_EXTRUDER+2] == pwm_count && pwm_pos_set[NUM_EXTRUDER+2]!=255) WRITE(FAN_PIN,0);
 #endif
+#endif
 #if HEATED_BED_HEATER_PIN>-1 && HAVE_HEATED_BED
+#if !HW_PWM(HEATED_BED_HEATER_PIN)
     if(pwm_pos_set[NUM_EXTRUDER] == pwm_count_heater && pwm_pos_set[NUM_EXTRUDER]!=HEATER_PWM_MASK) WRITE(HEATED_BED_HEATER_PIN,HEATER_PINS_INVERTED);
+#endif
 #endif
     HAL::allowInterrupts();
     counterPeriodical++; // Appxoimate a 100ms timer
@@ -856,7 +1244,7 @@ void PWM_TIMER_VECTOR ()
         executePeriodical=1;
     }
 // read analog values -- only read one per interrupt
-#if ANALOG_INPUTS>0
+#if ANALOG_INPUTS>0 && !ANALOG_INTERRUPT_SAMPLING
         
     // conversion finished?
     //if(ADC->ADC_ISR & ADC_ISR_EOC(adcChannel[osAnalogInputPos])) 
@@ -892,6 +1280,9 @@ void PWM_TIMER_VECTOR ()
     }
 #endif
     UI_FAST; // Short timed user interface action
+#ifdef SERIAL_RX_RING
+    HAL::serialReceive();
+#endif
     pwm_count++;
     pwm_count_heater += HEATER_PWM_STEP;
 }
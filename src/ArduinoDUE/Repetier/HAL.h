@@ -128,6 +128,29 @@ typedef char prog_char;
 
 #define PULLUP(IO,v)            {pinMode(IO, (v!=LOW ? INPUT_PULLUP : INPUT)); }
 
+/** \brief Pwm controller outputs of the pins.
+
+HW_PWM_CHANNEL_<pin> is the channel of the pwm controller driving the pin as peripheral B.
+*/
+#define HW_PWM_CHANNEL_6 7
+#define HW_PWM_CHANNEL_7 6
+#define HW_PWM_CHANNEL_8 5
+#define HW_PWM_CHANNEL_9 4
+/** Channel clock cycles of MCK/1024 per pwm value. 255 values are one period, which gives
+15.3, 32, 64 or 161 Hz for HEATER_PWM_SPEED 0-3. */
+#define HW_PWM_STEP (21 >> HEATER_PWM_SPEED)
+
+#define _HW_PWM_CHANNEL(IO) HW_PWM_CHANNEL_ ## IO
+#define HW_PWM_CHANNEL(IO) _HW_PWM_CHANNEL(IO)
+/// True if HARDWARE_PWM is enabled and the pin is a pwm controller output. Use it in #if only.
+#define HW_PWM(IO) (HARDWARE_PWM && HW_PWM_CHANNEL(IO))
+/// Sets the duty cycle 0-255 of pin IO, it starts with the next pwm period
+#define HW_PWM_WRITE(IO,v) PWM->PWM_CH_NUM[HW_PWM_CHANNEL(IO)].PWM_CDTYUPD = (v) * HW_PWM_STEP
+/// Connects pin IO to its pwm channel with duty cycle 0. inverted outputs are high while off.
+#define HW_PWM_START(IO,inverted) HAL::hardwarePwmStart(IO,HW_PWM_CHANNEL(IO),inverted)
+/// Gives pin IO back to the PIO controller, WRITE sets the pin again.
+#define HW_PWM_STOP(IO) g_APinDescription[IO].pPort->PIO_PER = g_APinDescription[IO].ulPin
+
 // INTERVAL / (32Khz/128)  = seconds
 #define WATCHDOG_INTERVAL       250  // 1sec  (~16 seconds max)
 
@@ -188,6 +211,16 @@ typedef unsigned long millis_t;
 typedef int flag8_t;
 
 #define RFSERIAL Serial
+#if SERIAL_RX_ZERO_COPY
+/** Received bytes are moved from the 128 byte buffer of the Arduino core into a receive ring of
+SERIAL_RX_BUFFER_SIZE bytes by the PWM timer, see HAL::serialReceive. The ring can be read in place.
+Without SERIAL_RX_ZERO_COPY the bytes are read from the core buffer as before. */
+#define SERIAL_RX_RING
+#define SERIAL_RX_BUFFER_MASK (SERIAL_RX_BUFFER_SIZE - 1)
+#if (SERIAL_RX_BUFFER_SIZE & (SERIAL_RX_BUFFER_SIZE - 1)) || SERIAL_RX_BUFFER_SIZE < 256 || SERIAL_RX_BUFFER_SIZE > 32768
+#error SERIAL_RX_BUFFER_SIZE must be a power of 2 between 256 and 32768
+#endif
+#endif
 
 #define OUT_P_I(p,i) //Com::printF(PSTR(p),(int)(i))
 #define OUT_P_I_LN(p,i) //Com::printFLN(PSTR(p),(int)(i))
@@ -269,6 +302,11 @@ public:
     {
         return ((unsigned long)a / (unsigned long)b);
     }
+    /** \brief Square root of a, rounded to the nearest integer like the AVR version.
+
+    CLZ normalises the argument, a table gives a seed with < 1.6% error and two Newton steps
+    on the hardware divider make it exact. */
+    static uint32_t integerSqrt(uint32_t a);
     static inline void digitalWrite(uint8_t pin,uint8_t value)
     {
         WRITE(pin, value);
@@ -453,6 +491,18 @@ public:
     {
         RFSERIAL.begin(baud);
     }
+#ifdef SERIAL_RX_RING
+    static inline bool serialByteAvailable()
+    {
+        return serialRxHead != serialRxTailPos;
+    }
+    static inline uint8_t serialReadByte()
+    {
+        uint8_t c = serialRxBuffer[serialRxTailPos];
+        serialRxConsume(1);
+        return c;
+    }
+#else
     static inline bool serialByteAvailable()
     {
         return RFSERIAL.available();
@@ -461,6 +511,7 @@ public:
     {
         return RFSERIAL.read();
     }
+#endif
     static inline void serialWriteByte(char b)
     {
         RFSERIAL.write(b);
@@ -469,6 +520,44 @@ public:
     {
         RFSERIAL.flush();
     }
+#ifdef SERIAL_RX_RING
+    /** \brief Start of the receive ring. Bytes from serialRxTail() on are received but not consumed. */
+    static inline uint8_t *serialRxData()
+    {
+        return serialRxBuffer;
+    }
+    static inline uint16_t serialRxTail()
+    {
+        return serialRxTailPos;
+    }
+    /** \brief Number of received bytes starting at serialRxTail(). */
+    static inline uint16_t serialRxAvailable()
+    {
+        return (serialRxHead - serialRxTailPos) & SERIAL_RX_BUFFER_MASK;
+    }
+    /** \brief Frees n bytes at the tail. Their content must not be used afterwards. */
+    static inline void serialRxConsume(uint16_t n)
+    {
+        __asm volatile("" ::: "memory"); // all reads of the freed bytes must be done before
+        serialRxTailPos = (serialRxTailPos + n) & SERIAL_RX_BUFFER_MASK;
+    }
+    static inline uint32_t serialRxOverflows()
+    {
+        return serialRxOverflowCount;
+    }
+    static inline uint16_t serialRxHighWater()
+    {
+        return serialRxHighWaterMark;
+    }
+    static inline void serialRxResetStatistics()
+    {
+        BEGIN_INTERRUPT_PROTECTED
+        serialRxOverflowCount = 0;
+        serialRxHighWaterMark = 0;
+        END_INTERRUPT_PROTECTED
+    }
+    static void serialReceive();
+#endif
     static void setupTimer();
     static void showStartReason();
     static int getFreeRam();
@@ -614,7 +703,17 @@ public:
 #if ANALOG_INPUTS>0
     static void analogStart(void);
 #endif
+    static void hardwarePwmStart(uint8_t pin,uint32_t channel,bool inverted);
+    /** \brief Switches the hardware pwm outputs off for an emergency stop. */
+    static void hardwarePwmOff();
     static volatile uint8_t insideTimer1;
+#ifdef SERIAL_RX_RING
+    static uint8_t serialRxBuffer[SERIAL_RX_BUFFER_SIZE];
+    static volatile uint16_t serialRxHead; ///< Written by serialReceive.
+    static volatile uint16_t serialRxTailPos; ///< Written by the main loop.
+    static uint32_t serialRxOverflowCount;
+    static uint16_t serialRxHighWaterMark;
+#endif
         
 protected:
 };
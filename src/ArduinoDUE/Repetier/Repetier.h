@@ -121,6 +121,13 @@ usage or for seraching for memory induced errors. Switch it off for production,
 #define BABYSTEP_MULTIPLICATOR 1
 #endif
 
+#ifndef MPC_FEED_FORWARD_TIME
+#define MPC_FEED_FORWARD_TIME 1.0
+#endif
+#ifndef MPC_AMBIENT_TEMPERATURE
+#define MPC_AMBIENT_TEMPERATURE 25
+#endif
+
 #if !defined(Z_PROBE_REPETITIONS) || Z_PROBE_REPETITIONS < 1
 #define Z_PROBE_SWITCHING_DISTANCE 0.5 // Distance to safely untrigger probe
 #define Z_PROBE_REPETITIONS 1
@@ -261,7 +268,29 @@ usage or for seraching for memory induced errors. Switch it off for production,
 #define MENU_MODE_FAN_RUNNING 8
 #define MENU_MODE_PRINTING 16
 
+#ifndef SERIAL_RX_BUFFER_SIZE
+#define SERIAL_RX_BUFFER_SIZE 128
+#endif
+#ifndef HARDWARE_PWM
+#define HARDWARE_PWM 0
+#endif
 #include "HAL.h"
+#ifndef SERIAL_RX_ZERO_COPY
+#define SERIAL_RX_ZERO_COPY 0
+#endif
+#if SERIAL_RX_ZERO_COPY && !defined(SERIAL_RX_RING)
+#undef SERIAL_RX_ZERO_COPY
+#define SERIAL_RX_ZERO_COPY 0
+#endif
+#ifndef BINARY_PROTOCOL_V3
+#define BINARY_PROTOCOL_V3 0
+#endif
+#ifndef FAST_ASCII_PARSER
+#define FAST_ASCII_PARSER 0
+#endif
+#ifndef THERMISTOR_DENSE_INDEX
+#define THERMISTOR_DENSE_INDEX 0
+#endif
 #include "gcode.h"
 #define MAX_VFAT_ENTRIES (2)
 /** Total size of the buffer used to store the long filenames */
@@ -274,6 +303,43 @@ usage or for seraching for memory induced errors. Switch it off for production,
 #ifndef SDSUPPORT
 #define SDSUPPORT false
 #endif
+#ifndef SD_READ_AHEAD
+#define SD_READ_AHEAD 0
+#endif
+#if !SDSUPPORT
+#undef SD_READ_AHEAD
+#define SD_READ_AHEAD 0
+#endif
+#if SD_READ_AHEAD == 1
+#error SD_READ_AHEAD needs at least 2 buffers
+#endif
+#ifndef MOTION_STREAM
+#define MOTION_STREAM 0
+#endif
+#ifndef SD_EXTENT_CACHE
+#define SD_EXTENT_CACHE 0
+#endif
+#ifndef SD_BUFFERED_UPLOAD
+#define SD_BUFFERED_UPLOAD 0
+#endif
+#ifndef SD_DIR_INDEX
+#define SD_DIR_INDEX 0
+#endif
+#if SD_DIR_INDEX > 254
+#error SD_DIR_INDEX can be at most 254, the file browser shows no more files
+#endif
+#if !SD_READ_AHEAD // the upload is gathered in the read ahead buffers
+#undef SD_BUFFERED_UPLOAD
+#define SD_BUFFERED_UPLOAD 0
+#endif
+#if !SDSUPPORT
+#undef MOTION_STREAM
+#define MOTION_STREAM 0
+#undef SD_EXTENT_CACHE
+#define SD_EXTENT_CACHE 0
+#undef SD_DIR_INDEX
+#define SD_DIR_INDEX 0
+#endif
 #if SDSUPPORT
 #include "SdFat.h"
 #endif
@@ -289,6 +355,41 @@ usage or for seraching for memory induced errors. Switch it off for production,
 #define ENABLE_BACKLASH_COMPENSATION false
 #endif
 
+#ifndef STEP_TIMING_QUEUE
+#define STEP_TIMING_QUEUE 0
+#endif
+#ifndef STEP_EVENT_RING
+#define STEP_EVENT_RING 0
+#endif
+#if STEP_EVENT_RING && (NONLINEAR_SYSTEM || defined(XY_GANTRY))
+#undef STEP_EVENT_RING
+#define STEP_EVENT_RING 0
+#endif
+#if STEP_TIMING_QUEUE && (NONLINEAR_SYSTEM || defined(XY_GANTRY) || STEP_EVENT_RING)
+#undef STEP_TIMING_QUEUE
+#define STEP_TIMING_QUEUE 0
+#endif
+#ifndef DELTA_LAZY_SEGMENTS
+#define DELTA_LAZY_SEGMENTS 0
+#endif
+#if DELTA_LAZY_SEGMENTS && DRIVE_SYSTEM!=3
+#undef DELTA_LAZY_SEGMENTS
+#define DELTA_LAZY_SEGMENTS 0
+#endif
+#if DELTA_LAZY_SEGMENTS && (DELTA_LAZY_SEGMENTS_BUFFER & (DELTA_LAZY_SEGMENTS_BUFFER - 1) || DELTA_LAZY_SEGMENTS_BUFFER > 128 || DELTA_LAZY_SEGMENTS_BUFFER < 8)
+#error DELTA_LAZY_SEGMENTS_BUFFER must be a power of 2 between 8 and 128
+#endif
+#ifndef DELTA_SEGMENT_POOL_SIZE
+#define DELTA_SEGMENT_POOL_SIZE 0
+#endif
+#if DELTA_SEGMENT_POOL_SIZE && (!NONLINEAR_SYSTEM || DELTA_LAZY_SEGMENTS)
+#undef DELTA_SEGMENT_POOL_SIZE
+#define DELTA_SEGMENT_POOL_SIZE 0
+#endif
+#if DELTA_SEGMENT_POOL_SIZE && (DELTA_SEGMENT_POOL_SIZE < MAX_DELTA_SEGMENTS_PER_LINE || DELTA_SEGMENT_POOL_SIZE > 32767)
+#error DELTA_SEGMENT_POOL_SIZE must be between MAX_DELTA_SEGMENTS_PER_LINE and 32767
+#endif
+
 #define uint uint16_t
 #define uint8 uint8_t
 #define int8 int8_t
@@ -343,6 +444,37 @@ extern uint8 osAnalogInputCounter[ANALOG_INPUTS];
 extern uint osAnalogInputBuildup[ANALOG_INPUTS];
 extern uint8 osAnalogInputPos; // Current sampling position
 extern volatile uint osAnalogInputValues[ANALOG_INPUTS];
+#ifndef ANALOG_INTERRUPT_SAMPLING
+#define ANALOG_INTERRUPT_SAMPLING 0
+#endif
+#if ANALOG_INTERRUPT_SAMPLING && ANALOG_INPUTS>0
+extern uint osAnalogInputHistory[ANALOG_INPUTS][2];
+/** Stores the sum of 2^ANALOG_INPUT_SAMPLE samples of input i, called by the ADC interrupt.
+The value is the median of the last three sums scaled to 12 bit, so a single disturbed
+sum does not reach the temperature control. */
+inline void analogInputSample(uint8_t i,uint sum)
+{
+    uint a = osAnalogInputHistory[i][0],b = osAnalogInputHistory[i][1];
+    if(osAnalogInputValues[i] == 0) a = b = sum; // first sum after start
+    osAnalogInputHistory[i][0] = b;
+    osAnalogInputHistory[i][1] = sum;
+    if(a > b)
+    {
+        uint t = a;
+        a = b;
+        b = t;
+    }
+    if(sum < a) sum = a;
+    else if(sum > b) sum = b;
+#if ANALOG_INPUT_BITS+ANALOG_INPUT_SAMPLE<12
+    osAnalogInputValues[i] = sum << (12-ANALOG_INPUT_BITS-ANALOG_INPUT_SAMPLE);
+#elif ANALOG_INPUT_BITS+ANALOG_INPUT_SAMPLE>12
+    osAnalogInputValues[i] = sum >> (ANALOG_INPUT_BITS+ANALOG_INPUT_SAMPLE-12);
+#else
+    osAnalogInputValues[i] = sum;
+#endif
+}
+#endif
 extern uint8_t pwm_pos[NUM_EXTRUDER+3]; // 0-NUM_EXTRUDER = Heater 0-NUM_EXTRUDER of extruder, NUM_EXTRUDER = Heated bed, NUM_EXTRUDER+1 Board fan, NUM_EXTRUDER+2 = Fan
 #ifdef USE_ADVANCE
 #ifdef ENABLE_QUADRATIC_ADVANCE
@@ -398,7 +530,36 @@ extern volatile uint8_t executePeriodical;
 extern uint8_t counter250ms;
 extern void writeMonitor();
 
+/** Motion stream files contain the moves of a G-code file already converted to steps,
+so printing them from SD skips the parser. They start with a MotionStreamHeader followed by
+MotionRecords. Commands other than G0-G3 are stored in the binary G-code format in a
+MOTION_RECORD_COMMAND record, the first 22 bytes in the record itself, the rest in the
+following records. The host simulator writes them with -M. */
+#define MOTION_STREAM_MAGIC 0x314d5352UL // "RSM1"
+#define MOTION_RECORD_MOVE 1
+#define MOTION_RECORD_COMMAND 2
+#define MOTION_FLAG_CHECK_ENDSTOPS 1
+#define MOTION_FLAG_PATH_OPTIMIZE 2
+#define MOTION_FLAG_SOFT_ENDSTOP 4
+#define MOTION_COMMAND_RECORDS 4 ///< Maximum number of records of one command
+
+struct MotionStreamHeader
+{
+    uint32_t magic;
+    uint8_t recordSize;
+    uint8_t driveSystem;
+    uint16_t reserved;
+    float axisStepsPerMM[4]; ///< Steps per mm the file was converted with
+};
 
+struct MotionRecord
+{
+    uint8_t type; ///< MOTION_RECORD_MOVE or MOTION_RECORD_COMMAND
+    uint8_t flags; ///< MOTION_FLAG_* for moves, size of the binary command for commands
+    uint16_t reserved;
+    int32_t steps[4]; ///< X, Y, Z target in steps, E in steps relative to the previous move
+    float feedrate; ///< mm/s at 100% speed
+};
 
 #if SDSUPPORT
 extern char tempLongFilename[LONG_FILENAME_LENGTH+1];
@@ -436,7 +597,28 @@ public:
   void pausePrint(bool intern = false);
   void continuePrint(bool intern=false);
   void stopPrint();
-  inline void setIndex(uint32_t  newpos) { if(!sdactive) return; sdpos = newpos;file.seekSet(sdpos);}
+#if SD_READ_AHEAD
+  /** Returns the byte at sdpos or -1 on a read error. Does not advance sdpos. */
+  inline int readByte()
+  {
+    if(!readAheadCount && !waitReadAhead()) return -1;
+    uint16_t offset = sdpos - readAheadPos;
+    int c = readAheadBuffer[readAheadFirst][offset];
+    if(offset == 511) // block consumed, buffer can be refilled
+    {
+      if(++readAheadFirst == SD_READ_AHEAD) readAheadFirst = 0;
+      readAheadCount--;
+      readAheadPos += 512;
+    }
+    return c;
+  }
+  void fillReadAhead();
+  void resetReadAhead();
+  uint32_t readAheadUnderruns; ///< Number of times the parser had to wait for a block
+  uint32_t readAheadBlocks; ///< Blocks read ahead
+  uint32_t readAheadStreams; ///< Multiple block reads started
+#endif
+  void setIndex(uint32_t newpos);
   void printStatus();
   void ls();
   void startWrite(char *filename);
@@ -446,11 +628,57 @@ public:
   void makeDirectory(char *filename);
   bool showFilename(const uint8_t *name);
   void automount();
+#if MOTION_STREAM
+  bool motionStream; ///< Selected file is a motion stream
+  void feedMotionStream();
+#endif
+#if SD_DIR_INDEX
+  void startDirIndex(bool listDirs);
+  bool fillDirIndex();
+  void restartDirIndex();
+  bool getDirIndexName(uint8_t n,char *name);
+  void removeDirIndex(uint8_t n);
+  uint8_t dirIndexFiles; ///< Listed files found so far
+#endif
 #ifdef GLENN_DEBUG
   void writeToFile();
 #endif
 private:
   uint8_t lsRecursive(SdBaseFile *parent,uint8_t level,char *findFilename);
+#if SD_EXTENT_CACHE
+  SdExtentCache extents; ///< Cluster runs of the selected file
+#endif
+#if MOTION_STREAM
+  bool readMotionData(uint8_t *buf,uint8_t size);
+  bool checkMotionStream();
+  void executeMotionCommand(uint8_t *data);
+#endif
+#if SD_DIR_INDEX
+  SdBaseFile dirIndexDir; ///< Indexed directory, a copy of the working directory
+  uint16_t dirIndexEntry[SD_DIR_INDEX]; ///< Directory entry where the scan for the n-th file starts
+  uint16_t dirIndexHash[SD_DIR_INDEX]; ///< Hash of its long filename to detect changes
+  uint16_t dirIndexNext; ///< Directory entry where the index build continues
+  bool dirIndexValid; ///< dirIndexDir is open and indexed
+  bool dirIndexComplete;
+  bool dirIndexListDirs; ///< Subdirectories are listed
+#endif
+#if SD_BUFFERED_UPLOAD
+  void flushUpload();
+  uint16_t uploadPos; ///< Bytes gathered in readAheadBuffer
+  uint32_t uploadAllocated; ///< File size covered by the allocated clusters
+#endif
+  millis_t uploadStart;
+#if SD_READ_AHEAD
+  bool readAheadBlock();
+  bool waitReadAhead();
+  uint8_t readAheadBuffer[SD_READ_AHEAD][512];
+  uint32_t readAheadPos; ///< File position of the first buffered block
+  uint32_t streamBlock; ///< Next device block of the current run
+  uint16_t streamLeft; ///< Blocks left in the current run
+  uint8_t readAheadFirst; ///< Buffer holding the block at readAheadPos
+  uint8_t readAheadCount; ///< Filled buffers
+  bool readAheadStarted; ///< Something was read since the last reset
+#endif
  // SdFile *getDirectory(char* name);
 };
 
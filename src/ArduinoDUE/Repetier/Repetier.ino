@@ -109,7 +109,8 @@ Custom M Codes
 - M251 Measure Z steps from homing stop (Delta printers). S0 - Reset, S1 - Print, S2 - Store to Z length (also EEPROM if enabled)
 - M280 S<mode> - Set ditto printing mode. mode: 0 = off, 1 = 2 extruder, 2 = 3 extruder, 3 = 4 extruder printing
 - M300 S<Frequency> P<DurationMillis> play frequency
-- M303 P<extruder/bed> S<printTemerature> X0 - Autodetect pid values. Use P<NUM_EXTRUDER> for heated bed. X0 saves result in EEPROM.
+- M303 P<extruder/bed> S<printTemerature> X0 - Autodetect pid values. Use P<NUM_EXTRUDER> for heated bed. X0 saves result in EEPROM. Runs in the background, other commands are still executed.
+- M306 P<extruder> S<temperature> X0 - Measure the heater model for heat manager 4. Cools down, heats up to S, holds it and fits the model. Runs in the background like M303. X0 saves result in EEPROM.
 - M320 - Activate autolevel
 - M321 - Deactivate autolevel
 - M322 - Reset autolevel matrix
@@ -121,6 +122,11 @@ Custom M Codes
 - M500 Store settings to EEPROM
 - M501 Load settings from EEPROM
 - M502 Reset settings to the one in configuration.h. Does not store values in EEPROM!
+- M536 S0 - Report step event ring underruns and lowest fill level (STEP_EVENT_RING or DELTA_LAZY_SEGMENTS). S resets the values.
+- M537 S0 - Report serial receive buffer overflows and highest fill level. S resets the values.
+- M538 S0 - Report SD read ahead underruns, blocks read and multiple block reads started. S resets the values.
+- M539 S0 P<seconds> - Report move queue statistics: queue empty events, moves slowed down by MOVE_CACHE_LOW, replanning depth, longest stepper interrupt, serial RX overflows and SD underruns. S resets the values, P reports them every P seconds, P0 stops the report.
+- M576 S<0/1> - Streaming mode: ok reports the free places of the command buffer as B<n>, so the host can send that many lines without waiting. Without S the mode and buffer size are reported.
 - M908 P<address> S<value> : Set stepper current for digipot (RAMBO board)
 */
 
@@ -801,7 +801,12 @@ uint8_t const SD_CHIP_SELECT_PIN = SOFT_SPI_CS_PIN;
 class Sd2Card {
  public:
   /** Construct an instance of Sd2Card. */
+#if SD_READ_AHEAD
+  Sd2Card() : errorCode_(SD_CARD_ERROR_INIT_NOT_CALLED), type_(0),
+    streamBlock_(0XFFFFFFFF) {}
+#else  // SD_READ_AHEAD
   Sd2Card() : errorCode_(SD_CARD_ERROR_INIT_NOT_CALLED), type_(0) {}
+#endif  // SD_READ_AHEAD
   uint32_t cardSize();
   bool erase(uint32_t firstBlock, uint32_t lastBlock);
   bool eraseSingleBlockEnable();
@@ -851,6 +856,13 @@ class Sd2Card {
   bool readData(uint8_t *dst);
   bool readStart(uint32_t blockNumber);
   bool readStop();
+#if SD_READ_AHEAD
+  bool readStreamBlock(uint32_t blockNumber, uint8_t* dst);
+  /** \return The block the open multiple block read of readStreamBlock()
+   * delivers next or 0XFFFFFFFF if none is open.
+   */
+  uint32_t streamBlock() const {return streamBlock_;}
+#endif  // SD_READ_AHEAD
   bool setSckRate(uint8_t sckRateID);
   /** Return the card type: SD V1, SD V2 or SDHC
    * \return 0 - SD V1, 1 - SD V2, or 3 - SDHC.
@@ -868,6 +880,9 @@ class Sd2Card {
   uint8_t spiRate_;
   uint8_t status_;
   uint8_t type_;
+#if SD_READ_AHEAD
+  uint32_t streamBlock_;
+#endif  // SD_READ_AHEAD
   // private functions
   uint8_t cardAcmd(uint8_t cmd, uint32_t arg) {
     cardCommand(CMD55, 0);
@@ -1846,6 +1861,23 @@ static inline uint8_t FAT_SECOND(uint16_t fatTime) {
 uint16_t const FAT_DEFAULT_DATE = ((2000 - 1980) << 9) | (1 << 5) | 1;
 /** Default time for file timestamp is 1 am */
 uint16_t const FAT_DEFAULT_TIME = (1 << 11);
+#if SD_EXTENT_CACHE
+//------------------------------------------------------------------------------
+/**
+ * \struct SdExtentCache
+ * \brief Runs of consecutive clusters of a file, see SdBaseFile::buildExtents().
+ */
+struct SdExtentCache {
+  /** Number of runs */
+  uint8_t count;
+  /** Clusters of the file covered by the runs */
+  uint32_t clusters;
+  /** Index of the first file cluster of each run */
+  uint32_t fileCluster[SD_EXTENT_CACHE];
+  /** First volume cluster of each run */
+  uint32_t cluster[SD_EXTENT_CACHE];
+};
+#endif  // SD_EXTENT_CACHE
 //------------------------------------------------------------------------------
 /**
  * \class SdBaseFile
@@ -1976,6 +2008,16 @@ class SdBaseFile {
   int16_t read();
   int read(void* buf, size_t nbyte);
   int8_t readDir(dir_t* dir, char *longfilename);
+#if SD_EXTENT_CACHE
+  bool buildExtents(SdExtentCache* cache);
+#endif  // SD_EXTENT_CACHE
+#if SD_BUFFERED_UPLOAD
+  bool preAllocate(uint32_t count);
+#endif  // SD_BUFFERED_UPLOAD
+#if SD_READ_AHEAD
+  bool contiguousBlocks(uint32_t pos, uint32_t* block, uint16_t* count);
+  bool readStreamBlock(uint32_t block, uint8_t* dst);
+#endif  // SD_READ_AHEAD
 
   static bool remove(SdBaseFile* dirFile, const char* path);
   bool remove();
@@ -2038,6 +2080,9 @@ class SdBaseFile {
   uint32_t  dirBlock_;      // block for this files directory entry
   uint32_t  fileSize_;      // file size in bytes
   uint32_t  firstCluster_;  // first cluster of file
+#if SD_EXTENT_CACHE
+  SdExtentCache* extents_;  // cluster runs of the file or NULL
+#endif  // SD_EXTENT_CACHE
   char *pathend;
 
 
@@ -2045,6 +2090,9 @@ class SdBaseFile {
   /** experimental don't use */
   bool openParent(SdBaseFile* dir);
   // private functions
+#if SD_EXTENT_CACHE
+  bool extentCluster(uint32_t index, uint32_t* cluster, uint32_t* run);
+#endif  // SD_EXTENT_CACHE
   bool addCluster();
   cache_t* addDirCluster();
   dir_t* cacheDirEntry(uint8_t action);
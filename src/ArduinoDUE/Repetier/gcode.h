@@ -19,6 +19,9 @@
 #define _GCODE_H
 
 #define MAX_CMD_SIZE 96
+#if SERIAL_RX_ZERO_COPY && SERIAL_RX_BUFFER_SIZE <= MAX_CMD_SIZE
+#error SERIAL_RX_ZERO_COPY needs a SERIAL_RX_BUFFER_SIZE larger than MAX_CMD_SIZE
+#endif
 class SDCard;
 class GCode   // 52 uint8_ts per command needed
 {
@@ -96,6 +99,10 @@ public:
     {
         return ((params & 32768)!=0);
     }
+    inline bool isV3Frame()
+    {
+        return ((params & 8192)!=0);
+    }
     inline bool hasI()
     {
         return ((params2 & 1)!=0);
@@ -125,6 +132,7 @@ public:
     void printCommand();
     bool parseBinary(uint8_t *buffer,bool fromSerial);
     bool parseAscii(char *line,bool fromSerial);
+    uint8_t writeBinary(uint8_t *buf);
     void popCurrentCommand();
     void echoCommand();
     /** Get next command in command buffer. After the command is processed, call gcode_command_finished() */
@@ -133,6 +141,7 @@ public:
     static void readFromSerial();
     static void pushCommand();
     static void executeFString(FSTRINGPARAM(cmd));
+    static bool okWindow; ///< Append the free places of commandsBuffered to every ok, set with M576.
     static uint8_t computeBinarySize(char *ptr);
 
     friend class SDCard;
@@ -140,7 +149,19 @@ public:
 private:
     void debugCommandBuffer();
     void checkAndPushCommand();
-    static void requestResend();
+    void queueCommand();
+    static void requestResend(GCode *failed = NULL);
+    static void sendOk(bool withLineNumber = false);
+#if BINARY_PROTOCOL_V3
+    static void pushFrameMoves();
+#endif
+#if SERIAL_RX_ZERO_COPY
+    static bool readFromSerialRing(millis_t time);
+#endif
+#if FAST_ASCII_PARSER
+    float scanFloatValue(char *&s);
+    long scanLongValue(char *&s);
+#else
     inline float parseFloatValue(char *s)
     {
         char *endPtr;
@@ -155,6 +176,7 @@ private:
         if(s == endPtr) setFormatError();
         return l;
     }
+#endif
 
     static GCode commandsBuffered[GCODE_BUFFER_SIZE]; ///< Buffer for received commands.
     static uint8_t bufferReadIndex; ///< Read position in gcode_buffer.
@@ -172,6 +194,16 @@ private:
     static volatile uint8_t bufferLength; ///< Number of commands stored in gcode_buffer
     static millis_t timeOfLastDataPacket; ///< Time, when we got the last data packet. Used to detect missing uint8_ts.
     static uint8_t formatErrors; ///< Number of sequential format errors
+    static millis_t timeOfLastResend; ///< Time of the last resend request.
+#if BINARY_PROTOCOL_V3
+    static uint8_t framePos; ///< Position of the next move of a v3 frame in commandReceiving, 0 = no frame.
+    static uint8_t frameEnd; ///< Position of the checksum of the v3 frame.
+    static int32_t frameBase[4]; ///< Last X, Y, Z and E sent by the host in micrometres.
+#endif
+#if SERIAL_RX_ZERO_COPY
+    static uint16_t serialRxScanned; ///< Bytes at the tail of the receive ring that belong to an incomplete command.
+    static bool serialRxInComment; ///< Skipping the comment of a command that was already parsed.
+#endif
 };
 
 
@@ -89,6 +89,64 @@ volatile bool PrintLine::nlFlag = false;
 uint8_t PrintLine::linesWritePos = 0;            ///< Position where we write the next cached line move.
 volatile uint8_t PrintLine::linesCount = 0;      ///< Number of lines cached 0 = nothing to do.
 uint8_t PrintLine::linesPos = 0;                 ///< Position for executing line movement.
+uint32_t PrintLine::plannerUpdates = 0;          ///< Number of updateTrapezoids calls that ran the planner.
+uint32_t PrintLine::replannedLines = 0;          ///< Lines the planner had to change in these calls.
+uint8_t PrintLine::maxReplanned = 0;
+uint32_t PrintLine::queueEmptyEvents = 0;
+uint32_t PrintLine::cacheLowSlowdowns = 0;
+uint16_t PrintLine::maxStepTicks = 0;
+#if STEP_TIMING_QUEUE
+uint8_t PrintLine::stepQueue[3];
+uint8_t PrintLine::stepQueuePos = 0;
+uint8_t PrintLine::stepQueueLength = 0;
+long PrintLine::stepQueueInterval;
+long PrintLine::stepQueueLastWait;
+#endif
+#if STEP_EVENT_RING
+StepEvent PrintLine::stepRing[STEP_EVENT_RING_SIZE];
+volatile uint8_t PrintLine::stepRingRead = 0;
+volatile uint8_t PrintLine::stepRingWrite = 0;
+volatile bool PrintLine::stepRingClassic = false;
+uint8_t PrintLine::stepRingDir = 0;
+uint8_t PrintLine::stepRingStopped = 0;
+uint8_t PrintLine::stepRingAxes = 0;
+bool PrintLine::stepRingSkip = false;
+uint8_t PrintLine::stepRingLinesSent = 0;
+uint8_t PrintLine::stepRingLinesStarted = 0;
+volatile uint8_t PrintLine::stepRingAbortLine = 0;
+volatile bool PrintLine::stepRingAbort = false;
+uint8_t PrintLine::stepRingSteps[4];
+uint8_t PrintLine::stepRingStepPos = 0;
+uint8_t PrintLine::stepRingStepCount = 0;
+uint16_t PrintLine::stepRingSub;
+long PrintLine::stepRingWait = 0;
+uint8_t PrintLine::stepRingFlags = 0;
+uint8_t PrintLine::stepRingEndFlags = 0;
+uint32_t PrintLine::stepRingUnderruns = 0;
+uint8_t PrintLine::stepRingMinFill = STEP_EVENT_RING_SIZE;
+volatile uint8_t PrintLine::stepRingLines = 0;
+volatile bool PrintLine::stepRingFilling = false;
+#endif
+#if DELTA_LAZY_SEGMENTS
+DeltaSegment PrintLine::deltaRing[DELTA_LAZY_SEGMENTS_BUFFER]; ///< Segments computed ahead of the stepper.
+uint8_t PrintLine::deltaRingRead = 0;
+uint8_t PrintLine::deltaRingWrite = 0;
+volatile uint8_t PrintLine::deltaRingCount = 0;
+volatile uint8_t PrintLine::deltaGenLines = 0;
+volatile uint8_t PrintLine::deltaGenLeft = 0;
+PrintLine *PrintLine::deltaGenLine;
+long PrintLine::deltaGenDiff[3];
+uint8_t PrintLine::deltaGenSegments;
+long PrintLine::deltaGenPos[3];
+uint16_t PrintLine::deltaGenMaxSteps;
+uint32_t PrintLine::deltaRingUnderruns = 0;
+uint8_t PrintLine::deltaRingMinFill = DELTA_LAZY_SEGMENTS_BUFFER;
+#endif
+#if DELTA_SEGMENT_POOL_SIZE
+DeltaSegment PrintLine::segmentPool[DELTA_SEGMENT_POOL_SIZE]; ///< Delta segments of all queued lines.
+uint16_t PrintLine::segmentPoolWritePos = 0;
+volatile uint16_t PrintLine::segmentPoolUsed = 0;
+#endif
 
 /**
 Move printer the given number of steps. Puts the move into the queue. Used by e.g. homing commands.
@@ -142,6 +200,9 @@ void PrintLine::moveRelativeDistanceInStepsReal(long x,long y,long z,long e,floa
 */
 void PrintLine::queueCartesianMove(uint8_t check_endstops,uint8_t pathOptimize)
 {
+#if CPU_ARCH==ARCH_HOST
+    if(HAL::motionStream && HAL::motionStreamMove(check_endstops,pathOptimize,0)) return;
+#endif
     Printer::unsetAllSteppersDisabled();
     waitForXFreeLines(1);
     uint8_t newPath=insertWaitMovesIfNeeded(pathOptimize, 0);
@@ -234,6 +295,9 @@ void PrintLine::queueCartesianMove(uint8_t check_endstops,uint8_t pathOptimize)
 #endif
 void PrintLine::calculateMove(float axis_diff[],uint8_t pathOptimize)
 {
+#if CPU_ARCH==ARCH_HOST
+    HAL::benchmarkMoveStart();
+#endif
 #if NONLINEAR_SYSTEM
     long axisInterval[5]; // shortest interval possible for that axis
 #else
@@ -241,85 +305,124 @@ void PrintLine::calculateMove(float axis_diff[],uint8_t pathOptimize)
 #endif
     float timeForMove = (float)(F_CPU)*distance / (isXOrYMove() ? RMath::max(Printer::minimumSpeed,Printer::feedrate): Printer::feedrate); // time is in ticks
     bool critical = Printer::isZProbingActive();
-    if(linesCount < MOVE_CACHE_LOW && timeForMove < LOW_TICKS_PER_MOVE)   // Limit speed to keep cache full.
+    uint8_t queued = queuedLines();
+    if(queued < MOVE_CACHE_LOW && timeForMove < LOW_TICKS_PER_MOVE)   // Limit speed to keep cache full.
     {
         //OUT_P_I("L:",lines_count);
-        timeForMove += (3 * (LOW_TICKS_PER_MOVE-timeForMove)) / (linesCount+1); // Increase time if queue gets empty. Add more time if queue gets smaller.
+        timeForMove += (3 * (LOW_TICKS_PER_MOVE-timeForMove)) / (queued+1); // Increase time if queue gets empty. Add more time if queue gets smaller.
+        cacheLowSlowdowns++;
         //OUT_P_F_LN("Slow ",time_for_move);
         critical=true;
     }
     timeInTicks = timeForMove;
     UI_MEDIUM; // do check encoder
-    // Compute the solwest allowed interval (ticks/step), so maximum feedrate is not violated
-    long limitInterval = timeForMove/stepsRemaining; // until not violated by other constraints it is your target speed
-    if(isXMove())
+    long limitInterval;
+#if FIXED_POINT_PLANNER && !NONLINEAR_SYSTEM
+    // Integer path. All delta[] are <= stepsRemaining, so with less than 65536 steps the
+    // axis times fit in 32 bit and need only one 32/16 bit division. Axes with a maximum feedrate
+    // interval above 16 bit need the float path.
+    bool fixedPoint = stepsRemaining < 65536L && timeForMove < 2147483647.0f;
+    uint32_t moveTicks = 0; // longest time any axis needs at maximum feedrate
+    for(uint8_t i = 0; fixedPoint && i < 4; i++)
+    {
+        if(!isMoveOfAxis(i)) continue;
+        if(Printer::maxFeedrateInterval[i] == 0)
+            fixedPoint = false;
+        else
+        {
+            uint32_t axisTicks = HAL::mulu16xu16to32(delta[i], Printer::maxFeedrateInterval[i]);
+            if(axisTicks > moveTicks) moveTicks = axisTicks;
+        }
+    }
+    if(fixedPoint)
     {
-        axisInterval[X_AXIS] = fabs(axis_diff[X_AXIS]) * F_CPU / (Printer::maxFeedrate[X_AXIS] * stepsRemaining); // mm*ticks/s/(mm/s*steps) = ticks/step
-#if !NONLINEAR_SYSTEM
-        limitInterval = RMath::max(axisInterval[X_AXIS],limitInterval);
-#endif
+        if(moveTicks < static_cast<uint32_t>(timeForMove)) moveTicks = static_cast<uint32_t>(timeForMove);
+        limitInterval = HAL::Div4U2U(moveTicks, stepsRemaining);
     }
-    else axisInterval[X_AXIS] = 0;
-    if(isYMove())
+    else
+#endif
     {
-        axisInterval[Y_AXIS] = fabs(axis_diff[Y_AXIS])*F_CPU/(Printer::maxFeedrate[Y_AXIS]*stepsRemaining);
+        // Compute the solwest allowed interval (ticks/step), so maximum feedrate is not violated
+        limitInterval = timeForMove/stepsRemaining; // until not violated by other constraints it is your target speed
+        if(isXMove())
+        {
+            axisInterval[X_AXIS] = fabs(axis_diff[X_AXIS]) * F_CPU / (Printer::maxFeedrate[X_AXIS] * stepsRemaining); // mm*ticks/s/(mm/s*steps) = ticks/step
 #if !NONLINEAR_SYSTEM
-        limitInterval = RMath::max(axisInterval[Y_AXIS],limitInterval);
+            limitInterval = RMath::max(axisInterval[X_AXIS],limitInterval);
 #endif
-    }
-    else axisInterval[Y_AXIS] = 0;
-    if(isZMove())   // normally no move in z direction
-    {
-        axisInterval[Z_AXIS] = fabs((float)axis_diff[Z_AXIS])*(float)F_CPU/(float)(Printer::maxFeedrate[Z_AXIS]*stepsRemaining); // must prevent overflow!
+        }
+        else axisInterval[X_AXIS] = 0;
+        if(isYMove())
+        {
+            axisInterval[Y_AXIS] = fabs(axis_diff[Y_AXIS])*F_CPU/(Printer::maxFeedrate[Y_AXIS]*stepsRemaining);
 #if !NONLINEAR_SYSTEM
-        limitInterval = RMath::max(axisInterval[Z_AXIS],limitInterval);
+            limitInterval = RMath::max(axisInterval[Y_AXIS],limitInterval);
 #endif
-    }
-    else axisInterval[Z_AXIS] = 0;
-    if(isEMove())
-    {
-        axisInterval[E_AXIS] = fabs(axis_diff[E_AXIS])*F_CPU/(Printer::maxFeedrate[E_AXIS]*stepsRemaining);
+        }
+        else axisInterval[Y_AXIS] = 0;
+        if(isZMove())   // normally no move in z direction
+        {
+            axisInterval[Z_AXIS] = fabs((float)axis_diff[Z_AXIS])*(float)F_CPU/(float)(Printer::maxFeedrate[Z_AXIS]*stepsRemaining); // must prevent overflow!
 #if !NONLINEAR_SYSTEM
-        limitInterval = RMath::max(axisInterval[E_AXIS],limitInterval);
+            limitInterval = RMath::max(axisInterval[Z_AXIS],limitInterval);
 #endif
-    }
-    else axisInterval[E_AXIS] = 0;
+        }
+        else axisInterval[Z_AXIS] = 0;
+        if(isEMove())
+        {
+            axisInterval[E_AXIS] = fabs(axis_diff[E_AXIS])*F_CPU/(Printer::maxFeedrate[E_AXIS]*stepsRemaining);
+#if !NONLINEAR_SYSTEM
+            limitInterval = RMath::max(axisInterval[E_AXIS],limitInterval);
+#endif
+        }
+        else axisInterval[E_AXIS] = 0;
 #if NONLINEAR_SYSTEM
-    if(axis_diff[VIRTUAL_AXIS] >= 0)
-        axisInterval[VIRTUAL_AXIS] = fabs(axis_diff[VIRTUAL_AXIS])*F_CPU/(Printer::maxFeedrate[Z_AXIS]*stepsRemaining);
-    else
-        axisInterval[VIRTUAL_AXIS] = fabs(axis_diff[VIRTUAL_AXIS])*F_CPU/(Printer::maxFeedrate[E_AXIS]*stepsRemaining);
-    limitInterval = RMath::max(axisInterval[VIRTUAL_AXIS],limitInterval);
+        if(axis_diff[VIRTUAL_AXIS] >= 0)
+            axisInterval[VIRTUAL_AXIS] = fabs(axis_diff[VIRTUAL_AXIS])*F_CPU/(Printer::maxFeedrate[Z_AXIS]*stepsRemaining);
+        else
+            axisInterval[VIRTUAL_AXIS] = fabs(axis_diff[VIRTUAL_AXIS])*F_CPU/(Printer::maxFeedrate[E_AXIS]*stepsRemaining);
+        limitInterval = RMath::max(axisInterval[VIRTUAL_AXIS],limitInterval);
 #endif
-
+    }
     fullInterval = limitInterval = limitInterval>LIMIT_INTERVAL ? limitInterval : LIMIT_INTERVAL; // This is our target speed
     // new time at full speed = limitInterval*p->stepsRemaining [ticks]
     timeForMove = (float)limitInterval * (float)stepsRemaining; // for large z-distance this overflows with long computation
     float inv_time_s = (float)F_CPU / timeForMove;
+#if FIXED_POINT_PLANNER && !NONLINEAR_SYSTEM
+    if(fixedPoint)
+    {
+        uint32_t moveTicks = static_cast<uint32_t>(limitInterval) * static_cast<uint32_t>(stepsRemaining);
+        for(uint8_t i = 0; i < 4; i++)
+            if(isMoveOfAxis(i))
+                axisInterval[i] = HAL::Div4U2U(moveTicks, delta[i]);
+    }
+    else
+#endif
+    {
+        for(uint8_t i = 0; i < 4; i++)
+            if(isMoveOfAxis(i))
+                axisInterval[i] = timeForMove / delta[i];
+    }
     if(isXMove())
     {
-        axisInterval[X_AXIS] = timeForMove / delta[X_AXIS];
         speedX = axis_diff[X_AXIS] * inv_time_s;
         if(isXNegativeMove()) speedX = -speedX;
     }
     else speedX = 0;
     if(isYMove())
     {
-        axisInterval[Y_AXIS] = timeForMove/delta[Y_AXIS];
         speedY = axis_diff[Y_AXIS] * inv_time_s;
         if(isYNegativeMove()) speedY = -speedY;
     }
     else speedY = 0;
     if(isZMove())
     {
-        axisInterval[Z_AXIS] = timeForMove/delta[Z_AXIS];
         speedZ = axis_diff[Z_AXIS] * inv_time_s;
         if(isZNegativeMove()) speedZ = -speedZ;
     }
     else speedZ = 0;
     if(isEMove())
     {
-        axisInterval[E_AXIS] = timeForMove/delta[E_AXIS];
         speedE = axis_diff[E_AXIS] * inv_time_s;
         if(isENegativeMove()) speedE = -speedE;
     }
@@ -436,6 +539,9 @@ void PrintLine::calculateMove(float axis_diff[],uint8_t pathOptimize)
     // Make result permanent
     if (pathOptimize) waitRelax = 70;
     pushLine();
+#if CPU_ARCH==ARCH_HOST
+    HAL::benchmarkMoveEnd();
+#endif
     DEBUG_MEMORY;
 }
 
@@ -512,9 +618,24 @@ void PrintLine::updateTrapezoids()
         firstLine->unblock();
         return;
     }
-    backwardPlanner(linesWritePos,first);
+    uint8_t changed = backwardPlanner(linesWritePos,first);
     // Reduce speed to reachable speeds
-    forwardPlanner(first);
+    forwardPlanner(changed);
+    uint8_t replanned = (linesWritePos + MOVE_CACHE_SIZE - changed) % MOVE_CACHE_SIZE;
+    replannedLines += replanned;
+    plannerUpdates++;
+    if(replanned > maxReplanned) maxReplanned = replanned;
+#if CPU_ARCH==ARCH_HOST
+    HAL::benchmarkReplan(replanned);
+#endif
+    if(changed != first)   // Lines in front of changed are untouched, let the stepper have them
+    {
+        BEGIN_INTERRUPT_PROTECTED;
+        lines[changed].block();
+        firstLine->unblock();
+        END_INTERRUPT_PROTECTED;
+        first = changed;
+    }
 
     // Update precomputed data
     do
@@ -616,13 +737,28 @@ void PrintLine::updateStepsParameter()
     advanceStart = (float)advanceFull*startFactor * startFactor;
     advanceEnd   = (float)advanceFull*endFactor   * endFactor;
 #endif
+#endif
+#if S_CURVE_ACCELERATION
+    speed_t vPeak = vMax;
 #endif
     if(accelSteps+decelSteps >= stepsRemaining)   // can't reach limit speed
     {
         uint16_t red = (accelSteps+decelSteps + 2 - stepsRemaining) >> 1;
         accelSteps = accelSteps-RMath::min(accelSteps,red);
         decelSteps = decelSteps-RMath::min(decelSteps,red);
+#if S_CURVE_ACCELERATION
+        // Speed the linear ramp reaches after accelSteps
+        float peak = sqrt((float)vStart * (float)vStart + 2.0f * (float)accelerationPrim * (float)accelSteps);
+        if(peak < vMax) vPeak = peak;
+#endif
     }
+#if S_CURVE_ACCELERATION
+    // The curve needs the speed change of each ramp. Small changes keep the linear ramp.
+    sCurveAccelDv = (vPeak > vStart ? vPeak - vStart : 0);
+    sCurveDecelDv = (vPeak > vEnd ? vPeak - vEnd : 0);
+    sCurveAccelInv = (sCurveAccelDv > 256 ? 16777216UL / sCurveAccelDv : 0);
+    sCurveDecelInv = (sCurveDecelDv > 256 ? 16777216UL / sCurveDecelDv : 0);
+#endif
     setParameterUpToDate();
 #ifdef DEBUG_QUEUE_MOVE
     if(Printer::debugEcho())
@@ -647,8 +783,12 @@ The backwards planner traverses the moves from last to first looking at decelera
 
 start = last line inserted
 last = last element until we check
+
+The pass stops early at the first junction whose speed does not change. The speeds before it
+only depend on this junction, so they are still optimal from the last update.
+Returns the first line the forward planner has to look at.
 */
-inline void PrintLine::backwardPlanner(uint8_t start,uint8_t last)
+inline uint8_t PrintLine::backwardPlanner(uint8_t start,uint8_t last)
 {
     PrintLine *act = &lines[start],*previous;
     float lastJunctionSpeed = act->endSpeed; // Start always with safe speed
@@ -658,14 +798,8 @@ inline void PrintLine::backwardPlanner(uint8_t start,uint8_t last)
     {
         previousPlannerIndex(start);
         previous = &lines[start];
-        // Avoid speed calc once crusing in split delta move
 #if NONLINEAR_SYSTEM
-        if (previous->moveID == act->moveID && lastJunctionSpeed == previous->maxJunctionSpeed)
-        {
-            act->startSpeed = RMath::max(act->minSpeed,previous->endSpeed = lastJunctionSpeed);
-            previous->invalidateParameter();
-            act->invalidateParameter();
-        }
+        bool cruising = previous->moveID == act->moveID && lastJunctionSpeed == previous->maxJunctionSpeed;
 #endif
 
         /* if(prev->isEndSpeedFixed())   // Nothing to update from here on, happens when path optimize disabled
@@ -676,6 +810,23 @@ inline void PrintLine::backwardPlanner(uint8_t start,uint8_t last)
 
         // Avoid speed calcs if we know we can accelerate within the line
         lastJunctionSpeed = (act->isNominalMove() ? act->fullSpeed : sqrt(lastJunctionSpeed * lastJunctionSpeed + act->accelerationDistance2)); // acceleration is acceleration*distance*2! What can be reached if we try?
+        float endSpeed = (lastJunctionSpeed >= previous->maxJunctionSpeed ? RMath::max(previous->minSpeed,previous->maxJunctionSpeed) : RMath::max(lastJunctionSpeed,previous->minSpeed));
+#if NONLINEAR_SYSTEM
+        if(cruising && lastJunctionSpeed >= previous->maxJunctionSpeed)
+            endSpeed = previous->maxJunctionSpeed; // set below without the minimum speed
+#endif
+        // Nothing changes from here on, lines before previous keep their speeds
+        if(previous->endSpeed == endSpeed)
+            return start;
+        // Avoid speed calc once crusing in split delta move
+#if NONLINEAR_SYSTEM
+        if (cruising)
+        {
+            act->startSpeed = RMath::max(act->minSpeed,previous->endSpeed = previous->maxJunctionSpeed);
+            previous->invalidateParameter();
+            act->invalidateParameter();
+        }
+#endif
         // If that speed is more that the maximum junction speed allowed then ...
         if(lastJunctionSpeed >= previous->maxJunctionSpeed)   // Limit is reached
         {
@@ -703,6 +854,7 @@ inline void PrintLine::backwardPlanner(uint8_t start,uint8_t last)
         }
         act = previous;
     } // while loop
+    return last;
 }
 
 void PrintLine::forwardPlanner(uint8_t first)
@@ -806,7 +958,7 @@ processing.
 */
 uint8_t PrintLine::insertWaitMovesIfNeeded(uint8_t pathOptimize, uint8_t waitExtraLines)
 {
-    if(linesCount==0 && waitRelax==0 && pathOptimize)   // First line after some time - warmup needed
+    if(queuedLines()==0 && waitRelax==0 && pathOptimize)   // First line after some time - warmup needed
     {
 #if NONLINEAR_SYSTEM
         uint8_t w = 3;
@@ -822,6 +974,11 @@ uint8_t PrintLine::insertWaitMovesIfNeeded(uint8_t pathOptimize, uint8_t waitExt
             p->setWaitForXLinesFilled(w + waitExtraLines);
 #if NONLINEAR_SYSTEM
             p->setWaitTicks(50000);
+#if DELTA_LAZY_SEGMENTS
+            p->deltaSegmentsReady = 0;
+#elif DELTA_SEGMENT_POOL_SIZE
+            p->segmentsReserved = 0;
+#endif
 #else
             p->setWaitTicks(25000);
 #endif // NONLINEAR_SYSTEM
@@ -854,15 +1011,74 @@ void PrintLine::logLine()
 
 void PrintLine::waitForXFreeLines(uint8_t b)
 {
-    while(linesCount+b>MOVE_CACHE_SIZE)   // wait for a free entry in movement cache
+    while(queuedLines()+b>MOVE_CACHE_SIZE)   // wait for a free entry in movement cache
+    {
+        GCode::readFromSerial();
+        Commands::checkForPeriodicalActions();
+    }
+}
+
+/** Returns the average filament speed in mm/s of the queued moves printed within the next
+seconds. Only moves feeding filament count. current gets the filament speed of the move in
+print. The moves are timed at full speed, which is accurate enough for heater feed forward. */
+float PrintLine::queuedExtrusionRate(float seconds,float &current)
+{
+    uint8_t p,n;
+    BEGIN_INTERRUPT_PROTECTED
+    p = linesPos;
+    n = linesCount;
+    END_INTERRUPT_PROTECTED
+    float time = 0,filament = 0;
+    current = 0;
+    for(uint8_t i = 0; i < n && time < seconds; i++)
+    {
+        PrintLine *l = &lines[p];
+        nextPlannerIndex(p);
+        if(l->isWarmUp() || l->fullSpeed <= 0) continue;
+        float moveTime = l->distance * l->invFullSpeed;
+        if(l->isEPositiveMove())
+        {
+            filament += l->speedE * moveTime;
+            if(i == 0) current = l->speedE;
+        }
+        time += moveTime;
+    }
+    return time > 0 ? filament / time : 0;
+}
+
+#if DELTA_SEGMENT_POOL_SIZE
+/** Waits until the segment pool has room for n more segments. Lines leave the queue in the
+order they got their segments, so the free space is always one block behind the write position.
+A warmup line at the queue head waits for more lines, which can not come while the pool is full,
+so it is released early. */
+void PrintLine::waitForFreeDeltaSegments(uint8_t n)
+{
+    while(segmentPoolUsed + n > DELTA_SEGMENT_POOL_SIZE)
     {
+        if(linesCount && lines[linesPos].isWarmUp())
+            lines[linesPos].setWaitForXLinesFilled(0);
         GCode::readFromSerial();
         Commands::checkForPeriodicalActions();
     }
 }
+#endif
 
 
 #if DRIVE_SYSTEM == 3
+#if CPU_ARCH != ARCH_AVR
+/** Tower position for 32 bit processors. The squares are 64 bit products (one SMULL each), so no
+term can overflow, and HAL::integerSqrt rounds like the AVR assembler version. */
+static inline uint8_t deltaTowerSteps(long cartesianPosSteps[], long towerX, long towerY, uint32_t diagonalSquared, long &result)
+{
+    int64_t dx = towerX - cartesianPosSteps[X_AXIS];
+    int64_t dy = towerY - cartesianPosSteps[Y_AXIS];
+    int64_t opt = static_cast<int64_t>(diagonalSquared) - dx * dx - dy * dy;
+    if(opt < 0) return 0;
+    result = HAL::integerSqrt(static_cast<uint32_t>(opt)) + cartesianPosSteps[Z_AXIS];
+    return 1;
+}
+#endif
+
 /**
   Calculate the delta tower position from a cartesian position
   @param cartesianPosSteps Array containing cartesian coordinates.
@@ -900,6 +1116,11 @@ uint8_t transformCartesianStepsToDeltaSteps(long cartesianPosSteps[], long delta
     }
     else
     {
+#if CPU_ARCH != ARCH_AVR
+        return deltaTowerSteps(cartesianPosSteps, Printer::deltaAPosXSteps, Printer::deltaAPosYSteps, Printer::deltaDiagonalStepsSquaredA.l, deltaPosSteps[X_AXIS]) &&
+               deltaTowerSteps(cartesianPosSteps, Printer::deltaBPosXSteps, Printer::deltaBPosYSteps, Printer::deltaDiagonalStepsSquaredB.l, deltaPosSteps[Y_AXIS]) &&
+               deltaTowerSteps(cartesianPosSteps, Printer::deltaCPosXSteps, Printer::deltaCPosYSteps, Printer::deltaDiagonalStepsSquaredC.l, deltaPosSteps[Z_AXIS]);
+#else
         long temp = Printer::deltaAPosYSteps - cartesianPosSteps[Y_AXIS];
         long opt = Printer::deltaDiagonalStepsSquaredA.l - temp * temp;
         long temp2 = Printer::deltaAPosXSteps - cartesianPosSteps[X_AXIS];
@@ -935,6 +1156,7 @@ uint8_t transformCartesianStepsToDeltaSteps(long cartesianPosSteps[], long delta
 #endif
         else
             return 0;
+#endif // CPU_ARCH != ARCH_AVR
     }
     return 1;
 }
@@ -1075,7 +1297,7 @@ void DeltaSegment::checkEndstops(PrintLine *cur,bool checkall)
 
 }
 
-void PrintLine::calculateDirectionAndDelta(long difference[], flag8_t *dir, long delta[])
+void PrintLine::calculateDirectionAndDelta(long difference[], flag8_t *dir, int32_t delta[])
 {
     *dir = 0;
     //Find direction
@@ -1100,6 +1322,62 @@ void PrintLine::calculateDirectionAndDelta(long difference[], flag8_t *dir, long
 */
 inline uint16_t PrintLine::calculateDeltaSubSegments(uint8_t softEndstop)
 {
+#if DELTA_LAZY_SEGMENTS
+    // Segments are computed later by fillDeltaSegments. Here we only need the end position
+    // and an upper bound for the tower steps of one segment, which is the step count of the primary axis.
+    // The slope of a tower against the horizontal move is h/s with h the horizontal distance of the
+    // effector to the tower and s the height of the rod. h is largest at one end of the line.
+    long startTower[3], endTower[3];
+    if(!transformCartesianStepsToDeltaSteps(Printer::currentPositionSteps, startTower) ||
+            !transformCartesianStepsToDeltaSteps(Printer::destinationSteps, endTower))
+    {
+        Com::printWarningFLN(Com::tInvalidDeltaCoordinate);
+        return 0;
+    }
+    float n = static_cast<float>(numDeltaSegments);
+    float dx = static_cast<float>(Printer::destinationSteps[X_AXIS] - Printer::currentPositionSteps[X_AXIS]);
+    float dy = static_cast<float>(Printer::destinationSteps[Y_AXIS] - Printer::currentPositionSteps[Y_AXIS]);
+    float segXY = sqrt(dx * dx + dy * dy) / n + 1.5f; // + rounding of the segment ends
+    float segZ = fabs(static_cast<float>(Printer::destinationSteps[Z_AXIS] - Printer::currentPositionSteps[Z_AXIS])) / n + 1.0f;
+    float diagonal2[3];
+    if(Printer::isLargeMachine())
+    {
+        diagonal2[0] = Printer::deltaDiagonalStepsSquaredA.f;
+        diagonal2[1] = Printer::deltaDiagonalStepsSquaredB.f;
+        diagonal2[2] = Printer::deltaDiagonalStepsSquaredC.f;
+    }
+    else
+    {
+        diagonal2[0] = Printer::deltaDiagonalStepsSquaredA.l;
+        diagonal2[1] = Printer::deltaDiagonalStepsSquaredB.l;
+        diagonal2[2] = Printer::deltaDiagonalStepsSquaredC.l;
+    }
+    float maxMove = 0;
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        deltaStart[i] = Printer::currentPositionSteps[i];
+        deltaStartTower[i] = Printer::currentDeltaPositionSteps[i];
+        float height = static_cast<float>(RMath::min(startTower[i] - Printer::currentPositionSteps[Z_AXIS],
+                                          endTower[i] - Printer::destinationSteps[Z_AXIS]) - 1);
+        float move;
+        if(height < 1.0f)
+            move = 65535.0f;
+        else
+            move = segZ + segXY * sqrt(RMath::max(diagonal2[i] - height * height, 0.0f)) / height + 2.0f;
+        // The first segment also moves the tower from the stored position to the computed one
+        move += labs(startTower[i] - Printer::currentDeltaPositionSteps[i]);
+        if(move > maxMove) maxMove = move;
+        if (softEndstop && endTower[i] > Printer::maxDeltaPositionSteps)
+            endTower[i] = Printer::maxDeltaPositionSteps;
+        Printer::currentDeltaPositionSteps[i] = endTower[i];
+    }
+    deltaSoftEndstop = softEndstop;
+    deltaSegmentsReady = 0;
+#ifdef DEBUG_STEPCOUNT
+    totalStepsRemaining = 0;
+#endif
+    return (maxMove >= 65535.0f ? 65535 : static_cast<uint16_t>(maxMove));
+#else
     uint8_t i;
     long delta,diff;
     long destinationSteps[3], destinationDeltaSteps[3];
@@ -1123,7 +1401,7 @@ inline uint16_t PrintLine::calculateDeltaSubSegments(uint8_t softEndstop)
 #if !(CPU_ARCH == ARCH_AVR && !defined(EXACT_DELTA_MOVES))
         float segment = static_cast<float>(numDeltaSegments-s+1);
 #endif
-        DeltaSegment *d = &segments[s-1];
+        DeltaSegment *d = getDeltaSegment(s-1);
         for(i=0; i < NUM_AXIS - 1; i++) // End of segment in cartesian steps
         {
 #if CPU_ARCH == ARCH_AVR && !defined(EXACT_DELTA_MOVES)
@@ -1191,7 +1469,113 @@ inline uint16_t PrintLine::calculateDeltaSubSegments(uint8_t softEndstop)
 //		out.println_long_P(PSTR("totalStepsRemaining:"), p->totalStepsRemaining);
 #endif
     return max_axis_move;
+#endif // DELTA_LAZY_SEGMENTS
+}
+
+#if DELTA_LAZY_SEGMENTS
+/**
+  Computes the delta segments of the queued lines into deltaRing until it is full. Called from the main loop,
+  the stepper interrupt only takes the finished segments. The segment ends are interpolated like
+  calculateDeltaSubSegments does with EXACT_DELTA_MOVES.
+*/
+void PrintLine::fillDeltaSegments()
+{
+#if CPU_ARCH==ARCH_HOST
+    if(HAL::benchmark) return;
+#endif
+    while(deltaRingCount < DELTA_LAZY_SEGMENTS_BUFFER)
+    {
+        uint8_t left = deltaGenLeft;
+        if(!left)
+        {
+            // Start the next line. The stepper waits at the start of a line until it has a segment,
+            // so it does not touch the line before we set it up here.
+            bool queued;
+            BEGIN_INTERRUPT_PROTECTED
+            queued = deltaGenLines < linesCount;
+            if(queued)
+            {
+                uint8_t p = linesPos + deltaGenLines;
+                if(p >= MOVE_CACHE_SIZE) p -= MOVE_CACHE_SIZE;
+                deltaGenLines++;
+                PrintLine *line = &lines[p];
+                if(!line->isWarmUp() && line->numDeltaSegments)
+                {
+                    deltaGenLine = line;
+                    deltaGenSegments = deltaGenLeft = line->numDeltaSegments;
+                    deltaGenMaxSteps = line->numPrimaryStepPerSegment;
+                    for(uint8_t i = 0; i < 3; i++)
+                    {
+                        deltaGenDiff[i] = (line->dir & (1 << i) ? line->delta[i] : -line->delta[i]);
+                        deltaGenPos[i] = line->deltaStartTower[i];
+                    }
+                }
+            }
+            END_INTERRUPT_PROTECTED
+            if(!queued) return;
+            continue;
+        }
+        PrintLine *p = deltaGenLine;
+        DeltaSegment d;
+        long cartesian[3], tower[3];
+        float segment = static_cast<float>(deltaGenSegments - left + 1);
+        for(uint8_t i = 0; i < 3; i++)
+            cartesian[i] = static_cast<int32_t>(floor(0.5 + static_cast<float>(deltaGenDiff[i]) / static_cast<float>(deltaGenSegments) * segment)) + p->deltaStart[i];
+        if(transformCartesianStepsToDeltaSteps(cartesian, tower))
+        {
+            d.dir = 0;
+            for(uint8_t i = 0; i < 3; i++)
+            {
+                if (p->deltaSoftEndstop && tower[i] > Printer::maxDeltaPositionSteps)
+                    tower[i] = Printer::maxDeltaPositionSteps;
+                long delta = tower[i] - deltaGenPos[i];
+                if(labs(delta) > deltaGenMaxSteps) // Outside the bound from calculateDeltaSubSegments, the next segment does the rest
+                {
+#ifdef DEBUG_DELTA_OVERFLOW
+                    Com::printFLN(Com::tDBGDeltaOverflow, delta);
+#endif
+                    delta = (delta > 0 ? deltaGenMaxSteps : -(long)deltaGenMaxSteps);
+                    tower[i] = deltaGenPos[i] + delta;
+                }
+                if (delta > 0)
+                {
+                    d.dir |= 17<<i;
+                    d.deltaSteps[i] = delta;
+                }
+                else
+                {
+                    d.dir |= 16<<i;
+                    d.deltaSteps[i] = -delta;
+                }
+            }
+        }
+        else
+        {
+            // Illegal position - ignore move
+            Com::printWarningFLN(Com::tInvalidDeltaCoordinate);
+            d.dir = 0;
+            d.deltaSteps[X_AXIS] = d.deltaSteps[Y_AXIS] = d.deltaSteps[Z_AXIS] = 0;
+            for(uint8_t i = 0; i < 3; i++)
+                tower[i] = deltaGenPos[i];
+        }
+        BEGIN_INTERRUPT_PROTECTED
+        if(deltaGenLeft == left) // else the stepper dropped the line meanwhile
+        {
+            deltaRing[deltaRingWrite] = d;
+            deltaRingWrite = (deltaRingWrite + 1) & (DELTA_LAZY_SEGMENTS_BUFFER - 1);
+            deltaRingCount++;
+            p->deltaSegmentsReady++;
+            deltaGenLeft--;
+#ifdef DEBUG_STEPCOUNT
+            p->totalStepsRemaining += d.deltaSteps[X_AXIS] + d.deltaSteps[Y_AXIS] + d.deltaSteps[Z_AXIS];
+#endif
+        }
+        END_INTERRUPT_PROTECTED
+        for(uint8_t i = 0; i < 3; i++)
+            deltaGenPos[i] = tower[i];
+    }
 }
+#endif
 
 uint8_t PrintLine::calculateDistance(float axisDiff[], uint8_t dir, float *distance)
 {
@@ -1271,6 +1655,11 @@ inline void PrintLine::queueEMove(long extrudeDiff,uint8_t check_endstops,uint8_
     Printer::currentPositionSteps[E_AXIS] = Printer::destinationSteps[E_AXIS];
 
     p->numDeltaSegments = 0;
+#if DELTA_LAZY_SEGMENTS
+    p->deltaSegmentsReady = 0;
+#elif DELTA_SEGMENT_POOL_SIZE
+    p->segmentsReserved = 0;
+#endif
     //Define variables that are needed for the Bresenham algorithm. Please note that  Z is not currently included in the Bresenham algorithm.
     p->primaryAxis = E_AXIS;
     p->stepsRemaining = p->delta[E_AXIS];
@@ -1288,6 +1677,9 @@ inline void PrintLine::queueEMove(long extrudeDiff,uint8_t check_endstops,uint8_
 */
 void PrintLine::queueDeltaMove(uint8_t check_endstops,uint8_t pathOptimize, uint8_t softEndstop)
 {
+#if CPU_ARCH==ARCH_HOST
+    if(HAL::motionStream && HAL::motionStreamMove(check_endstops,pathOptimize,softEndstop)) return;
+#endif
     //if (softEndstop && Printer::destinationSteps[Z_AXIS] < 0) Printer::destinationSteps[Z_AXIS] = 0; // now constrained at entry level including cylinder test
     long difference[NUM_AXIS];
     float axis_diff[5]; // Axis movement in mm. Virtual axis in 4;
@@ -1316,7 +1708,7 @@ void PrintLine::queueDeltaMove(uint8_t check_endstops,uint8_t pathOptimize, uint
 
     float cartesianDistance;
     flag8_t cartesianDir;
-    long cartesianDeltaSteps[4];
+    int32_t cartesianDeltaSteps[4];
     calculateDirectionAndDelta(difference, &cartesianDir, cartesianDeltaSteps);
     if (!calculateDistance(axis_diff, cartesianDir, &cartesianDistance))
         return;
@@ -1364,7 +1756,7 @@ void PrintLine::queueDeltaMove(uint8_t check_endstops,uint8_t pathOptimize, uint
     // There could be some error here but it doesn't matter since the number of segments will just be reduced slightly
     int segmentsPerLine = segmentCount / numLines;
 
-    int32_t start_position[4], fractional_steps[4];
+    long start_position[4], fractional_steps[4];
     if(numLines>1)
     {
         for (uint8_t i = 0; i < 4; i++)
@@ -1421,6 +1813,10 @@ void PrintLine::queueDeltaMove(uint8_t check_endstops,uint8_t pathOptimize, uint
 
         p->flags = (check_endstops ? FLAG_CHECK_ENDSTOPS : 0);
         p->numDeltaSegments = segmentsPerLine;
+#if DELTA_SEGMENT_POOL_SIZE
+        waitForFreeDeltaSegments(segmentsPerLine);
+        p->reserveDeltaSegments(segmentsPerLine);
+#endif
 
         int32_t max_delta_step = p->calculateDeltaSubSegments(softEndstop);
 
@@ -1430,6 +1826,9 @@ void PrintLine::queueDeltaMove(uint8_t check_endstops,uint8_t pathOptimize, uint
         int32_t virtual_axis_move = max_delta_step * segmentsPerLine;
         if (virtual_axis_move == 0 && p->delta[E_AXIS] == 0)
         {
+#if DELTA_SEGMENT_POOL_SIZE
+            p->unreserveDeltaSegments();
+#endif
             if (numLines!=1)
                 Com::printErrorFLN(Com::tDBGDeltaNoMoveinDSegment);
             return;  // Line too short in low precision area
@@ -1628,10 +2027,10 @@ long PrintLine::bresenhamStep() // Version for delta printer
         setCurrentLine();
         if(cur->isBlocked())   // This step is in computation - shouldn't happen
         {
-            if(lastblk != (int)cur)
+            if(lastblk != (int)(cur - lines))
             {
                 HAL::allowInterrupts();
-                lastblk = (int)cur;
+                lastblk = (int)(cur - lines);
                 Com::printFLN(Com::tBLK,linesCount);
             }
             cur = NULL;
@@ -1676,6 +2075,17 @@ long PrintLine::bresenhamStep() // Version for delta printer
             return 1000;
         }
 #endif
+#if DELTA_LAZY_SEGMENTS
+        if(cur->numDeltaSegments && !cur->deltaSegmentsReady) // fillDeltaSegments did not reach this line yet
+        {
+            deltaRingUnderruns++;
+            cur = NULL;
+#if CPU_ARCH==ARCH_ARM
+            PrintLine::nlFlag = false;
+#endif
+            return 400;
+        }
+#endif
 
         if(cur->isEMove()) Extruder::enable();
         cur->fixStartAndEndSpeed();
@@ -1684,7 +2094,7 @@ long PrintLine::bresenhamStep() // Version for delta printer
         {
 
             // If there are delta segments point to them here
-            curd = &cur->segments[--cur->numDeltaSegments];
+            curd = takeDeltaSegment();
             // Enable axis - All axis are enabled since they will most probably all be involved in a move
             // Since segments could involve different axis this reduces load when switching segments and
             // makes disabling easier.
@@ -1748,6 +2158,15 @@ long PrintLine::bresenhamStep() // Version for delta printer
             return Printer::interval; // Wait an other 50% from last step to make the 100% full
     } // End cur=0
     HAL::allowInterrupts();
+#if DELTA_LAZY_SEGMENTS
+    // Wait if a segment this call may switch to is not computed yet
+    if(curd && stepsPerSegRemaining <= Printer::stepsPerTimerCall &&
+            cur->deltaSegmentsReady < RMath::min((uint8_t)cur->numDeltaSegments, Printer::stepsPerTimerCall))
+    {
+        deltaRingUnderruns++;
+        return 400;
+    }
+#endif
 
     /* For halfstepping, we divide the actions into even and odd actions to split
        time used per loop. */
@@ -1838,7 +2257,8 @@ long PrintLine::bresenhamStep() // Version for delta printer
                     {
                         firstFull = true;
                         // Get the next delta segment
-                        curd = &cur->segments[--cur->numDeltaSegments];
+                        releaseDeltaSegment();
+                        curd = takeDeltaSegment();
 
                         // Initialize bresenham for this segment (numPrimaryStepPerSegment is already correct for the half step setting)
                         cur->error[X_AXIS] = cur->error[Y_AXIS] = cur->error[Z_AXIS] = cur->numPrimaryStepPerSegment >> 1;
@@ -1895,7 +2315,10 @@ long PrintLine::bresenhamStep() // Version for delta printer
                         }
                     }
                     else
+                    {
+                        releaseDeltaSegment();
                         curd = 0;// Release the last segment
+                    }
                     //deltaSegmentCount--;
                 }
             }
@@ -1921,7 +2344,11 @@ long PrintLine::bresenhamStep() // Version for delta printer
             if (cur->moveAccelerating())
             {
                 firstFull = false;
+#if S_CURVE_ACCELERATION
+                Printer::vMaxReached = sCurveSpeedChange(HAL::ComputeV(Printer::timer,cur->fAcceleration),cur->sCurveAccelDv,cur->sCurveAccelInv) + cur->vStart;
+#else
                 Printer::vMaxReached = HAL::ComputeV(Printer::timer,cur->fAcceleration) + cur->vStart;
+#endif
                 if(Printer::vMaxReached>cur->vMax) Printer::vMaxReached = cur->vMax;
                 speed_t v = Printer::updateStepsPerTimerCall(Printer::vMaxReached);
                 Printer::interval = HAL::CPUDivU2(v);
@@ -1931,6 +2358,9 @@ long PrintLine::bresenhamStep() // Version for delta printer
             else if (cur->moveDecelerating())     // time to slow down
             {
                 speed_t v = HAL::ComputeV(Printer::timer,cur->fAcceleration);
+#if S_CURVE_ACCELERATION
+                v = sCurveSpeedChange(v,cur->sCurveDecelDv,cur->sCurveDecelInv);
+#endif
                 if (v > Printer::vMaxReached)   // if deceleration goes too far it can become too large
                     v = cur->vEnd;
                 else
@@ -2007,6 +2437,13 @@ long PrintLine::bresenhamStep() // Version for delta printer
 #endif
         //HAL::forbidInterrupts();
         //deltaSegmentCount -= cur->numDeltaSegments; // should always be zero
+#if DELTA_LAZY_SEGMENTS
+        if(curd) // line stopped early
+        {
+            releaseDeltaSegment();
+            curd = 0;
+        }
+#endif
         removeCurrentLineForbidInterrupt();
         Printer::disableAllowedStepper();
         if(linesCount == 0) UI_STATUS(UI_TEXT_IDLE);
@@ -2032,6 +2469,62 @@ long PrintLine::bresenhamStep() // Version for delta printer
 */
 int lastblk=-1;
 long cur_errupd;
+#if STEP_TIMING_QUEUE || STEP_EVENT_RING
+/** Advances the bresenham error terms of the current line by one step and returns the
+axes that have to step. Advance extruder steps are counted here, they are not sent with the mask. */
+inline uint8_t PrintLine::bresenhamStepMask()
+{
+    uint8_t mask = 0;
+    if(cur->isEMove())
+    {
+        if((cur->error[E_AXIS] -= cur->delta[E_AXIS]) < 0)
+        {
+#if defined(USE_ADVANCE)
+            if(Printer::isAdvanceActivated())   // Use interrupt for movement
+            {
+                if(cur->isEPositiveMove())
+                    Printer::extruderStepsNeeded++;
+                else
+                    Printer::extruderStepsNeeded--;
+            }
+            else
+#endif
+                mask |= STEP_QUEUE_E;
+            cur->error[E_AXIS] += cur_errupd;
+        }
+    }
+    if(cur->isXMove())
+    {
+        if((cur->error[X_AXIS] -= cur->delta[X_AXIS]) < 0)
+        {
+            mask |= STEP_QUEUE_X;
+            cur->error[X_AXIS] += cur_errupd;
+        }
+    }
+    if(cur->isYMove())
+    {
+        if((cur->error[Y_AXIS] -= cur->delta[Y_AXIS]) < 0)
+        {
+            mask |= STEP_QUEUE_Y;
+            cur->error[Y_AXIS] += cur_errupd;
+        }
+    }
+    if(cur->isZMove())
+    {
+        if((cur->error[Z_AXIS] -= cur->delta[Z_AXIS]) < 0)
+        {
+            mask |= STEP_QUEUE_Z;
+            cur->error[Z_AXIS] += cur_errupd;
+        }
+    }
+#ifdef DEBUG_STEPCOUNT
+    if(mask & STEP_QUEUE_X) cur->totalStepsRemaining--;
+    if(mask & STEP_QUEUE_Y) cur->totalStepsRemaining--;
+    if(mask & STEP_QUEUE_Z) cur->totalStepsRemaining--;
+#endif
+    return mask;
+}
+#endif
 long PrintLine::bresenhamStep() // version for cartesian printer
 {
 #if CPU_ARCH==ARCH_ARM
@@ -2083,6 +2576,10 @@ long PrintLine::bresenhamStep() // version for cartesian printer
             return(wait); // waste some time for path optimization to fill up
         } // End if WARMUP
         //Only enable axis that are moving. If the axis doesn't need to move then it can stay disabled depending on configuration.
+#if STEP_EVENT_RING
+        if(stepRingClassic) // Otherwise the interrupt enables them with the first event of the line
+        {
+#endif
 #ifdef XY_GANTRY
         if(cur->isXOrYMove())
         {
@@ -2098,6 +2595,9 @@ long PrintLine::bresenhamStep() // version for cartesian printer
             Printer::enableZStepper();
         }
         if(cur->isEMove()) Extruder::enable();
+#if STEP_EVENT_RING
+        }
+#endif
         cur->fixStartAndEndSpeed();
         HAL::allowInterrupts();
         cur_errupd = (cur->isFullstepping() ? cur->delta[cur->primaryAxis] : cur->delta[cur->primaryAxis]<<1);;
@@ -2110,6 +2610,23 @@ long PrintLine::bresenhamStep() // version for cartesian printer
         Printer::timer = 0;
         HAL::forbidInterrupts();
         //Determine direction of movement,check if endstop was hit
+#if STEP_EVENT_RING
+        if(!stepRingClassic) // The interrupt sets the directions with the first event of the line
+        {
+            stepRingFlags = STEP_EVENT_LINE_START | (cur->dir & (cur->dir >> 4) & 15) | (cur->isCheckEndstops() ? STEP_EVENT_CHECK_XY : 0);
+            stepRingLinesStarted++;
+        }
+        else
+        {
+            Printer::setXDirection(cur->isXPositiveMove());
+            Printer::setYDirection(cur->isYPositiveMove());
+            Printer::setZDirection(cur->isZPositiveMove());
+#if defined(USE_ADVANCE)
+            if(!Printer::isAdvanceActivated()) // Set direction if no advance/OPS enabled
+#endif
+                Extruder::setDirection(cur->isEPositiveMove());
+        }
+#else
 #if !defined(XY_GANTRY)
         Printer::setXDirection(cur->isXPositiveMove());
         Printer::setYDirection(cur->isYPositiveMove());
@@ -2128,6 +2645,7 @@ long PrintLine::bresenhamStep() // version for cartesian printer
         if(!Printer::isAdvanceActivated()) // Set direction if no advance/OPS enabled
 #endif
             Extruder::setDirection(cur->isEPositiveMove());
+#endif // STEP_EVENT_RING
 #ifdef USE_ADVANCE
 #ifdef ENABLE_QUADRATIC_ADVANCE
         Printer::advanceExecuted = cur->advanceStart;
@@ -2153,10 +2671,29 @@ long PrintLine::bresenhamStep() // version for cartesian printer
     uint8_t doOdd = cur->halfStep & 5;
     if(cur->halfStep!=4) cur->halfStep = 3-(cur->halfStep);
     HAL::forbidInterrupts();
+#if STEP_EVENT_RING
+    if(doEven && stepRingClassic) cur->checkEndstops(); // Otherwise the interrupt checks them per event
+#else
     if(doEven) cur->checkEndstops();
-    uint8_t max_loops = RMath::min((long)Printer::stepsPerTimerCall,cur->stepsRemaining);
+#endif
+    uint8_t max_loops = RMath::min((long)Printer::stepsPerTimerCall,(long)cur->stepsRemaining);
     if(cur->stepsRemaining>0)
     {
+#if STEP_EVENT_RING
+        if(!stepRingClassic)
+        {
+            for(uint8_t loop=0; loop<max_loops; loop++)
+                stepRingSteps[loop] = bresenhamStepMask();
+            stepRingStepCount = max_loops;
+        }
+        else
+#endif
+#if STEP_TIMING_QUEUE
+        // Send the first step now, the others are sent evenly spaced by the next interrupts
+        stepAxes(bresenhamStepMask());
+        for(uint8_t loop=1; loop<max_loops; loop++)
+            stepQueue[loop-1] = bresenhamStepMask();
+#else
         for(uint8_t loop=0; loop<max_loops; loop++)
         {
             ANALYZER_ON(ANALYZER_CH1);
@@ -2220,6 +2757,7 @@ long PrintLine::bresenhamStep() // version for cartesian printer
                 Extruder::unstep();
             Printer::endXYZSteps();
         } // for loop
+#endif
         if(doOdd)  // Update timings
         {
             HAL::allowInterrupts(); // Allow interrupts for other types, timer1 is still disabled
@@ -2227,7 +2765,11 @@ long PrintLine::bresenhamStep() // version for cartesian printer
             //If acceleration is enabled on this move and we are in the acceleration segment, calculate the current interval
             if (cur->moveAccelerating())   // we are accelerating
             {
+#if S_CURVE_ACCELERATION
+                Printer::vMaxReached = sCurveSpeedChange(HAL::ComputeV(Printer::timer,cur->fAcceleration),cur->sCurveAccelDv,cur->sCurveAccelInv) + cur->vStart;
+#else
                 Printer::vMaxReached = HAL::ComputeV(Printer::timer,cur->fAcceleration)+cur->vStart;
+#endif
                 if(Printer::vMaxReached>cur->vMax) Printer::vMaxReached = cur->vMax;
                 unsigned int v = Printer::updateStepsPerTimerCall(Printer::vMaxReached);
                 Printer::interval = HAL::CPUDivU2(v);
@@ -2237,6 +2779,9 @@ long PrintLine::bresenhamStep() // version for cartesian printer
             else if (cur->moveDecelerating())     // time to slow down
             {
                 unsigned int v = HAL::ComputeV(Printer::timer,cur->fAcceleration);
+#if S_CURVE_ACCELERATION
+                v = sCurveSpeedChange(v,cur->sCurveDecelDv,cur->sCurveDecelInv);
+#endif
                 if (v > Printer::vMaxReached)   // if deceleration goes too far it can become too large
                     v = cur->vEnd;
                 else
@@ -2300,17 +2845,246 @@ long PrintLine::bresenhamStep() // version for cartesian printer
             Com::printF(Com::tDBGMissedSteps,cur->totalStepsRemaining);
             Com::printFLN(Com::tComma,cur->stepsRemaining);
         }
+#endif
+#if STEP_EVENT_RING
+        if(!stepRingClassic) // Steps are still in the ring, the line stays queued until its end event is sent
+        {
+            HAL::forbidInterrupts();
+            stepRingLines++;
+            stepRingEndFlags = STEP_EVENT_LINE_END;
+        }
 #endif
         removeCurrentLineForbidInterrupt();
-        Printer::disableAllowedStepper();
-        if(linesCount == 0) UI_STATUS(UI_TEXT_IDLE);
+#if STEP_TIMING_QUEUE
+        if(DISABLE_X || DISABLE_Y || DISABLE_Z)   // Drivers get switched off, send the queued steps now
+        {
+            for(uint8_t loop=1; loop<max_loops; loop++)
+            {
+#if STEPPER_HIGH_DELAY+DOUBLE_STEP_DELAY > 0
+                HAL::delayMicroseconds(STEPPER_HIGH_DELAY+DOUBLE_STEP_DELAY);
+#endif
+                stepAxes(stepQueue[loop-1]);
+            }
+            max_loops = 1;
+        }
+#endif
+#if STEP_EVENT_RING
+        if(stepRingClassic)
+#endif
+            Printer::disableAllowedStepper();
+        if(queuedLines() == 0) UI_STATUS(UI_TEXT_IDLE);
         interval = Printer::interval = interval >> 1; // 50% of time to next call to do cur=0
         DEBUG_MEMORY;
     } // Do even
+#if STEP_TIMING_QUEUE
+    if(max_loops > 1)   // Spread the queued steps over the time until the next call
+    {
+        stepQueueInterval = (max_loops == 2 ? interval >> 1 : interval >> 2);
+        stepQueuePos = 0;
+        stepQueueLength = max_loops - 1;
+        stepQueueLastWait = interval - stepQueueInterval * stepQueueLength;
+        interval = stepQueueInterval;
+    }
+#endif
+#if STEP_EVENT_RING
+    if(FEATURE_BABYSTEPPING && Printer::zBabystepsMissing && stepRingClassic)
+#else
     if(FEATURE_BABYSTEPPING && Printer::zBabystepsMissing)
+#endif
     {
         Printer::zBabystep();
     }
     return interval;
 }
+#if STEP_EVENT_RING
+/** \brief Converts the next steps of the current line into step events.
+
+Called from the main loop. Runs bresenhamStep outside of the interrupt until the ring is full
+or no line is ready. A line that needs stepping inside the interrupt (see
+needsInterruptStepping) is left to nextStepEvent, which first drains the ring.
+\param oneCall Only write the events of one bresenhamStep call. Used by nextStepEvent when the
+main loop is behind.
+*/
+void PrintLine::fillStepRing(bool oneCall)
+{
+#if CPU_ARCH==ARCH_HOST
+    if(HAL::benchmark) return;
+#endif
+    stepRingFilling = true;
+    fillStepRingEvents(oneCall);
+    stepRingFilling = false;
+}
+
+void PrintLine::fillStepRingEvents(bool oneCall)
+{
+    bool written = false;
+    if(stepRingAbort)
+    {
+        // All axes of the line hit their endstops. Finish it like checkEndstops would.
+        if(cur != NULL && stepRingLinesStarted == stepRingAbortLine)
+            cur->dir &= 15;
+        stepRingAbort = false;
+    }
+    while(((stepRingWrite + 1) & STEP_EVENT_RING_MASK) != stepRingRead)
+    {
+        if(!stepRingFlags && !stepRingStepCount && !stepRingWait)
+        {
+            // All events of the last call are written, compute the next steps
+            if(stepRingClassic || (oneCall && written)) return;
+            if(cur == NULL)
+            {
+                if(!linesCount) return;
+                PrintLine *line = &lines[linesPos];
+                if(line->isBlocked() || (line->isWarmUp() && linesCount <= line->getWaitForXLinesFilled()))
+                    return;
+                if(!line->isWarmUp() && line->needsInterruptStepping())
+                {
+                    stepRingClassic = true;
+                    return;
+                }
+            }
+            long wait = bresenhamStep();
+            HAL::allowInterrupts();
+            // Spread the steps of one call evenly over the time to the next call
+            long sub = (stepRingStepCount <= 2 ? wait >> 1 : wait >> 2);
+            stepRingSub = (sub > 65535 ? 65535 : sub);
+            stepRingStepPos = 0;
+            stepRingWait = (stepRingStepCount ? wait - (long)stepRingSub * (stepRingStepCount - 1) : wait);
+            continue;
+        }
+        StepEvent *ev = &stepRing[stepRingWrite];
+        if(stepRingFlags) // Line start, takes no time and gets the moving axes as steps
+        {
+            ev->steps = (cur->dir >> 4) & 15;
+            ev->interval = 0;
+            ev->flags = stepRingFlags;
+            stepRingFlags = 0;
+        }
+        else if(stepRingStepCount > 1)
+        {
+            ev->steps = stepRingSteps[stepRingStepPos++];
+            ev->interval = stepRingSub;
+            ev->flags = 0;
+            stepRingStepCount--;
+        }
+        else
+        {
+            // Last step of the call or the remaining wait, split into 16 bit intervals
+            ev->steps = (stepRingStepCount ? stepRingSteps[stepRingStepPos] : 0);
+            stepRingStepCount = 0;
+            ev->interval = (stepRingWait > 65535 ? 65535 : stepRingWait);
+            stepRingWait -= ev->interval;
+            ev->flags = stepRingEndFlags;
+            stepRingEndFlags = 0;
+        }
+        stepRingWrite = (stepRingWrite + 1) & STEP_EVENT_RING_MASK;
+        written = true;
+    }
+}
+
+/** \brief Timer interrupt part of the step event ring.
+
+Sends the next event. With an empty ring the line is either stepped here with bresenhamStep,
+or the main loop is behind, which counts as underrun while a line is running. Then the events
+of the next bresenhamStep call are computed here, so the move goes on at its speed instead of
+stopping. Only if the main loop is just filling the ring, the interrupt waits for it.
+Returns the ticks to the next call.
+*/
+long PrintLine::nextStepEvent()
+{
+    uint8_t fill;
+    bool refilled = false;
+    for(;;)
+    {
+        while((fill = (stepRingWrite - stepRingRead) & STEP_EVENT_RING_MASK) != 0)
+        {
+            if(cur != NULL && fill < stepRingMinFill) stepRingMinFill = fill;
+            StepEvent *ev = &stepRing[stepRingRead];
+            uint8_t flags = ev->flags;
+            uint8_t steps = ev->steps;
+            long wait = ev->interval;
+            stepRingRead = (stepRingRead + 1) & STEP_EVENT_RING_MASK;
+            if(stepRingSkip && !(flags & (STEP_EVENT_LINE_START | STEP_EVENT_LINE_END)))
+                continue; // Rest of a line stopped by endstops
+            if(flags & STEP_EVENT_LINE_START)
+            {
+                stepRingSkip = false;
+                stepRingLinesSent++;
+                stepRingDir = flags;
+                stepRingAxes = steps;
+                stepRingStopped = 0;
+                // Enabled here and not when the events were computed, as the end event of
+                // the previous line may still disable them.
+#ifdef XY_GANTRY
+                if(steps & (STEP_QUEUE_X | STEP_QUEUE_Y))
+                {
+                    Printer::enableXStepper();
+                    Printer::enableYStepper();
+                }
+#else
+                if(steps & STEP_QUEUE_X) Printer::enableXStepper();
+                if(steps & STEP_QUEUE_Y) Printer::enableYStepper();
+#endif
+                if(steps & STEP_QUEUE_Z) Printer::enableZStepper();
+                if(steps & STEP_QUEUE_E) Extruder::enable();
+                Printer::setXDirection(flags & STEP_QUEUE_X);
+                Printer::setYDirection(flags & STEP_QUEUE_Y);
+                Printer::setZDirection(flags & STEP_QUEUE_Z);
+                Extruder::setDirection(flags & STEP_QUEUE_E);
+                continue;
+            }
+            if(steps)
+            {
+                uint8_t stopped = stepRingStopped;
+                if(stepRingDir & STEP_EVENT_CHECK_XY)
+                {
+                    if((steps & STEP_QUEUE_X) && ((stepRingDir & STEP_QUEUE_X) ? Printer::isXMaxEndstopHit() : Printer::isXMinEndstopHit()))
+                        stopped |= STEP_QUEUE_X;
+                    if((steps & STEP_QUEUE_Y) && ((stepRingDir & STEP_QUEUE_Y) ? Printer::isYMaxEndstopHit() : Printer::isYMinEndstopHit()))
+                        stopped |= STEP_QUEUE_Y;
+                }
+                // Test Z-Axis every step, otherwise it could easyly ruin your printer!
+                if((steps & STEP_QUEUE_Z) && ((stepRingDir & STEP_QUEUE_Z) ? Printer::isZMaxEndstopHit() : Printer::isZMinEndstopHit()))
+                    stopped |= STEP_QUEUE_Z;
+                if(stopped != stepRingStopped)
+                {
+                    stepRingStopped = stopped;
+                    if(!(stepRingAxes & ~stopped)) // Nothing left to move, let fillStepRing end the line
+                    {
+                        stepRingSkip = true;
+                        stepRingAbortLine = stepRingLinesSent;
+                        stepRingAbort = true;
+                    }
+                }
+                stepAxes(steps & ~stopped);
+            }
+            if(flags & STEP_EVENT_LINE_END)
+            {
+                stepRingSkip = false;
+                Printer::disableAllowedStepper();
+                if(!--stepRingLines && !linesCount)
+                {
+                    queueEmptyEvents++;
+                    Printer::setMenuMode(MENU_MODE_PRINTING,false);
+                    UI_STATUS(UI_TEXT_IDLE);
+                }
+            }
+            if(FEATURE_BABYSTEPPING && Printer::zBabystepsMissing)
+                Printer::zBabystep();
+            return wait;
+        }
+        if(stepRingClassic)
+        {
+            long wait = bresenhamStep();
+            if(cur == NULL) stepRingClassic = false;
+            return wait;
+        }
+        if(cur != NULL && !stepRingSkip && !refilled) stepRingUnderruns++;
+        if(refilled || stepRingFilling || stepRingSkip || !linesCount) break;
+        fillStepRing(true); // The main loop is behind, compute the next steps like without the ring
+        refilled = true;
+    }
+    return 400; // Check again soon, the main loop fills the ring
+}
+#endif
 #endif
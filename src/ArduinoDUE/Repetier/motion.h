@@ -50,11 +50,41 @@
 #define FLAG_JOIN_WAIT_EXTRUDER_UP 64
 /** Wait for the extruder to finish it's down movement */
 #define FLAG_JOIN_WAIT_EXTRUDER_DOWN 128
+#if STEP_TIMING_QUEUE || STEP_EVENT_RING
+/** Axis bits of the step timing queue and step event entries */
+#define STEP_QUEUE_X 1
+#define STEP_QUEUE_Y 2
+#define STEP_QUEUE_Z 4
+#define STEP_QUEUE_E 8
+#endif
+#if STEP_EVENT_RING
+/** First event of a line, the direction bits are valid */
+#define STEP_EVENT_LINE_START 16
+/** Last event of a line, disable the steppers allowed to be disabled */
+#define STEP_EVENT_LINE_END 32
+/** Stop x and y at their endstops */
+#define STEP_EVENT_CHECK_XY 64
+#define STEP_EVENT_RING_MASK (STEP_EVENT_RING_SIZE - 1)
+
+/** Step event produced by PrintLine::fillStepRing and sent by the timer interrupt. */
+typedef struct
+{
+    uint16_t interval;  ///< Ticks until the next event.
+    uint8_t steps;      ///< STEP_QUEUE_* bits of the axes to step.
+    uint8_t flags;      ///< STEP_EVENT_* flags, at a line start also the positive direction bits.
+} StepEvent;
+#endif
 // Printing related data
 #if NONLINEAR_SYSTEM
 // Allow the delta cache to store segments for every line in line cache. Beware this gets big ... fast.
 // MAX_DELTA_SEGMENTS_PER_LINE *
+#if DELTA_LAZY_SEGMENTS
+#define DELTA_CACHE_SIZE DELTA_LAZY_SEGMENTS_BUFFER
+#elif DELTA_SEGMENT_POOL_SIZE
+#define DELTA_CACHE_SIZE DELTA_SEGMENT_POOL_SIZE
+#else
 #define DELTA_CACHE_SIZE (MAX_DELTA_SEGMENTS_PER_LINE * MOVE_CACHE_SIZE)
+#endif
 
 class PrintLine;
 typedef struct
@@ -161,6 +191,7 @@ class UIDisplay;
 class PrintLine   // RAM usage: 24*4+15 = 113 Byte
 {
     friend class UIDisplay;
+    friend class HAL; // host simulator logs the planned lines
 #if CPU_ARCH==ARCH_ARM
     static volatile bool nlFlag;
 #endif
@@ -193,7 +224,17 @@ private:
     uint8_t numDeltaSegments;		///< Number of delta segments left in line. Decremented by stepper timer.
     uint8_t moveID;					///< ID used to identify moves which are all part of the same line
     int32_t numPrimaryStepPerSegment;	///< Number of primary bresenham axis steps in each delta segment
+#if DELTA_LAZY_SEGMENTS
+    long deltaStart[3];             ///< Cartesian start of the line in steps.
+    long deltaStartTower[3];        ///< Tower positions at the start of the line.
+    uint8_t deltaSegmentsReady;     ///< Computed segments of this line in deltaRing not taken by the stepper.
+    bool deltaSoftEndstop;
+#elif DELTA_SEGMENT_POOL_SIZE
+    uint16_t segmentsPos;           ///< Index of the first segment of this line in segmentPool.
+    uint8_t segmentsReserved;       ///< Pool entries held by this line, freed when the line is finished.
+#else
     DeltaSegment segments[MAX_DELTA_SEGMENTS_PER_LINE];
+#endif
 #endif
     ticks_t fullInterval;     ///< interval at full speed in ticks/step.
     uint16_t accelSteps;        ///< How much steps does it take, to reach the plateau.
@@ -203,6 +244,12 @@ private:
     speed_t vMax;              ///< Maximum reached speed in steps/s.
     speed_t vStart;            ///< Starting speed in steps/s.
     speed_t vEnd;              ///< End speed in steps/s
+#if S_CURVE_ACCELERATION
+    speed_t sCurveAccelDv;     ///< Speed change of the acceleration phase in steps/s.
+    speed_t sCurveDecelDv;     ///< Speed change of the deceleration phase in steps/s.
+    uint16_t sCurveAccelInv;   ///< 2^24/sCurveAccelDv, 0 for a linear ramp.
+    uint16_t sCurveDecelInv;   ///< 2^24/sCurveDecelDv, 0 for a linear ramp.
+#endif
 #ifdef USE_ADVANCE
 #ifdef ENABLE_QUADRATIC_ADVANCE
     int32_t advanceRate;               ///< Advance steps at full speed
@@ -219,6 +266,69 @@ public:
     int32_t stepsRemaining;            ///< Remaining steps, until move is finished
     static PrintLine *cur;
     static volatile uint8_t linesCount; // Number of lines cached 0 = nothing to do
+    static uint32_t plannerUpdates; // Planner runs, with replannedLines the average lines changed per move
+    static uint32_t replannedLines;
+    static uint8_t maxReplanned;        ///< Most lines changed by one planner run.
+    static uint32_t queueEmptyEvents;   ///< Times the stepper finished the last queued line.
+    static uint32_t cacheLowSlowdowns;  ///< Moves slowed down because less than MOVE_CACHE_LOW lines were queued.
+    static uint16_t maxStepTicks;       ///< Longest stepper interrupt in ticks, measured by the HAL.
+    /** Called by the stepper interrupt with the ticks since the timer fired. */
+    static inline void recordStepTicks(uint16_t ticks)
+    {
+        if(ticks > maxStepTicks) maxStepTicks = ticks;
+    }
+#if STEP_TIMING_QUEUE
+    static uint8_t stepQueue[3];        ///< Axis bits of the steps left from the last bresenhamStep call.
+    static uint8_t stepQueuePos;
+    static uint8_t stepQueueLength;     ///< Number of queued steps not sent yet.
+    static long stepQueueInterval;      ///< Ticks between two queued steps.
+    static long stepQueueLastWait;      ///< Ticks from the last queued step to the next bresenhamStep call.
+#endif
+#if STEP_EVENT_RING
+    static StepEvent stepRing[STEP_EVENT_RING_SIZE];
+    static volatile uint8_t stepRingRead;
+    static volatile uint8_t stepRingWrite;
+    static volatile bool stepRingClassic;  ///< Head line is stepped by bresenhamStep inside the interrupt.
+    static uint8_t stepRingDir;         ///< Direction and check flags of the line the interrupt is stepping.
+    static uint8_t stepRingStopped;     ///< Axes of that line stopped by an endstop.
+    static uint8_t stepRingAxes;        ///< Axes moved by that line.
+    static bool stepRingSkip;           ///< All axes stopped, drop the remaining events of that line.
+    static uint8_t stepRingLinesSent;   ///< Line starts sent by the interrupt.
+    static uint8_t stepRingLinesStarted; ///< Line starts written by fillStepRing.
+    static volatile uint8_t stepRingAbortLine; ///< Line to finish early, stepRingLinesSent at the endstop hit.
+    static volatile bool stepRingAbort;
+    static uint8_t stepRingSteps[4];    ///< Step bits from the last bresenhamStep call not written to the ring.
+    static uint8_t stepRingStepPos;
+    static uint8_t stepRingStepCount;
+    static uint16_t stepRingSub;        ///< Ticks between these steps.
+    static long stepRingWait;           ///< Ticks left after the last of these steps.
+    static uint8_t stepRingFlags;       ///< Flags for the next event.
+    static uint8_t stepRingEndFlags;    ///< Flags for the event with the last step.
+    static uint32_t stepRingUnderruns;  ///< Interrupts that found the ring empty during a move.
+    static uint8_t stepRingMinFill;     ///< Lowest ring fill level seen during moves.
+    static volatile uint8_t stepRingLines; ///< Lines removed by fillStepRing whose line end event was not sent.
+    static volatile bool stepRingFilling; ///< fillStepRing runs in the main loop.
+#endif
+#if DELTA_LAZY_SEGMENTS
+    static DeltaSegment deltaRing[DELTA_LAZY_SEGMENTS_BUFFER];
+    static uint8_t deltaRingRead;           ///< Segment the stepper executes or takes next.
+    static uint8_t deltaRingWrite;
+    static volatile uint8_t deltaRingCount; ///< Computed segments including the one being executed.
+    static volatile uint8_t deltaGenLines;  ///< Lines at the queue head fillDeltaSegments has started.
+    static volatile uint8_t deltaGenLeft;   ///< Segments of the last started line still to compute, 0 drops the rest.
+    static PrintLine *deltaGenLine;
+    static long deltaGenDiff[3];            ///< Cartesian move of deltaGenLine in steps.
+    static uint8_t deltaGenSegments;        ///< Segments of deltaGenLine.
+    static long deltaGenPos[3];             ///< Tower positions after the last computed segment.
+    static uint16_t deltaGenMaxSteps;       ///< numPrimaryStepPerSegment of deltaGenLine.
+    static uint32_t deltaRingUnderruns;     ///< Stepper calls that had to wait for a segment.
+    static uint8_t deltaRingMinFill;        ///< Lowest number of segments computed ahead during moves.
+#endif
+#if DELTA_SEGMENT_POOL_SIZE
+    static DeltaSegment segmentPool[DELTA_SEGMENT_POOL_SIZE];
+    static uint16_t segmentPoolWritePos;   ///< Index where the next line gets its segments.
+    static volatile uint16_t segmentPoolUsed; ///< Segments held by queued lines.
+#endif
     inline bool areParameterUpToDate()
     {
         return joinFlags & FLAG_JOIN_STEPPARAMS_COMPUTED;
@@ -429,6 +539,24 @@ public:
     {
         linesCount = 0;
         linesPos = linesWritePos;
+#if STEP_EVENT_RING
+        BEGIN_INTERRUPT_PROTECTED
+        stepRingRead = stepRingWrite;
+        stepRingLines = 0;
+        stepRingFlags = stepRingEndFlags = stepRingStepCount = 0;
+        stepRingWait = 0;
+        stepRingClassic = stepRingSkip = stepRingAbort = false;
+        stepRingLinesSent = stepRingLinesStarted;
+        END_INTERRUPT_PROTECTED
+#endif
+#if DELTA_LAZY_SEGMENTS
+        deltaRingRead = deltaRingWrite;
+        deltaRingCount = 0;
+        deltaGenLines = deltaGenLeft = 0;
+#endif
+#if DELTA_SEGMENT_POOL_SIZE
+        segmentPoolUsed = 0;
+#endif
     }
     inline void updateAdvanceSteps(speed_t v,uint8_t max_loops,bool accelerate)
     {
@@ -489,6 +617,33 @@ public:
     {
         return Printer::stepNumber <= accelSteps;
     }
+#if S_CURVE_ACCELERATION
+    /** \brief Converts the speed change of the linear ramp into the S-curve speed change.
+
+    linear is the speed change the linear ramp has reached, dv the speed change of the whole
+    ramp and inv = 2^24/dv. u = linear/dv is the time in the ramp, the result is
+    dv*(10u^3-15u^4+6u^5) with u and the polynomial in 1/65536 units. On the AVR all math is
+    16x16 bit multiplications. 32 bit processors can have dv above 65535, so the last product
+    is computed with 64 bit there.
+    */
+    static inline speed_t sCurveSpeedChange(speed_t linear,speed_t dv,uint16_t inv)
+    {
+        if(!inv) return linear;
+        uint32_t u32 = HAL::mulu16xu16to32(linear,inv) >> 8;
+        if(u32 >= 65535) return dv;
+        uint16_t u = u32;
+        uint16_t u2 = HAL::mulu6xu16shift16(u,u);
+        uint16_t u3 = HAL::mulu6xu16shift16(u2,u);
+        uint16_t poly = 40960 - ((15UL * u) >> 4) + ((6UL * u2) >> 4); // 10-15u+6u^2 in 1/4096 units
+        uint32_t f = HAL::mulu16xu16to32(u3,poly) >> 12;
+        if(f >= 65535) return dv;
+#if CPU_ARCH == ARCH_AVR
+        return HAL::mulu6xu16shift16(dv,f);
+#else
+        return (static_cast<uint64_t>(dv) * f) >> 16;
+#endif
+    }
+#endif
     inline bool isFullstepping()
     {
         return halfStep == 4;
@@ -579,6 +734,55 @@ public:
         WRITE(Z2_STEP_PIN,HIGH);
 #endif
     }
+#if STEP_TIMING_QUEUE || STEP_EVENT_RING
+    /** \brief Sends one step pulse for all axes set in mask.
+
+    Direction pins are already set by bresenhamStep, so this only toggles the step pins.
+    */
+    static inline void stepAxes(uint8_t mask)
+    {
+        if(mask & STEP_QUEUE_E) Extruder::step();
+        if(mask & STEP_QUEUE_X)
+        {
+            WRITE(X_STEP_PIN,HIGH);
+#if FEATURE_TWO_XSTEPPER
+            WRITE(X2_STEP_PIN,HIGH);
+#endif
+        }
+        if(mask & STEP_QUEUE_Y)
+        {
+            WRITE(Y_STEP_PIN,HIGH);
+#if FEATURE_TWO_YSTEPPER
+            WRITE(Y2_STEP_PIN,HIGH);
+#endif
+        }
+        if(mask & STEP_QUEUE_Z)
+        {
+            WRITE(Z_STEP_PIN,HIGH);
+#if FEATURE_TWO_ZSTEPPER
+            WRITE(Z2_STEP_PIN,HIGH);
+#endif
+        }
+        Printer::insertStepperHighDelay();
+        if(mask & STEP_QUEUE_E) Extruder::unstep();
+        Printer::endXYZSteps();
+    }
+#endif
+#if STEP_TIMING_QUEUE
+    static inline bool hasQueuedSteps()
+    {
+        return stepQueueLength;
+    }
+    /** \brief Sends the next queued step. Called by the timer interrupt instead of bresenhamStep
+    while steps are queued. Returns the ticks to the next interrupt.
+    */
+    static inline long sendQueuedStep()
+    {
+        stepAxes(stepQueue[stepQueuePos++]);
+        if(--stepQueueLength) return stepQueueInterval;
+        return stepQueueLastWait;
+    }
+#endif
     void updateStepsParameter();
     inline float safeSpeed();
     void calculateMove(float axis_diff[],uint8_t pathOptimize);
@@ -594,7 +798,20 @@ public:
 
     static inline bool hasLines()
     {
+#if STEP_EVENT_RING
+        return linesCount || stepRingRead != stepRingWrite;
+#else
         return linesCount;
+#endif
+    }
+    /** Lines in the queue, including those whose step events are still in the ring. */
+    static inline uint8_t queuedLines()
+    {
+#if STEP_EVENT_RING
+        return linesCount + stepRingLines;
+#else
+        return linesCount;
+#endif
     }
     static inline void setCurrentLine()
     {
@@ -603,8 +820,16 @@ public:
         PrintLine::nlFlag = true;
 #endif
     }
+    /** Removes the current line and gives its delta segments back, whatever the reason
+    for the removal is. Returns with interrupts forbidden. */
     static inline void removeCurrentLineForbidInterrupt()
     {
+#if DELTA_LAZY_SEGMENTS
+        dropDeltaSegments();
+#elif DELTA_SEGMENT_POOL_SIZE
+        HAL::forbidInterrupts();
+        cur->freeDeltaSegments();
+#endif
         linesPos++;
         if(linesPos>=MOVE_CACHE_SIZE) linesPos=0;
         cur = NULL;
@@ -613,8 +838,11 @@ public:
 #endif
         HAL::forbidInterrupts();
         --linesCount;
-        if(!linesCount)
+        if(!queuedLines())
+        {
+            queueEmptyEvents++;
             Printer::setMenuMode(MENU_MODE_PRINTING,false);
+        }
     }
     static inline void pushLine()
     {
@@ -629,11 +857,110 @@ public:
     {
         return &lines[linesWritePos];
     }
+#if NONLINEAR_SYSTEM
+#if DELTA_LAZY_SEGMENTS
+    static void fillDeltaSegments();
+    /** \brief Takes the next segment of the current line, called by the stepper interrupt. */
+    static inline DeltaSegment *takeDeltaSegment()
+    {
+        cur->numDeltaSegments--;
+        cur->deltaSegmentsReady--;
+        if(deltaRingCount - 1 < deltaRingMinFill) deltaRingMinFill = deltaRingCount - 1;
+        return &deltaRing[deltaRingRead];
+    }
+    /** \brief Gives the executed segment back to fillDeltaSegments. */
+    static inline void releaseDeltaSegment()
+    {
+        deltaRingRead = (deltaRingRead + 1) & (DELTA_LAZY_SEGMENTS_BUFFER - 1);
+        deltaRingCount--;
+    }
+    /** Drops the computed segments of a line removed before it used them and stops
+    fillDeltaSegments if it still works on that line. */
+    static inline void dropDeltaSegments()
+    {
+        deltaRingRead = (deltaRingRead + cur->deltaSegmentsReady) & (DELTA_LAZY_SEGMENTS_BUFFER - 1);
+        deltaRingCount -= cur->deltaSegmentsReady;
+        cur->deltaSegmentsReady = 0;
+        if(deltaGenLines && --deltaGenLines == 0)
+            deltaGenLeft = 0;
+    }
+#else
+    static inline DeltaSegment *takeDeltaSegment()
+    {
+        return cur->getDeltaSegment(--cur->numDeltaSegments);
+    }
+    static inline void releaseDeltaSegment() {}
+    /** \brief Delta segment n of this line. The stepper executes them from numDeltaSegments-1 down to 0. */
+    inline DeltaSegment *getDeltaSegment(uint8_t n)
+    {
+#if DELTA_SEGMENT_POOL_SIZE
+        uint16_t i = segmentsPos + n;
+        if(i >= DELTA_SEGMENT_POOL_SIZE) i -= DELTA_SEGMENT_POOL_SIZE;
+        return &segmentPool[i];
+#else
+        return &segments[n];
+#endif
+    }
+#endif // DELTA_LAZY_SEGMENTS
+#if DELTA_SEGMENT_POOL_SIZE
+    static void waitForFreeDeltaSegments(uint8_t n);
+    inline void reserveDeltaSegments(uint8_t n)
+    {
+        segmentsPos = segmentPoolWritePos;
+        segmentsReserved = n;
+        segmentPoolWritePos += n;
+        if(segmentPoolWritePos >= DELTA_SEGMENT_POOL_SIZE) segmentPoolWritePos -= DELTA_SEGMENT_POOL_SIZE;
+        BEGIN_INTERRUPT_PROTECTED
+        segmentPoolUsed += n;
+        END_INTERRUPT_PROTECTED
+    }
+    /** Gives the segments of the last reserved line back, if it does not get queued. */
+    inline void unreserveDeltaSegments()
+    {
+        segmentPoolWritePos = segmentsPos;
+        BEGIN_INTERRUPT_PROTECTED
+        segmentPoolUsed -= segmentsReserved;
+        END_INTERRUPT_PROTECTED
+        segmentsReserved = 0;
+    }
+    /** Called by removeCurrentLineForbidInterrupt with interrupts forbidden. */
+    inline void freeDeltaSegments()
+    {
+        segmentPoolUsed -= segmentsReserved;
+        segmentsReserved = 0;
+    }
+#endif
+#endif
     static inline void computeMaxJunctionSpeed(PrintLine *previous,PrintLine *current);
     static long bresenhamStep();
+#if STEP_TIMING_QUEUE || STEP_EVENT_RING
+    static inline uint8_t bresenhamStepMask();
+#endif
+#if STEP_EVENT_RING
+    static void fillStepRing(bool oneCall = false);
+    static void fillStepRingEvents(bool oneCall);
+    static long nextStepEvent();
+    inline bool needsInterruptStepping()
+    {
+#if defined(USE_ADVANCE)
+        if(Printer::isAdvanceActivated()) return true;
+#endif
+#if FEATURE_Z_PROBE
+        if(Printer::isZProbingActive() && isZNegativeMove()) return true;
+#endif
+#if MAX_HARDWARE_ENDSTOP_Z
+        if(isZPositiveMove()) return true;
+#endif
+#ifdef INCLUDE_DEBUG_NO_MOVE
+        if(Printer::debugNoMoves()) return true;
+#endif
+        return false;
+    }
+#endif
     static void waitForXFreeLines(uint8_t b=1);
+    static float queuedExtrusionRate(float seconds,float &current);
     static inline void forwardPlanner(uint8_t p);
-    static inline void backwardPlanner(uint8_t p,uint8_t last);
+    static inline uint8_t backwardPlanner(uint8_t p,uint8_t last);
     static void updateTrapezoids();
     static uint8_t insertWaitMovesIfNeeded(uint8_t pathOptimize, uint8_t waitExtraLines);
     static void queueCartesianMove(uint8_t check_endstops,uint8_t pathOptimize);
@@ -654,7 +981,7 @@ public:
     static void queueDeltaMove(uint8_t check_endstops,uint8_t pathOptimize, uint8_t softEndstop);
     static inline void queueEMove(long e_diff,uint8_t check_endstops,uint8_t pathOptimize);
     inline uint16_t calculateDeltaSubSegments(uint8_t softEndstop);
-    static inline void calculateDirectionAndDelta(long difference[], flag8_t *dir, long delta[]);
+    static inline void calculateDirectionAndDelta(long difference[], flag8_t *dir, int32_t delta[]);
     static inline uint8_t calculateDistance(float axis_diff[], uint8_t dir, float *distance);
 #ifdef SOFTWARE_LEVELING && DRIVE_SYSTEM==3
     static void calculatePlane(long factors[], long p1[], long p2[], long p3[]);
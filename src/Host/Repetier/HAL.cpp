@@ -0,0 +1,1494 @@
+/*
+    This file is part of Repetier-Firmware.
+
+    Repetier-Firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Repetier-Firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Repetier-Firmware.  If not, see <http://www.gnu.org/licenses/>.
+
+    This firmware is a nearly complete rewrite of the sprinter firmware
+    by kliment (https://github.com/kliment/Sprinter)
+    which based on Tonokip RepRap firmware rewrite based off of Hydra-mmm firmware.
+*/
+
+#include "Repetier.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+extern void setup();
+extern void loop();
+
+uint64_t HAL::ticks = 0;
+volatile bool HAL::interruptsEnabled = true;
+bool HAL::insideInterrupt = false;
+uint8_t HAL::pinState[HOST_NUM_PINS];
+uint8_t HAL::pinLogged[HOST_NUM_PINS];
+uint8_t HAL::pinRole[HOST_NUM_PINS];
+int32_t HAL::motorSteps[3];
+FILE *HAL::pinLog = NULL;
+uint8_t HAL::virtualEeprom[EEPROM_BYTES];
+bool HAL::benchmark = false;
+FILE *HAL::planLog = NULL;
+FILE *HAL::motionStream = NULL;
+
+/** Serial emulation. Bytes are read from serialInFd and arrive in the
+receive ring with the timing of the selected baudrate. A baudrate of 0
+delivers them as fast as the firmware reads. If the ring is full, the
+sender waits like a host with flow control, so nothing gets lost. */
+static int serialInFd = 0;
+static FILE *serialOut = stdout;
+static long serialBaud = 0;
+static bool serialEof = false;
+static uint8_t serialBuffer[4096];
+static int serialBufferPos = 0;
+static int serialBufferLen = 0;
+static uint64_t serialNextByte = 0; ///< Tick when the next byte has arrived.
+uint8_t HAL::serialRxBuffer[SERIAL_RX_BUFFER_SIZE];
+uint16_t HAL::serialRxHead = 0;
+uint16_t HAL::serialRxTailPos = 0;
+uint16_t HAL::serialRxHighWaterMark = 0;
+static long idleExitMillis = 2000; ///< Stop after this idle time once input is exhausted.
+static uint64_t lastActivity = 0;
+
+// Compare values of the simulated timers in ticks
+static uint64_t timer1Compare = 0;
+static uint64_t pwmCompare = 0;
+#if defined(USE_ADVANCE)
+static uint64_t extruderCompare = 0;
+#endif
+
+/** sqrt((i + 16.5) * 2^26), seeds for the normalised argument of integerSqrt.
+Same code as the Due version. */
+static const uint16_t sqrtSeed[48] =
+{
+    33276, 34270, 35235, 36175, 37091, 37985, 38858, 39712,
+    40548, 41368, 42171, 42959, 43733, 44494, 45242, 45977,
+    46702, 47415, 48117, 48809, 49492, 50166, 50830, 51486,
+    52134, 52773, 53405, 54030, 54647, 55258, 55862, 56459,
+    57051, 57636, 58215, 58789, 59357, 59919, 60477, 61029,
+    61576, 62119, 62657, 63190, 63719, 64243, 64763, 65279
+};
+
+uint32_t HAL::integerSqrt(uint32_t a)
+{
+    if(a == 0) return 0;
+    uint8_t shift = __builtin_clz(a) & 30; // even, so the root shifts by half of it
+    uint32_t r = sqrtSeed[((a << shift) >> 26) - 16] >> (shift >> 1);
+    r = (r + a / r) >> 1;
+    r = (r + a / r) >> 1; // >= floor(sqrt(a)), off by at most one
+    if(static_cast<uint64_t>(r) * r > a) r--;
+    if(a - r * r > r) r++; // a >= (r + 0.5)^2
+    return r;
+}
+
+// Planner benchmark results, times in nanoseconds of wall clock
+static uint64_t benchMoves = 0;
+static uint64_t benchFirstStart = 0;
+static uint64_t benchLastEnd = 0;
+static uint64_t benchMoveStart = 0;
+static uint64_t benchMoveTime = 0;
+static uint64_t benchMoveWorst = 0;
+static uint64_t benchReplans = 0;
+static uint64_t benchReplanLines = 0;
+static uint8_t benchReplanMax = 0;
+
+static uint64_t wallNanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+HAL::HAL()
+{
+    //ctor
+}
+
+HAL::~HAL()
+{
+    //dtor
+}
+
+void HAL::delayMicroseconds(unsigned int delayUs)
+{
+    uint64_t end = ticks + (uint64_t)delayUs * (F_CPU / 1000000);
+    // Inside an interrupt routine the delay just consumes time
+    while(!insideInterrupt && interruptsEnabled && ticks < end)
+    {
+        uint64_t next = timer1Compare < pwmCompare ? timer1Compare : pwmCompare;
+        if(next >= end) break;
+        simulateInterrupts();
+    }
+    if(ticks < end) ticks = end;
+}
+
+void HAL::delayMilliseconds(unsigned int delayMs)
+{
+    while(delayMs > 0)
+    {
+        delayMicroseconds(1000);
+        delayMs--;
+    }
+}
+
+void HAL::serialSetBaudrate(long baud)
+{
+    // Command line -b wins over the configured baudrate
+    if(serialBaud < 0)
+        serialBaud = baud;
+}
+
+static void serialFill()
+{
+    if(serialBufferPos < serialBufferLen || serialEof) return;
+    ssize_t n = read(serialInFd, serialBuffer, sizeof(serialBuffer));
+    if(n > 0)
+    {
+        serialBufferPos = 0;
+        serialBufferLen = (int)n;
+        if(serialNextByte < HAL::ticks) // line was idle
+            serialNextByte = HAL::ticks;
+    }
+    else if(n == 0 || (errno != EAGAIN && errno != EINTR))
+        serialEof = true;
+}
+
+void HAL::serialReceive()
+{
+    uint64_t byteTicks = serialBaud > 0 ? (uint64_t)F_CPU * 10 / serialBaud : 0;
+    uint16_t used = (serialRxHead - serialRxTailPos) & SERIAL_RX_BUFFER_MASK;
+    while(true)
+    {
+        serialFill();
+        if(serialBufferPos >= serialBufferLen || ticks < serialNextByte) break;
+        if(used == SERIAL_RX_BUFFER_MASK)
+        {
+            serialNextByte = ticks + byteTicks; // sender continues when there is space
+            break;
+        }
+        serialRxBuffer[serialRxHead] = serialBuffer[serialBufferPos++];
+        serialRxHead = (serialRxHead + 1) & SERIAL_RX_BUFFER_MASK;
+        serialNextByte += byteTicks;
+        used++;
+        lastActivity = ticks;
+    }
+    if(used > serialRxHighWaterMark) serialRxHighWaterMark = used;
+}
+
+bool HAL::serialByteAvailable()
+{
+    serialReceive();
+    return serialRxHead != serialRxTailPos;
+}
+
+uint8_t HAL::serialReadByte()
+{
+    if(!serialByteAvailable()) return 0;
+    uint8_t c = serialRxBuffer[serialRxTailPos];
+    serialRxConsume(1);
+    return c;
+}
+
+void HAL::serialWriteByte(char b)
+{
+    fputc(b, serialOut);
+}
+
+void HAL::serialFlush()
+{
+    fflush(serialOut);
+}
+
+void HAL::setupTimer()
+{
+    timer1Compare = ticks + 65500;
+    pwmCompare = ticks + F_CPU / PWM_CLOCK_FREQ;
+#if defined(USE_ADVANCE)
+    extruderCompare = ticks + 256 * TIMER0_PRESCALE;
+#endif
+}
+
+void HAL::showStartReason()
+{
+    Com::printInfoFLN(Com::tPowerUp);
+}
+
+int HAL::getFreeRam()
+{
+    return MAX_RAM;
+}
+
+void HAL::benchmarkMoveStart()
+{
+    if(!benchmark) return;
+    benchMoveStart = wallNanos();
+    if(benchMoves == 0) benchFirstStart = benchMoveStart;
+}
+
+void HAL::benchmarkMoveEnd()
+{
+    if(!benchmark) return;
+    benchLastEnd = wallNanos();
+    uint64_t t = benchLastEnd - benchMoveStart;
+    benchMoves++;
+    benchMoveTime += t;
+    if(t > benchMoveWorst) benchMoveWorst = t;
+}
+
+void HAL::benchmarkReplan(uint8_t depth)
+{
+    if(!benchmark) return;
+    benchReplans++;
+    benchReplanLines += depth;
+    if(depth > benchReplanMax) benchReplanMax = depth;
+}
+
+static void benchmarkReport()
+{
+    if(!HAL::benchmark) return;
+    double seconds = (benchLastEnd - benchFirstStart) * 1e-9;
+    fprintf(stderr, "Planner benchmark\n");
+    fprintf(stderr, "  moves:             %llu\n", (unsigned long long)benchMoves);
+    fprintf(stderr, "  elapsed:           %.3f s\n", seconds);
+    fprintf(stderr, "  moves/s:           %.0f overall, %.0f in calculateMove\n",
+            seconds > 0 ? benchMoves / seconds : 0.0,
+            benchMoveTime ? benchMoves * 1e9 / benchMoveTime : 0.0);
+    fprintf(stderr, "  calculateMove:     avg %.2f us, worst %.2f us\n",
+            benchMoves ? benchMoveTime * 1e-3 / benchMoves : 0.0, benchMoveWorst * 1e-3);
+    fprintf(stderr, "  updateTrapezoids:  %llu replans, avg %.2f lines, max %d lines changed\n",
+            (unsigned long long)benchReplans, benchReplans ? (double)benchReplanLines / benchReplans : 0.0,
+            (int)benchReplanMax);
+#if DELTA_SEGMENT_POOL_SIZE
+    fprintf(stderr, "  segment pool:      %u of %d segments still used\n", (unsigned)PrintLine::segmentPoolUsed,
+            (int)DELTA_SEGMENT_POOL_SIZE);
+#endif
+}
+
+/** SD card emulation for -S. The card answers the SPI mode commands of Sd2Card like an
+SDHC card, its contents are a FAT16 volume built in memory from the given files. Every
+byte costs the SPI transfer time of the selected rate and the card adds the access
+times of a slow card, so a blocking read stalls the main loop like on the printer while
+the timer interrupts continue. */
+#define SD_IMAGE_BLOCKS 131072    // 64 MB card
+#define SD_VOLUME_START 64        // first block of the partition
+#define SD_RESERVED_BLOCKS 4
+#define SD_FAT_BLOCKS 128
+#define SD_ROOT_ENTRIES 512
+#define SD_BLOCKS_PER_CLUSTER 4
+#define SD_READ_LATENCY_US 500    // first block of CMD17 and CMD18
+#define SD_STREAM_LATENCY_US 40   // following blocks of CMD18
+#define SD_WRITE_LATENCY_US 1000  // programming time of CMD24
+#define SD_MULTI_WRITE_LATENCY_US 300 // programming time per block of CMD25
+
+enum SdCardState {SD_CARD_IDLE, SD_CARD_WRITE_TOKEN, SD_CARD_WRITE_DATA};
+
+static uint8_t *sdImage = NULL;
+static uint8_t sdSpiRate = 0;
+static uint64_t sdSpiTicks = 0;           ///< Transfer time not yet passed to delayMicroseconds.
+static uint8_t sdCommand[6];
+static uint8_t sdCommandLength = 0;
+static uint8_t sdResponse[516];           ///< R1 response, registers or data block with token and crc
+static int sdResponsePos = 0, sdResponseLength = 0;
+static uint32_t sdWaitBytes = 0;          ///< 0xff bytes before the next data block
+static uint32_t sdBusyBytes = 0;          ///< 0x00 bytes while a write is programmed
+static uint32_t sdDataBlock = 0xffffffff; ///< Block to send after sdWaitBytes
+static uint32_t sdStreamBlock = 0xffffffff; ///< Next block of an open CMD18
+static bool sdStreamStarted = false;
+static bool sdAppCommand = false, sdIdle = true, sdMultiWrite = false;
+static SdCardState sdState = SD_CARD_IDLE;
+static uint32_t sdWriteBlock = 0;
+static int sdWritePos = 0;
+static uint8_t sdWriteBuffer[514];
+static unsigned long sdSingleReads = 0, sdMultiReads = 0, sdStreamedBlocks = 0, sdWrites = 0, sdMultiWrites = 0;
+static unsigned long sdFatReads = 0;
+static int sdFragment = 0; ///< -f: free cluster after every sdFragment clusters of a file
+
+#if SDSUPPORT
+// SdFatUtil::FreeRam looks for the heap of the AVR libc
+namespace SdFatUtil
+{
+int __bss_end;
+int *__brkval;
+}
+#endif
+
+static void sdPut16(uint8_t *p, uint16_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void sdPut32(uint8_t *p, uint32_t v)
+{
+    sdPut16(p, v);
+    sdPut16(p + 2, v >> 16);
+}
+
+/** CRC16-CCITT of data blocks, Sd2Card checks it with USE_SD_CRC. */
+static uint16_t sdCrc16(const uint8_t *data, int n)
+{
+    uint16_t crc = 0;
+    while(n--)
+    {
+        crc ^= (uint16_t)*data++ << 8;
+        for(int i = 0; i < 8; i++)
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+/** Builds the FAT16 image from a comma separated list of files. Names that are no valid
+8.3 names get a long filename entry. Returns false if a file can not be read. */
+static bool sdBuildImage(char *files)
+{
+    sdImage = (uint8_t *)calloc(SD_IMAGE_BLOCKS, 512);
+    uint32_t volumeBlocks = SD_IMAGE_BLOCKS - SD_VOLUME_START;
+    uint8_t *mbr = sdImage;
+    mbr[450] = 0x06; // FAT16 partition
+    sdPut32(mbr + 454, SD_VOLUME_START);
+    sdPut32(mbr + 458, volumeBlocks);
+    mbr[510] = 0x55;
+    mbr[511] = 0xaa;
+    uint8_t *boot = sdImage + SD_VOLUME_START * 512;
+    memcpy(boot, "\xeb\x3c\x90REPHOST ", 11);
+    sdPut16(boot + 11, 512);
+    boot[13] = SD_BLOCKS_PER_CLUSTER;
+    sdPut16(boot + 14, SD_RESERVED_BLOCKS);
+    boot[16] = 2;
+    sdPut16(boot + 17, SD_ROOT_ENTRIES);
+    boot[21] = 0xf8;
+    sdPut16(boot + 22, SD_FAT_BLOCKS);
+    sdPut32(boot + 28, SD_VOLUME_START);
+    sdPut32(boot + 32, volumeBlocks);
+    boot[38] = 0x29;
+    memcpy(boot + 43, "REPETIER   FAT16   ", 19);
+    boot[510] = 0x55;
+    boot[511] = 0xaa;
+    uint8_t *fat = boot + SD_RESERVED_BLOCKS * 512;
+    uint8_t *root = fat + 2 * SD_FAT_BLOCKS * 512;
+    uint8_t *data = root + SD_ROOT_ENTRIES * 32;
+    sdPut16(fat, 0xfff8);
+    sdPut16(fat + 2, 0xffff);
+    uint32_t cluster = 2, entry = 0, shortIndex = 1;
+    for(char *name = strtok(files, ","); name; name = strtok(NULL, ","))
+    {
+        FILE *f = fopen(name, "rb");
+        if(f == NULL)
+        {
+            perror(name);
+            return false;
+        }
+        const char *base = strrchr(name, '/') ? strrchr(name, '/') + 1 : name;
+        // 8.3 name, the first 6 characters and ~n if the name does not fit
+        uint8_t shortName[11];
+        memset(shortName, ' ', 11);
+        const char *dot = strrchr(base, '.');
+        int baseLen = dot ? (int)(dot - base) : (int)strlen(base);
+        int extLen = dot ? (int)strlen(dot + 1) : 0;
+        bool fits = baseLen > 0 && baseLen <= 8 && extLen <= 3;
+        for(int i = 0; i < baseLen && i < 8; i++)
+            shortName[i] = toupper(base[i]);
+        for(int i = 0; i < extLen && i < 3; i++)
+            shortName[8 + i] = toupper(dot[1 + i]);
+        for(const char *c = base; *c; c++)
+            if(islower(*c) || *c == ' ' || (*c == '.' && c != dot)) fits = false;
+        if(!fits)
+        {
+            char tail[8];
+            int n = sprintf(tail, "~%u", shortIndex++);
+            int keep = baseLen < 8 - n ? baseLen : 8 - n;
+            memcpy(shortName + keep, tail, n);
+            // long filename entries in reverse order before the short entry
+            uint8_t sum = 0;
+            for(int i = 0; i < 11; i++)
+                sum = ((sum & 1) << 7) + (sum >> 1) + shortName[i];
+            int len = strlen(base), parts = (len + 12) / 13;
+            for(int part = parts; part > 0; part--)
+            {
+                uint8_t *e = root + 32 * entry++;
+                static const uint8_t charOffset[13] = {1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30};
+                e[0] = part | (part == parts ? 0x40 : 0);
+                e[11] = 0x0f;
+                e[13] = sum;
+                for(int i = 0; i < 13; i++)
+                {
+                    int c = (part - 1) * 13 + i;
+                    sdPut16(e + charOffset[i], c < len ? (uint8_t)base[c] : (c == len ? 0 : 0xffff));
+                }
+            }
+        }
+        uint8_t *e = root + 32 * entry++;
+        memcpy(e, shortName, 11);
+        e[11] = 0x20; // archive
+        sdPut16(e + 24, (34 << 9) | (1 << 5) | 1); // 2014-01-01
+        uint32_t size = 0, first = 0, previous = 0, count = 0;
+        size_t n;
+        while((n = fread(data + (size_t)(cluster - 2) * SD_BLOCKS_PER_CLUSTER * 512, 1, SD_BLOCKS_PER_CLUSTER * 512, f)) > 0)
+        {
+            if(previous) sdPut16(fat + 2 * previous, cluster);
+            else first = cluster;
+            previous = cluster++;
+            size += n;
+            if(sdFragment && ++count % sdFragment == 0)
+                cluster++; // leave a gap, the file continues after it
+        }
+        fclose(f);
+        if(previous) sdPut16(fat + 2 * previous, 0xffff);
+        sdPut16(e + 26, first);
+        sdPut32(e + 28, size);
+        fprintf(stderr, "sd card: %s as %.8s.%.3s, %u bytes\n", base, shortName, shortName + 8, size);
+    }
+    memcpy(fat + SD_FAT_BLOCKS * 512, fat, SD_FAT_BLOCKS * 512); // second FAT
+    return true;
+}
+
+/** Queues the card answer to a complete command. */
+static void sdProcessCommand()
+{
+    uint8_t cmd = sdCommand[0] & 0x3f;
+    uint32_t arg = ((uint32_t)sdCommand[1] << 24) | ((uint32_t)sdCommand[2] << 16) | (sdCommand[3] << 8) | sdCommand[4];
+    uint8_t r1 = sdIdle ? 1 : 0;
+    sdStreamBlock = sdDataBlock = 0xffffffff;
+    sdWaitBytes = 0;
+    sdResponsePos = 0;
+    sdResponseLength = 2;
+    sdResponse[0] = 0xff; // one byte until the response
+    if(sdAppCommand)
+    {
+        sdAppCommand = false;
+        if(cmd == 41) sdIdle = false;
+        sdResponse[1] = sdIdle ? 1 : 0;
+        return;
+    }
+    uint32_t waitBytes = SD_READ_LATENCY_US * (F_CPU / 1000000) / (16 << sdSpiRate);
+    switch(cmd)
+    {
+    case 0:
+        sdIdle = true;
+        r1 = 1;
+        break;
+    case 8:
+        memcpy(sdResponse + 2, "\x00\x00\x01\xaa", 4);
+        sdResponseLength = 6;
+        break;
+    case 9: // CSD version 2
+        memset(sdResponse + 2, 0, 21);
+        sdResponse[2] = 0xff;
+        sdResponse[3] = 0xfe;
+        sdResponse[4] = 0x40;
+        sdResponse[7] = 0x32;
+        sdResponse[9] = 0x59;
+        sdResponse[11] = (SD_IMAGE_BLOCKS / 1024 - 1) >> 16;
+        sdResponse[12] = (SD_IMAGE_BLOCKS / 1024 - 1) >> 8;
+        sdResponse[13] = (SD_IMAGE_BLOCKS / 1024 - 1) & 0xff;
+        sdResponse[14] = 0x7f; // erase_blk_en
+        sdResponse[20] = sdCrc16(sdResponse + 4, 16) >> 8;
+        sdResponse[21] = sdCrc16(sdResponse + 4, 16) & 0xff;
+        sdResponseLength = 22;
+        break;
+    case 10: // CID
+        memset(sdResponse + 2, 0, 21);
+        sdResponse[2] = 0xff;
+        sdResponse[3] = 0xfe;
+        memcpy(sdResponse + 7, "HOST", 4);
+        sdResponse[20] = sdCrc16(sdResponse + 4, 16) >> 8;
+        sdResponse[21] = sdCrc16(sdResponse + 4, 16) & 0xff;
+        sdResponseLength = 22;
+        break;
+    case 12:
+        r1 = 0; // stop of CMD18, the byte before the response is the stuff byte
+        break;
+    case 13:
+        sdResponse[2] = 0;
+        sdResponseLength = 3;
+        break;
+    case 17:
+        sdDataBlock = arg;
+        sdWaitBytes = waitBytes;
+        sdSingleReads++;
+        if(arg >= SD_VOLUME_START + SD_RESERVED_BLOCKS && arg < SD_VOLUME_START + SD_RESERVED_BLOCKS + 2 * SD_FAT_BLOCKS)
+            sdFatReads++;
+        break;
+    case 18:
+        sdStreamBlock = arg;
+        sdStreamStarted = false;
+        sdWaitBytes = waitBytes;
+        sdMultiReads++;
+        break;
+    case 24:
+    case 25:
+        sdState = SD_CARD_WRITE_TOKEN;
+        sdMultiWrite = cmd == 25;
+        sdWriteBlock = arg;
+        break;
+    case 55:
+        sdAppCommand = true;
+        break;
+    case 58:
+        memcpy(sdResponse + 2, "\xc0\xff\x80\x00", 4); // SDHC
+        sdResponseLength = 6;
+        break;
+    case 32:
+    case 33:
+    case 38:
+    case 59:
+        break;
+    default:
+        r1 |= 4; // illegal command
+    }
+    sdResponse[1] = r1;
+}
+
+/** One byte in both directions over SPI. */
+static uint8_t sdExchange(uint8_t in)
+{
+    sdSpiTicks += 16 << sdSpiRate;
+    if(sdSpiTicks >= 50 * (F_CPU / 1000000))
+    {
+        unsigned int us = sdSpiTicks / (F_CPU / 1000000);
+        sdSpiTicks -= (uint64_t)us * (F_CPU / 1000000);
+        HAL::delayMicroseconds(us);
+    }
+    if(sdImage == NULL || HAL::pinState[SDSS]) return 0xff; // no card or not selected
+    if(sdState == SD_CARD_WRITE_DATA)
+    {
+        sdWriteBuffer[sdWritePos++] = in;
+        if(sdWritePos == 514) // data and crc
+        {
+            if(sdWriteBlock < SD_IMAGE_BLOCKS)
+                memcpy(sdImage + (size_t)sdWriteBlock * 512, sdWriteBuffer, 512);
+            sdWriteBlock++;
+            sdResponse[0] = 0x05; // data accepted
+            sdResponsePos = 0;
+            sdResponseLength = 1;
+            sdBusyBytes = (sdMultiWrite ? SD_MULTI_WRITE_LATENCY_US : SD_WRITE_LATENCY_US) * (F_CPU / 1000000) / (16 << sdSpiRate);
+            if(sdMultiWrite) sdMultiWrites++;
+            else sdWrites++;
+            sdState = sdMultiWrite ? SD_CARD_WRITE_TOKEN : SD_CARD_IDLE;
+        }
+        return 0xff;
+    }
+    if(sdState == SD_CARD_WRITE_TOKEN && (in == 0xfe || in == 0xfc))
+    {
+        sdState = SD_CARD_WRITE_DATA;
+        sdWritePos = 0;
+        return 0xff;
+    }
+    if(sdState == SD_CARD_WRITE_TOKEN && in == 0xfd) // stop transmission
+    {
+        sdState = SD_CARD_IDLE;
+        return 0xff;
+    }
+    if(sdCommandLength || (in & 0xc0) == 0x40)
+    {
+        sdCommand[sdCommandLength++] = in;
+        if(sdCommandLength == 6)
+        {
+            sdCommandLength = 0;
+            sdState = SD_CARD_IDLE;
+            sdProcessCommand();
+        }
+        return 0xff;
+    }
+    if(sdResponsePos < sdResponseLength)
+        return sdResponse[sdResponsePos++];
+    if(sdBusyBytes)
+    {
+        sdBusyBytes--;
+        return 0;
+    }
+    if(sdDataBlock == 0xffffffff && sdStreamBlock != 0xffffffff)
+    {
+        sdDataBlock = sdStreamBlock++;
+        if(sdStreamStarted) // the first block waits for the access time of the command
+            sdWaitBytes = SD_STREAM_LATENCY_US * (F_CPU / 1000000) / (16 << sdSpiRate);
+        sdStreamStarted = true;
+        sdStreamedBlocks++;
+    }
+    if(sdDataBlock != 0xffffffff)
+    {
+        if(sdWaitBytes)
+        {
+            sdWaitBytes--;
+            return 0xff;
+        }
+        sdResponse[0] = 0xfe;
+        if(sdDataBlock < SD_IMAGE_BLOCKS)
+            memcpy(sdResponse + 1, sdImage + (size_t)sdDataBlock * 512, 512);
+        else
+            memset(sdResponse + 1, 0, 512);
+        uint16_t crc = sdCrc16(sdResponse + 1, 512);
+        sdResponse[513] = crc >> 8;
+        sdResponse[514] = crc & 0xff;
+        sdResponsePos = 0;
+        sdResponseLength = 515;
+        sdDataBlock = 0xffffffff;
+        return sdResponse[sdResponsePos++];
+    }
+    return 0xff;
+}
+
+void HAL::spiInit(uint8_t spiRate)
+{
+    sdSpiRate = spiRate;
+}
+
+uint8_t HAL::spiReceive(uint8_t send)
+{
+    return sdExchange(send);
+}
+
+void HAL::spiReadBlock(uint8_t *buf, size_t nbyte)
+{
+    while(nbyte--)
+        *buf++ = sdExchange(0xff);
+}
+
+void HAL::spiSend(uint8_t b)
+{
+    sdExchange(b);
+}
+
+void HAL::spiSend(const uint8_t *buf, size_t n)
+{
+    while(n--)
+        sdExchange(*buf++);
+}
+
+void HAL::spiSendBlock(uint8_t token, const uint8_t *buf)
+{
+    sdExchange(token);
+    spiSend(buf, 512);
+}
+
+static void sdReport()
+{
+    if(sdImage == NULL) return;
+    fprintf(stderr, "sd card: %lu single block reads (%lu of the FAT), %lu multiple block reads with %lu blocks, %lu+%lu blocks written\n",
+            sdSingleReads, sdFatReads, sdMultiReads, sdStreamedBlocks, sdWrites, sdMultiWrites);
+}
+
+/** Motion stream conversion. motionStreamCommand sees every command before
+it is executed and remembers if it is a move, so only the moves of G0-G3
+(including arc segments) are written by motionStreamMove. Moves of G28 and
+other commands are executed, as the printer will do it with the stream. */
+static bool motionStreamIsMove = false;
+static unsigned long motionStreamMoves = 0, motionStreamCommands = 0;
+
+static void motionStreamHeader()
+{
+    MotionStreamHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = MOTION_STREAM_MAGIC;
+    header.recordSize = sizeof(MotionRecord);
+    header.driveSystem = DRIVE_SYSTEM;
+    for(int i = 0; i < 4; i++)
+        header.axisStepsPerMM[i] = Printer::axisStepsPerMM[i];
+    fwrite(&header, sizeof(header), 1, HAL::motionStream);
+}
+
+void HAL::motionStreamCommand(GCode *com)
+{
+    motionStreamIsMove = com->hasG() && com->G <= 3;
+    if(motionStreamIsMove) return;
+    uint8_t data[MOTION_COMMAND_RECORDS * sizeof(MotionRecord)];
+    memset(data, 0, sizeof(data));
+    uint8_t buf[100];
+    uint8_t size = com->writeBinary(buf);
+    if(size == 0) return;
+    if(size + 2 > (int)sizeof(data))
+    {
+        fprintf(stderr, "motion stream: command with %d bytes is too long, skipped\n", size);
+        return;
+    }
+    data[0] = MOTION_RECORD_COMMAND;
+    data[1] = size;
+    memcpy(data + 2, buf, size);
+    int records = (size + 2 + sizeof(MotionRecord) - 1) / sizeof(MotionRecord);
+    fwrite(data, sizeof(MotionRecord), records, motionStream);
+    motionStreamCommands++;
+}
+
+bool HAL::motionStreamMove(uint8_t checkEndstops,uint8_t pathOptimize,uint8_t softEndstop)
+{
+    if(!motionStreamIsMove) return false;
+#if !NONLINEAR_SYSTEM
+    Printer::constrainDestinationCoords(); // as queueCartesianMove does
+#endif
+    MotionRecord r;
+    memset(&r, 0, sizeof(r));
+    r.type = MOTION_RECORD_MOVE;
+    r.flags = (checkEndstops ? MOTION_FLAG_CHECK_ENDSTOPS : 0) | (pathOptimize ? MOTION_FLAG_PATH_OPTIMIZE : 0) |
+              (softEndstop ? MOTION_FLAG_SOFT_ENDSTOP : 0);
+    r.steps[X_AXIS] = Printer::destinationSteps[X_AXIS];
+    r.steps[Y_AXIS] = Printer::destinationSteps[Y_AXIS];
+    r.steps[Z_AXIS] = Printer::destinationSteps[Z_AXIS];
+    r.steps[E_AXIS] = Printer::destinationSteps[E_AXIS] - Printer::currentPositionSteps[E_AXIS];
+    r.feedrate = Printer::feedrate * 100.0f / (float)Printer::feedrateMultiply;
+    fwrite(&r, sizeof(r), 1, motionStream);
+    for(int i = 0; i < 4; i++)
+        Printer::currentPositionSteps[i] = Printer::destinationSteps[i];
+    motionStreamMoves++;
+    return true;
+}
+
+static void motionStreamReport()
+{
+    if(HAL::motionStream == NULL) return;
+    fclose(HAL::motionStream);
+    fprintf(stderr, "motion stream: %lu moves, %lu commands\n", motionStreamMoves, motionStreamCommands);
+}
+
+/** Ends the simulation. */
+static void hostExit()
+{
+    HAL::serialFlush();
+    if(HAL::pinLog) fclose(HAL::pinLog);
+    if(HAL::planLog) fclose(HAL::planLog);
+    benchmarkReport();
+    sdReport();
+    motionStreamReport();
+#if DELTA_SEGMENT_POOL_SIZE
+    if(PrintLine::segmentPoolUsed) exit(1); // removed lines did not free their segments
+#endif
+    exit(0);
+}
+
+void HAL::resetHardware()
+{
+    hostExit();
+}
+
+void HAL::analogStart()
+{
+#if ANALOG_INPUTS>0
+    for(uint8_t i=0; i<ANALOG_INPUTS; i++)
+    {
+        osAnalogInputCounter[i] = 0;
+        osAnalogInputBuildup[i] = 0;
+        osAnalogInputValues[i] = HOST_ANALOG_VALUE;
+    }
+#endif
+}
+
+void HAL::logPin(uint8_t pin,uint8_t value)
+{
+    fprintf(pinLog, "%llu %d %d\n", (unsigned long long)ticks, (int)pin, (int)value);
+}
+
+/** Endstop model. Every step pulse moves the simulated motor in the direction its
+direction pin gives. An endstop reads as triggered while its axis is at or beyond the
+configured end of travel (xMinSteps, xMaxSteps, ...). Gantry motors are converted to
+the X and Y axis first. Delta towers trigger their max endstop at the height they have
+with the effector at the top (zMaxSteps) and have no min endstop. */
+static int32_t endstopMin[3];
+static int32_t endstopMax[3];
+
+void HAL::hostStep(uint8_t motor)
+{
+    static const uint8_t dirPin[3] = {X_DIR_PIN, Y_DIR_PIN, Z_DIR_PIN};
+    static const uint8_t positiveDir[3] = {!INVERT_X_DIR, !INVERT_Y_DIR, !INVERT_Z_DIR};
+    if(pinState[dirPin[motor]] == positiveDir[motor])
+        motorSteps[motor]++;
+    else
+        motorSteps[motor]--;
+}
+
+uint8_t HAL::hostEndstopLevel(uint8_t role)
+{
+    static const uint8_t inverting[6] = {ENDSTOP_X_MIN_INVERTING, ENDSTOP_Y_MIN_INVERTING, ENDSTOP_Z_MIN_INVERTING,
+                                         ENDSTOP_X_MAX_INVERTING, ENDSTOP_Y_MAX_INVERTING, ENDSTOP_Z_MAX_INVERTING
+                                        };
+    uint8_t endstop = role - HOST_PIN_X_MIN;
+    uint8_t axis = endstop % 3;
+    int32_t pos = motorSteps[axis];
+#if DRIVE_SYSTEM==1
+    if(axis == X_AXIS) pos = (motorSteps[0] + motorSteps[1]) / 2;
+    if(axis == Y_AXIS) pos = (motorSteps[0] - motorSteps[1]) / 2;
+#elif DRIVE_SYSTEM==2
+    if(axis == X_AXIS) pos = (motorSteps[0] - motorSteps[1]) / 2;
+    if(axis == Y_AXIS) pos = (motorSteps[0] + motorSteps[1]) / 2;
+#endif
+    bool triggered = (endstop < 3 ? pos <= endstopMin[axis] : pos >= endstopMax[axis]);
+    return triggered != inverting[endstop]; // isXMinEndstopHit() is READ(X_MIN_PIN) != ENDSTOP_X_MIN_INVERTING
+}
+
+void HAL::hostEndstopSetup()
+{
+#if DRIVE_SYSTEM==3
+    long top[3] = {0, 0, Printer::zMaxSteps};
+    long towers[3];
+    transformCartesianStepsToDeltaSteps(top, towers);
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        motorSteps[i] = Printer::currentDeltaPositionSteps[i];
+        endstopMin[i] = INT32_MIN;
+        endstopMax[i] = towers[i];
+    }
+#else
+    long *pos = Printer::currentPositionSteps;
+#if DRIVE_SYSTEM==1
+    motorSteps[0] = pos[X_AXIS] + pos[Y_AXIS];
+    motorSteps[1] = pos[X_AXIS] - pos[Y_AXIS];
+#elif DRIVE_SYSTEM==2
+    motorSteps[0] = pos[X_AXIS] + pos[Y_AXIS];
+    motorSteps[1] = pos[Y_AXIS] - pos[X_AXIS];
+#else
+    motorSteps[0] = pos[X_AXIS];
+    motorSteps[1] = pos[Y_AXIS];
+#endif
+    motorSteps[2] = pos[Z_AXIS];
+    endstopMin[X_AXIS] = Printer::xMinSteps;
+    endstopMin[Y_AXIS] = Printer::yMinSteps;
+    endstopMin[Z_AXIS] = Printer::zMinSteps;
+    endstopMax[X_AXIS] = Printer::xMaxSteps;
+    endstopMax[Y_AXIS] = Printer::yMaxSteps;
+    endstopMax[Z_AXIS] = Printer::zMaxSteps;
+#endif
+    static const int8_t pins[9] = {X_STEP_PIN, Y_STEP_PIN, Z_STEP_PIN,
+                                   X_MIN_PIN, Y_MIN_PIN, Z_MIN_PIN, X_MAX_PIN, Y_MAX_PIN, Z_MAX_PIN
+                                  };
+    for(uint8_t i = 0; i < 9; i++)
+        if(pins[i] >= 0 && pins[i] < HOST_NUM_PINS)
+            pinRole[pins[i]] = HOST_PIN_STEP_X + i;
+}
+
+#if FEATURE_SERVO
+unsigned int HAL::servoTimings[4] = {0,0,0,0};
+void HAL::servoMicroseconds(uint8_t servo,int ms)
+{
+    if(ms<500) ms = 0;
+    if(ms>2500) ms = 2500;
+    servoTimings[servo] = (unsigned int)(((F_CPU/1000000)*(long)ms)>>3);
+}
+#endif
+
+/** \brief Replaces bresenhamStep in benchmark mode.
+
+Removes the current line without stepping, but only after the time the planner
+computed for it. That way the queue fills like with a real printer and the
+planner sees the same replanning depth. */
+uint32_t HAL::benchmarkLine()
+{
+    PrintLine::setCurrentLine();
+    PrintLine *cur = PrintLine::cur;
+    if(cur->isBlocked() || (cur->isWarmUp() && PrintLine::linesCount <= cur->getWaitForXLinesFilled()))
+    {
+        PrintLine::cur = NULL;
+        return 2000;
+    }
+    if(planLog && !cur->isWarmUp())
+        fprintf(planLog, "%ld %lu %lu %u %u %u %u %u\n", (long)cur->stepsRemaining,
+                (unsigned long)cur->fullInterval, (unsigned long)cur->accelerationPrim,
+                (unsigned)cur->vMax, (unsigned)cur->vStart, (unsigned)cur->vEnd,
+                (unsigned)cur->accelSteps, (unsigned)cur->decelSteps);
+    uint32_t wait = RMath::max(cur->getWaitTicks(), 2000L);
+    PrintLine::removeCurrentLineForbidInterrupt();
+    HAL::allowInterrupts();
+    return wait;
+}
+
+/** \brief Timer interrupt routine to drive the stepper motors.
+
+Same logic as the timer 1 interrupt of the AVR version. Returns the ticks
+until the next call.
+*/
+static uint32_t timer1Interrupt()
+{
+    if(HAL::benchmark && PrintLine::hasLines())
+        return HAL::benchmarkLine();
+#if STEP_TIMING_QUEUE
+    if(PrintLine::hasQueuedSteps())
+        return PrintLine::sendQueuedStep();
+#endif
+    if(PrintLine::hasLines())
+    {
+        // Virtual time does not pass in here, so the wall time of the host is recorded
+        uint64_t start = wallNanos();
+#if STEP_EVENT_RING
+        uint32_t delay = PrintLine::nextStepEvent();
+#else
+        uint32_t delay = PrintLine::bresenhamStep();
+#endif
+        uint64_t ticks = (wallNanos() - start) * (F_CPU / 1000000) / 1000;
+        PrintLine::recordStepTicks(ticks > 65535 ? 65535 : ticks);
+        return delay;
+    }
+    else if(FEATURE_BABYSTEPPING && Printer::zBabystepsMissing)
+    {
+        Printer::zBabystep();
+        return Printer::interval;
+    }
+    if(waitRelax == 0)
+    {
+#ifdef USE_ADVANCE
+        if(Printer::advanceStepsSet)
+        {
+            Printer::extruderStepsNeeded -= Printer::advanceStepsSet;
+#ifdef ENABLE_QUADRATIC_ADVANCE
+            Printer::advanceExecuted = 0;
+#endif
+            Printer::advanceStepsSet = 0;
+        }
+#endif
+#if defined(USE_ADVANCE)
+        if(!Printer::extruderStepsNeeded) if(DISABLE_E) Extruder::disableCurrentExtruderMotor();
+#else
+        if(DISABLE_E) Extruder::disableCurrentExtruderMotor();
+#endif
+    }
+    else waitRelax--;
+    return 65500; // Wait for next move
+}
+
+#if ANALOG_INPUTS>0 && NUM_EXTRUDER>0
+/** Thermal model of the extruder 0 hotend for -T. Heater block and sensor are two temperatures
+like in heat manager 4, but with other values than the configuration, so the controller has to
+correct its model. The filament of the move in print is heated from ambient temperature. */
+static bool heaterSimulation = false;
+static float heaterBlockTemp = 22;
+static float heaterSensorTemp = 22;
+static uint16_t heaterAnalogValue = HOST_ANALOG_VALUE;
+
+/** Advances the hotend model by 10ms and computes the analog value of its sensor. */
+static void simulateHeater()
+{
+    const float power = EXT0_MPC_HEATER_POWER, capacity = 20, loss = 0.08, response = 0.25, ambient = 22;
+    TemperatureController *act = &extruder[0].tempControl;
+    float flow = 0;
+    if(PrintLine::cur != NULL)
+        PrintLine::queuedExtrusionRate(0.001f,flow);
+    heaterBlockTemp += (power * pwm_pos[act->pwmIndex] / 255.0f - (loss + 0.0056f * flow) * (heaterBlockTemp - ambient)) * 0.01f / capacity;
+    heaterSensorTemp += (heaterBlockTemp - heaterSensorTemp) * response * 0.01f;
+    // The sensor reads the raw value a target of its temperature gets
+    static TemperatureController sensor = *act;
+    sensor.setTargetTemperature(heaterSensorTemp);
+    heaterAnalogValue = ((1023 << (2 - ANALOG_REDUCE_BITS)) - sensor.targetTemperature) << ANALOG_REDUCE_BITS;
+}
+#endif
+
+/**
+This timer is called 3906 timer per second. It is used to update pwm values for heater and some other frequent jobs.
+Heater outputs are only simulated for extruder 0 with -T, other analog inputs always return HOST_ANALOG_VALUE.
+*/
+static void pwmInterrupt()
+{
+    HAL::allowInterrupts();
+    counterPeriodical++; // Approximate a 100ms timer
+    if(counterPeriodical >= (int)(F_CPU/40960))
+    {
+        counterPeriodical = 0;
+        executePeriodical = 1;
+    }
+#if ANALOG_INPUTS>0
+    for(uint8_t i = 0; i < ANALOG_INPUTS; i++)
+        osAnalogInputValues[i] = HOST_ANALOG_VALUE;
+#if NUM_EXTRUDER>0
+    if(heaterSimulation)
+    {
+        static uint8_t heaterCounter = 0;
+        if(++heaterCounter >= PWM_CLOCK_FREQ / 100)
+        {
+            heaterCounter = 0;
+            simulateHeater();
+        }
+        osAnalogInputValues[extruder[0].tempControl.sensorPin] = heaterAnalogValue;
+    }
+#endif
+#endif
+}
+
+#if defined(USE_ADVANCE)
+/** \brief Timer routine for extruder stepper.
+
+Same as the AVR version. Returns the ticks until the next call.
+*/
+static uint32_t extruderInterrupt()
+{
+    static int8_t extruderLastDirection = 0;
+    uint32_t timer = 0;
+    if(!Printer::isAdvanceActivated()) return 256 * TIMER0_PRESCALE; // currently no need
+    if(Printer::extruderStepsNeeded > 0 && extruderLastDirection!=1)
+    {
+        Extruder::setDirection(true);
+        extruderLastDirection = 1;
+        timer += 40; // Add some more wait time to prevent blocking
+    }
+    else if(Printer::extruderStepsNeeded < 0 && extruderLastDirection!=-1)
+    {
+        Extruder::setDirection(false);
+        extruderLastDirection = -1;
+        timer += 40; // Add some more wait time to prevent blocking
+    }
+    else if(Printer::extruderStepsNeeded != 0)
+    {
+        Extruder::step();
+        Printer::extruderStepsNeeded -= extruderLastDirection;
+        Printer::insertStepperHighDelay();
+        Extruder::unstep();
+    }
+    return (timer + Printer::maxExtruderSpeed) * TIMER0_PRESCALE;
+}
+#endif
+
+void HAL::simulateInterrupts()
+{
+    if(insideInterrupt || !interruptsEnabled) return;
+    if(PrintLine::hasLines() || !serialEof || serialBufferPos < serialBufferLen || serialRxHead != serialRxTailPos)
+        lastActivity = ticks;
+#if SDSUPPORT
+    else if(sd.sdmode)
+        lastActivity = ticks;
+#endif
+    else if(ticks - lastActivity > (uint64_t)idleExitMillis * (F_CPU / 1000))
+        hostExit();
+    uint64_t next = timer1Compare;
+    uint8_t source = 0;
+    if(pwmCompare < next)
+    {
+        next = pwmCompare;
+        source = 1;
+    }
+#if defined(USE_ADVANCE)
+    if(extruderCompare < next)
+    {
+        next = extruderCompare;
+        source = 2;
+    }
+#endif
+    if(next > ticks) ticks = next;
+    insideInterrupt = true;
+    interruptsEnabled = false;
+    if(source == 0)
+    {
+        uint32_t delay = timer1Interrupt();
+        // Compare is reset on match like the AVR CTC mode. If the routine
+        // took longer than the new delay, fire as soon as possible.
+        timer1Compare = next + delay;
+        if(timer1Compare <= ticks) timer1Compare = ticks + 100;
+    }
+    else if(source == 1)
+    {
+        pwmInterrupt();
+        pwmCompare = next + F_CPU / PWM_CLOCK_FREQ;
+    }
+#if defined(USE_ADVANCE)
+    else
+    {
+        extruderCompare = next + extruderInterrupt();
+    }
+#endif
+    serialReceive(); // receive interrupt
+    insideInterrupt = false;
+    interruptsEnabled = true;
+}
+
+#if DRIVE_SYSTEM==3
+/** \brief Compares transformCartesianStepsToDeltaSteps with double precision kinematics.
+
+HAL::integerSqrt is checked against the rounded double root for every argument up to the
+largest squared rod length. Then every integer step position of the build disk is transformed at
+z = 0, which covers the whole volume as z is only added to the root. Last both versions are timed
+with pseudo random points. Returns the exit code. */
+static int deltaKernelCheck()
+{
+    bool large = Printer::isLargeMachine();
+    long towerX[3] = {Printer::deltaAPosXSteps, Printer::deltaBPosXSteps, Printer::deltaCPosXSteps};
+    long towerY[3] = {Printer::deltaAPosYSteps, Printer::deltaBPosYSteps, Printer::deltaCPosYSteps};
+    floatLong *diagonal[3] = {&Printer::deltaDiagonalStepsSquaredA, &Printer::deltaDiagonalStepsSquaredB, &Printer::deltaDiagonalStepsSquaredC};
+    double diagonal2[3];
+    uint32_t maxArg = 0;
+    for(int i = 0; i < 3; i++)
+    {
+        diagonal2[i] = large ? diagonal[i]->f : diagonal[i]->l;
+        if(!large && (uint32_t)diagonal[i]->l > maxArg) maxArg = diagonal[i]->l;
+    }
+    long sqrtErrors = 0;
+    if(!large)
+    {
+        for(uint32_t a = 0;; a++)
+        {
+            if(HAL::integerSqrt(a) != (uint32_t)floor(sqrt((double)a) + 0.5) && sqrtErrors++ < 10)
+                fprintf(stderr, "integerSqrt(%u) = %u\n", a, HAL::integerSqrt(a));
+            if(a == maxArg) break;
+        }
+        fprintf(stderr, "integerSqrt: %u arguments, %ld wrong\n", maxArg + 1, sqrtErrors);
+    }
+    long radius = (long)(sqrt(Printer::deltaMaxRadiusSquared) * Printer::axisStepsPerMM[Z_AXIS]);
+    long points = 0, validity = 0, wrong = 0;
+    double maxError = 0, limit = large ? 1.0 : 0.5 + 1e-9;
+    for(long y = -radius; y <= radius; y++)
+        for(long x = -radius; x <= radius; x++)
+        {
+            if(x * x + y * y > radius * radius) continue;
+            long cart[3] = {x, y, 0}, tower[3];
+            bool ok = transformCartesianStepsToDeltaSteps(cart, tower);
+            double rest[3];
+            bool refOk = true;
+            for(int i = 0; i < 3; i++)
+            {
+                double dx = towerX[i] - x, dy = towerY[i] - y;
+                rest[i] = diagonal2[i] - dx * dx - dy * dy;
+                if(rest[i] < 0) refOk = false;
+            }
+            points++;
+            if(ok != refOk)
+            {
+                validity++;
+                continue;
+            }
+            if(!ok) continue;
+            for(int i = 0; i < 3; i++)
+            {
+                double error = fabs(tower[i] - sqrt(rest[i]));
+                if(error > maxError) maxError = error;
+                if(error > limit && wrong++ < 10)
+                    fprintf(stderr, "tower %d at %ld,%ld: %ld, reference %.3f\n", i, x, y, tower[i], sqrt(rest[i]));
+            }
+        }
+    fprintf(stderr, "transform: %ld points in radius %ld steps, max. error %.4f steps, %ld over %.1f, %ld validity differences\n",
+            points, radius, maxError, wrong, limit, validity);
+    // Timing
+    const int n = 1 << 20;
+    long *cart = new long[3 * n];
+    uint32_t seed = 1;
+    for(int i = 0; i < n; i++)
+    {
+        long x, y;
+        do
+        {
+            seed = seed * 1103515245 + 12345;
+            x = (long)(seed >> 8) % (2 * radius + 1) - radius;
+            seed = seed * 1103515245 + 12345;
+            y = (long)(seed >> 8) % (2 * radius + 1) - radius;
+        }
+        while(x * x + y * y > radius * radius);
+        cart[3 * i] = x;
+        cart[3 * i + 1] = y;
+        cart[3 * i + 2] = i & 1023;
+    }
+    long tower[3], sum = 0;
+    uint64_t start = wallNanos();
+    for(int i = 0; i < n; i++)
+        if(transformCartesianStepsToDeltaSteps(&cart[3 * i], tower))
+            sum += tower[0] + tower[1] + tower[2];
+    uint64_t kernel = wallNanos() - start;
+    start = wallNanos();
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < 3; j++)
+        {
+            double dx = towerX[j] - cart[3 * i], dy = towerY[j] - cart[3 * i + 1];
+            double rest = diagonal2[j] - dx * dx - dy * dy;
+            if(rest >= 0) sum -= (long)floor(sqrt(rest) + 0.5) + cart[3 * i + 2];
+        }
+    uint64_t reference = wallNanos() - start;
+    delete[] cart;
+    fprintf(stderr, "timing: %.1f ns per transform, double reference %.1f ns (checksum %ld)\n",
+            (double)kernel / n, (double)reference / n, sum);
+    return sqrtErrors || wrong || validity ? 1 : 0;
+}
+#endif
+
+/** \brief Parser benchmark for option -P.
+
+Reads the whole input, removes comments and empty lines like GCode::readFromSerial and parses
+the lines with GCode::parseAscii until at least half a second has passed. Prints lines/s of the
+parser selected with FAST_ASCII_PARSER. With -l every parsed line is written once as its
+parameters, so the output of two builds can be compared. Returns the exit code. */
+static int parserBenchmark()
+{
+    fcntl(serialInFd, F_SETFL, fcntl(serialInFd, F_GETFL) & ~O_NONBLOCK);
+    size_t size = 0, capacity = 1 << 16;
+    char *data = (char *)malloc(capacity + 1);
+    for(;;)
+    {
+        if(size == capacity)
+            data = (char *)realloc(data, (capacity *= 2) + 1);
+        ssize_t n = read(serialInFd, data + size, capacity - size);
+        if(n <= 0) break;
+        size += n;
+    }
+    data[size] = 0;
+    int numLines = 0, tooLong = 0;
+    char **lines = (char **)malloc(sizeof(char *) * (size / 2 + 1));
+    for(char *p = data; *p;)
+    {
+        char *end = strchr(p, '\n');
+        if(end) *end = 0;
+        char *next = end ? end + 1 : p + strlen(p);
+        char *cut = strpbrk(p, ";\r");
+        if(cut) *cut = 0;
+        if(strlen(p) >= MAX_CMD_SIZE)
+            tooLong++;
+        else if(*p)
+            lines[numLines++] = p;
+        p = next;
+    }
+    if(numLines == 0)
+    {
+        fprintf(stderr, "no commands in input\n");
+        return 1;
+    }
+    GCode code;
+    char buf[MAX_CMD_SIZE];
+    uint32_t sink = 0, errors = 0;
+    long passes = 0;
+    uint64_t start = wallNanos(), elapsed;
+    do
+    {
+        for(int i = 0; i < numLines; i++)
+        {
+            strcpy(buf, lines[i]); // the parser terminates strings in place
+            if(!code.parseAscii(buf, false) || code.hasFormatError()) errors++;
+            sink += code.G + code.M + (uint32_t)(code.X + code.Y + code.E);
+        }
+        passes++;
+        elapsed = wallNanos() - start;
+    }
+    while(elapsed < 500000000ULL);
+    double parsed = (double)numLines * passes;
+    fprintf(stderr, "parser: %s, %d lines x %ld passes, %.0f lines/s, %.1f ns/line, %u errors (checksum %u)\n",
+            FAST_ASCII_PARSER ? "scanner" : "strtod", numLines, passes, parsed * 1e9 / elapsed,
+            elapsed / parsed, (unsigned)(errors / passes), sink);
+    if(tooLong)
+        fprintf(stderr, "parser: %d lines longer than MAX_CMD_SIZE skipped\n", tooLong);
+    if(HAL::planLog)
+    {
+        for(int i = 0; i < numLines; i++)
+        {
+            strcpy(buf, lines[i]);
+            bool ok = code.parseAscii(buf, false);
+            FILE *l = HAL::planLog;
+            fprintf(l, "%s", ok && !code.hasFormatError() ? "ok" : "error");
+            if(code.hasN()) fprintf(l, " N%u", code.N);
+            if(code.hasM()) fprintf(l, " M%u", code.M);
+            if(code.hasG()) fprintf(l, " G%u", code.G);
+            if(code.hasX()) fprintf(l, " X%.9g", code.X);
+            if(code.hasY()) fprintf(l, " Y%.9g", code.Y);
+            if(code.hasZ()) fprintf(l, " Z%.9g", code.Z);
+            if(code.hasE()) fprintf(l, " E%.9g", code.E);
+            if(code.hasF()) fprintf(l, " F%.9g", code.F);
+            if(code.hasT()) fprintf(l, " T%u", code.T);
+            if(code.hasS()) fprintf(l, " S%ld", code.S);
+            if(code.hasP()) fprintf(l, " P%ld", code.P);
+            if(code.hasI()) fprintf(l, " I%.9g", code.I);
+            if(code.hasJ()) fprintf(l, " J%.9g", code.J);
+            if(code.hasR()) fprintf(l, " R%.9g", code.R);
+            if(code.hasString()) fprintf(l, " \"%s\"", code.text);
+            fprintf(l, "\n");
+        }
+        fclose(HAL::planLog);
+    }
+    free(lines);
+    free(data);
+    return 0;
+}
+
+/** \brief Writes thermistortables.h for THERMISTOR_DENSE_INDEX, host option -G.
+
+Every index is checked with temptableIndexedRawToTemp against the binary search for all raw values
+before it is written. Returns the exit code.
+*/
+static int writeThermistorIndex(FILE *out)
+{
+    static const uint8_t builtin[9] = {1,2,3,4,8,9,10,11,12};
+    uint8_t index[THERMISTOR_INDEX_ENTRIES];
+    fprintf(out,"/* Row index of the built-in thermistor tables for THERMISTOR_DENSE_INDEX, see\n"
+            "temptableIndexedRawToTemp in Extruder.cpp. Made by \"make thermistortables\" of the host\n"
+            "simulator from the tables in Extruder.cpp, do not edit. */\n");
+    for(uint8_t t = 0; t < 9; t++)
+    {
+        uint8_t type = builtin[t] - 1;
+        const short *temptable = temptables[type];
+        uint8_t num = temptables_num[type];
+        for(int i = 0; i < THERMISTOR_INDEX_ENTRIES; i++)
+            index[i] = temptableFindRow(temptable,num,true,i << THERMISTOR_INDEX_SHIFT);
+        for(int raw = -1; raw <= (THERMISTOR_INDEX_ENTRIES << THERMISTOR_INDEX_SHIFT); raw++)
+            if(temptableIndexedRawToTemp(temptable,index,num,raw) != temptableRawToTemp(temptable,num,true,raw))
+            {
+                fprintf(stderr,"table %d: index gives another temperature for raw %d\n",builtin[t],raw);
+                return 1;
+            }
+        fprintf(out,"#if TEMPTABLE_USED(%d)\nconst uint8_t temptable_index_%d[%d] PROGMEM =\n{",builtin[t],builtin[t],THERMISTOR_INDEX_ENTRIES);
+        for(int i = 0; i < THERMISTOR_INDEX_ENTRIES; i++)
+            fprintf(out,"%s%d%s",(i & 31) ? "" : "\n    ",index[i],i + 1 < THERMISTOR_INDEX_ENTRIES ? "," : "\n");
+        fprintf(out,"};\n#endif\n");
+    }
+    fprintf(out,"const uint8_t * const temptables_index[12] PROGMEM =\n{\n");
+    for(uint8_t type = 1; type <= 12; type++)
+    {
+        const char *sep = type < 12 ? "," : "";
+        if(type >= 5 && type <= 7) // user tables
+            fprintf(out,"    0%s\n",sep);
+        else
+            fprintf(out,"#if TEMPTABLE_USED(%d)\n    temptable_index_%d%s\n#else\n    0%s\n#endif\n",type,type,sep,sep);
+    }
+    fprintf(out,"};\n");
+    return 0;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [-i serialIn] [-o serialOut] [-p pinLog] [-b baudrate] [-x idleExitMs] [-B [-l planLog]] [-K] [-G] [-P [-l parseLog]] [-S files [-f n]] [-M motionStream] [-T]\n", name);
+    fprintf(stderr, "  -i  file or pipe to read commands from, default stdin\n");
+    fprintf(stderr, "  -o  file receiving firmware output, default stdout\n");
+    fprintf(stderr, "  -p  log step and direction pin changes as \"tick pin value\"\n");
+    fprintf(stderr, "  -b  simulated serial speed, 0 delivers bytes without delay\n");
+    fprintf(stderr, "  -x  virtual milliseconds to stay idle after input ended\n");
+    fprintf(stderr, "  -B  planner benchmark: drop moves without stepping and report\n");
+    fprintf(stderr, "      moves/s, calculateMove latency and replanning depth\n");
+    fprintf(stderr, "  -l  with -B write the trapezoid of every line as \"steps fullInterval\n");
+    fprintf(stderr, "      accelerationPrim vMax vStart vEnd accelSteps decelSteps\"\n");
+    fprintf(stderr, "  -K  delta builds: check the tower kinematics against double precision\n");
+    fprintf(stderr, "      over the build volume, time them and exit\n");
+    fprintf(stderr, "  -G  write the thermistor table index (thermistortables.h) to stdout\n");
+    fprintf(stderr, "  -P  parser benchmark: parse the input lines repeatedly, report lines/s\n");
+    fprintf(stderr, "      and exit, -l writes the parameters of every line\n");
+    fprintf(stderr, "  -S  insert an SD card with the comma separated files, needs SDSUPPORT\n");
+    fprintf(stderr, "  -f  before -S: fragment the files with a free cluster after every n clusters\n");
+    fprintf(stderr, "  -M  convert the input to a motion stream file for SD printing instead\n");
+    fprintf(stderr, "      of moving, other commands are still executed\n");
+    fprintf(stderr, "  -T  simulate the extruder 0 hotend: heater of EXT0_MPC_HEATER_POWER, 20 J/K,\n");
+    fprintf(stderr, "      0.08 W/K loss to 22 degC, sensor response 0.25/s and filament heat\n");
+    exit(1);
+}
+
+static void logPinName(int pin, const char *name)
+{
+    if(pin < 0 || pin >= HOST_NUM_PINS) return;
+    HAL::pinLogged[pin] = 1;
+    fprintf(HAL::pinLog, "# %d %s\n", pin, name);
+}
+
+int main(int argc, char **argv)
+{
+    serialBaud = -1;
+    bool kernelCheck = false;
+    bool parserCheck = false;
+    bool thermistorIndex = false;
+    int opt;
+    while((opt = getopt(argc, argv, "i:o:p:b:x:Bl:KGPS:f:M:Th")) != -1)
+    {
+        switch(opt)
+        {
+        case 'i':
+            serialInFd = open(optarg, O_RDONLY | O_NONBLOCK);
+            if(serialInFd < 0)
+            {
+                perror(optarg);
+                return 1;
+            }
+            break;
+        case 'o':
+            serialOut = fopen(optarg, "w");
+            if(serialOut == NULL)
+            {
+                perror(optarg);
+                return 1;
+            }
+            break;
+        case 'p':
+            HAL::pinLog = fopen(optarg, "w");
+            if(HAL::pinLog == NULL)
+            {
+                perror(optarg);
+                return 1;
+            }
+            break;
+        case 'b':
+            serialBaud = atol(optarg);
+            break;
+        case 'x':
+            idleExitMillis = atol(optarg);
+            break;
+        case 'B':
+            HAL::benchmark = true;
+            break;
+        case 'K':
+            kernelCheck = true;
+            break;
+        case 'G':
+            thermistorIndex = true;
+            break;
+        case 'P':
+            parserCheck = true;
+            break;
+        case 'S':
+            if(!sdBuildImage(optarg)) return 1;
+            break;
+        case 'f':
+            sdFragment = atoi(optarg);
+            break;
+        case 'M':
+            HAL::motionStream = fopen(optarg, "wb");
+            if(HAL::motionStream == NULL)
+            {
+                perror(optarg);
+                return 1;
+            }
+            break;
+        case 'T':
+#if ANALOG_INPUTS>0 && NUM_EXTRUDER>0
+            heaterSimulation = true;
+#endif
+            break;
+        case 'l':
+            HAL::planLog = fopen(optarg, "w");
+            if(HAL::planLog == NULL)
+            {
+                perror(optarg);
+                return 1;
+            }
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+    if(serialInFd == 0)
+        fcntl(0, F_SETFL, fcntl(0, F_GETFL) | O_NONBLOCK);
+    if(HAL::pinLog)
+    {
+        logPinName(X_STEP_PIN, "X_STEP");
+        logPinName(X_DIR_PIN, "X_DIR");
+        logPinName(Y_STEP_PIN, "Y_STEP");
+        logPinName(Y_DIR_PIN, "Y_DIR");
+        logPinName(Z_STEP_PIN, "Z_STEP");
+        logPinName(Z_DIR_PIN, "Z_DIR");
+        logPinName(E0_STEP_PIN, "E0_STEP");
+        logPinName(E0_DIR_PIN, "E0_DIR");
+#if NUM_EXTRUDER>1
+        logPinName(E1_STEP_PIN, "E1_STEP");
+        logPinName(E1_DIR_PIN, "E1_DIR");
+#endif
+    }
+    if(thermistorIndex)
+        return writeThermistorIndex(stdout);
+    setup();
+    HAL::hostEndstopSetup();
+    if(HAL::motionStream)
+        motionStreamHeader(); // after setup, so the steps per mm from EEPROM are known
+    if(parserCheck)
+        return parserBenchmark();
+    if(kernelCheck)
+    {
+#if DRIVE_SYSTEM==3
+        return deltaKernelCheck();
+#else
+        fprintf(stderr, "-K needs a delta build (make DRIVE_SYSTEM=3)\n");
+        return 1;
+#endif
+    }
+    for(;;)
+        loop();
+    return 0;
+}
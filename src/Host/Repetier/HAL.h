@@ -0,0 +1,426 @@
+/*
+    This file is part of Repetier-Firmware.
+
+    Repetier-Firmware is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Repetier-Firmware is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Repetier-Firmware.  If not, see <http://www.gnu.org/licenses/>.
+
+    This firmware is a nearly complete rewrite of the sprinter firmware
+    by kliment (https://github.com/kliment/Sprinter)
+    which based on Tonokip RepRap firmware rewrite based off of Hydra-mmm firmware.
+*/
+
+/**
+  This is the main Hardware Abstraction Layer (HAL) for the host simulator.
+  The firmware is compiled as a normal Linux executable. Time is virtual:
+  the timers of the AVR version (timer 1 for steppers, the pwm timer and
+  the extruder timer) are simulated with compare values in CPU ticks and
+  fired by HAL::simulateInterrupts() whenever the main loop waits.
+  The serial port reads from a file/pipe, pins are bits in memory and
+  changes of step and direction pins can be logged with their tick.
+*/
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#include "pins.h"
+
+// SdFat checks the Arduino version and the SPI rate bits
+#define ARDUINO 101
+typedef bool boolean;
+#define SPR0    0
+#define SPR1    1
+
+// Simulate the timing of a 16 MHz AVR so all timer values stay comparable.
+#define F_CPU       16000000
+#define EEPROM_BYTES 4096  // bytes of eeprom we simulate
+#define TIMER0_PRESCALE 64
+/** Frequency of the simulated pwm timer, same as timer 0 compare B on AVR. */
+#define PWM_CLOCK_FREQ          3906
+/** Raw value reported for all analog inputs. A 100k thermistor at about 25°C. */
+#define HOST_ANALOG_VALUE       180
+/** Number of simulated digital pins. */
+#define HOST_NUM_PINS           128
+/** Values of HAL::pinRole. */
+#define HOST_PIN_STEP_X         1
+#define HOST_PIN_STEP_Y         2
+#define HOST_PIN_STEP_Z         3
+#define HOST_PIN_X_MIN          4
+#define HOST_PIN_Y_MIN          5
+#define HOST_PIN_Z_MIN          6
+#define HOST_PIN_X_MAX          7
+#define HOST_PIN_Y_MAX          8
+#define HOST_PIN_Z_MAX          9
+
+#define PACK    __attribute__ ((packed))
+
+// Everything is in ram on the host. Words are read with the type of the
+// address, because tables of pointers are read with pgm_read_word.
+#define PROGMEM
+#define PGM_P const char *
+typedef char prog_char;
+#define PSTR(s) s
+#define pgm_read_byte_near(x) (*(const uint8_t*)(x))
+#define pgm_read_byte(x) (*(const uint8_t*)(x))
+#define pgm_read_float(addr) (*(const float *)(addr))
+#define pgm_read_word(addr) (*(addr))
+#define pgm_read_word_near(addr) pgm_read_word(addr)
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_dword_near(addr) pgm_read_dword(addr)
+
+#define FSTRINGVALUE(var,value) const char var[] PROGMEM = value;
+#define FSTRINGVAR(var) static const char var[] PROGMEM;
+#define FSTRINGPARAM(var) PGM_P var
+
+#define LOW         0
+#define HIGH        1
+#define INPUT       0
+#define OUTPUT      1
+#define INPUT_PULLUP 2
+
+#define	READ(pin)  HAL::hostReadPin(pin)
+#define	WRITE(pin, v) HAL::hostWritePin(pin,v)
+#define	SET_INPUT(pin) HAL::pinMode(pin,INPUT)
+#define	SET_OUTPUT(pin) HAL::pinMode(pin,OUTPUT)
+#define TOGGLE(pin) WRITE(pin,!READ(pin))
+#define PULLUP(IO,v) {HAL::pinMode(IO,(v!=LOW ? INPUT_PULLUP : INPUT));}
+
+#define BEGIN_INTERRUPT_PROTECTED {bool oldInt = HAL::interruptsEnabled;HAL::interruptsEnabled = false;
+#define END_INTERRUPT_PROTECTED HAL::interruptsEnabled = oldInt;}
+#define ESCAPE_INTERRUPT_PROTECTED HAL::interruptsEnabled = oldInt;
+
+#define EEPROM_OFFSET               0
+#define SECONDS_TO_TICKS(s) (unsigned long)(s*(float)F_CPU)
+#define ANALOG_REDUCE_BITS 0
+#define ANALOG_REDUCE_FACTOR 1
+
+#define MAX_RAM 32767
+
+/** Like the Due, bytes arrive in a receive ring of SERIAL_RX_BUFFER_SIZE bytes that can be read in place. */
+#define SERIAL_RX_RING
+#define SERIAL_RX_BUFFER_MASK (SERIAL_RX_BUFFER_SIZE - 1)
+#if (SERIAL_RX_BUFFER_SIZE & (SERIAL_RX_BUFFER_SIZE - 1)) || SERIAL_RX_BUFFER_SIZE < 32 || SERIAL_RX_BUFFER_SIZE > 32768
+#error SERIAL_RX_BUFFER_SIZE must be a power of 2 between 32 and 32768
+#endif
+
+#define bit_clear(x,y) x&= ~(1<<y) //cbi(x,y)
+#define bit_set(x,y)   x|= (1<<y)//sbi(x,y)
+
+/** defines the data direction (reading from I2C device) in i2cStart(),i2cRepStart() */
+#define I2C_READ    1
+/** defines the data direction (writing to I2C device) in i2cStart(),i2cRepStart() */
+#define I2C_WRITE   0
+
+#if NONLINEAR_SYSTEM
+#define LIMIT_INTERVAL ((F_CPU/30000)+1)
+#else
+#define LIMIT_INTERVAL ((F_CPU/40000)+1)
+#endif
+
+typedef unsigned int speed_t;
+typedef uint32_t ticks_t;
+typedef uint32_t millis_t;
+typedef uint8_t flag8_t;
+typedef uint8_t byte;
+
+#define OUT_P_I(p,i) Com::printF(PSTR(p),(int)(i))
+#define OUT_P_I_LN(p,i) Com::printFLN(PSTR(p),(int)(i))
+#define OUT_P_L(p,i) Com::printF(PSTR(p),(long)(i))
+#define OUT_P_L_LN(p,i) Com::printFLN(PSTR(p),(long)(i))
+#define OUT_P_F(p,i) Com::printF(PSTR(p),(float)(i))
+#define OUT_P_F_LN(p,i) Com::printFLN(PSTR(p),(float)(i))
+#define OUT_P_FX(p,i,x) Com::printF(PSTR(p),(float)(i),x)
+#define OUT_P_FX_LN(p,i,x) Com::printFLN(PSTR(p),(float)(i),x)
+#define OUT_P(p) Com::printF(PSTR(p))
+#define OUT_P_LN(p) Com::printFLN(PSTR(p))
+#define OUT_ERROR_P(p) Com::printErrorF(PSTR(p))
+#define OUT_ERROR_P_LN(p) {Com::printErrorF(PSTR(p));Com::println();}
+#define OUT(v) Com::print(v)
+#define OUT_LN Com::println()
+
+class GCode;
+
+class HAL
+{
+public:
+    // Simulator state
+    static uint64_t ticks;                ///< Virtual time in CPU ticks since start.
+    static volatile bool interruptsEnabled;
+    static bool insideInterrupt;
+    static uint8_t pinState[HOST_NUM_PINS];
+    static uint8_t pinLogged[HOST_NUM_PINS]; ///< Pins whose changes are written to the pin log.
+    static FILE *pinLog;
+    static uint8_t pinRole[HOST_NUM_PINS];   ///< Motor of a step pin or endstop of an input pin, see HOST_PIN_STEP_X.
+    static int32_t motorSteps[3];            ///< Simulated X, Y and Z motors (delta: towers), moved by the step pulses.
+    static uint8_t virtualEeprom[EEPROM_BYTES];
+
+    HAL();
+    virtual ~HAL();
+
+    static inline void hwSetup(void)
+    {}
+
+    // return val'val
+    static inline unsigned long U16SquaredToU32(unsigned int val)
+    {
+        return (unsigned long) val * (unsigned long) val;
+    }
+    static inline unsigned int ComputeV(long timer,long accel)
+    {
+        return static_cast<unsigned int>((static_cast<int64_t>(timer)*static_cast<int64_t>(accel))>>18);
+    }
+// Multiply two 16 bit values and return 32 bit result
+    static inline unsigned long mulu16xu16to32(unsigned int a,unsigned int b)
+    {
+        return (unsigned long) a * (unsigned long) b;
+    }
+// Multiply two 16 bit values and return 32 bit result
+    static inline unsigned int mulu6xu16shift16(unsigned int a,unsigned int b)
+    {
+        return ((unsigned long)a*(unsigned long)b)>>16;
+    }
+    static inline unsigned int Div4U2U(unsigned long a,unsigned int b)
+    {
+        return ((unsigned long)a / (unsigned long)b);
+    }
+    /** \brief Square root of a, rounded to the nearest integer like the AVR version.
+
+    Runs the table seeded Newton iteration of the Due with __builtin_clz and plain 32 bit
+    division, so make deltacheck (-K) tests that algorithm against the double precision root. */
+    static uint32_t integerSqrt(uint32_t a);
+    static inline void hostWritePin(uint8_t pin,uint8_t value)
+    {
+        value = (value != 0);
+        if(pinState[pin] == value) return;
+        pinState[pin] = value;
+        if(pinLogged[pin] && pinLog)
+            logPin(pin,value);
+        if(value && pinRole[pin] && pinRole[pin] <= HOST_PIN_STEP_Z)
+            hostStep(pinRole[pin] - HOST_PIN_STEP_X);
+    }
+    static inline uint8_t hostReadPin(uint8_t pin)
+    {
+        if(pinRole[pin] >= HOST_PIN_X_MIN)
+            return hostEndstopLevel(pinRole[pin]);
+        return pinState[pin];
+    }
+    static void hostStep(uint8_t motor);
+    static uint8_t hostEndstopLevel(uint8_t role);
+    /** \brief Places the simulated motors where the firmware assumes them after setup.
+
+    From then on the endstop pins follow the motor positions, see hostEndstopLevel. */
+    static void hostEndstopSetup();
+    static inline void digitalWrite(uint8_t pin,uint8_t value)
+    {
+        WRITE(pin, value);
+    }
+    static inline uint8_t digitalRead(uint8_t pin)
+    {
+        return READ(pin);
+    }
+    static inline void pinMode(uint8_t pin,uint8_t mode)
+    {
+        if(mode == INPUT_PULLUP) pinState[pin] = HIGH;
+    }
+    static long CPUDivU2(speed_t divisor) {
+      return F_CPU/divisor;
+    }
+    static void delayMicroseconds(unsigned int delayUs);
+    static void delayMilliseconds(unsigned int delayMs);
+    static inline void tone(uint8_t pin,int frequency)
+    {}
+    static inline void noTone(uint8_t pin)
+    {}
+
+    static inline void eprSetByte(unsigned int pos,uint8_t value)
+    {
+        virtualEeprom[pos] = value;
+    }
+    static inline void eprSetInt16(unsigned int pos,int16_t value)
+    {
+        memcpy(&virtualEeprom[pos],&value,2);
+    }
+    static inline void eprSetInt32(unsigned int pos,int32_t value)
+    {
+        memcpy(&virtualEeprom[pos],&value,4);
+    }
+    static inline void eprSetFloat(unsigned int pos,float value)
+    {
+        memcpy(&virtualEeprom[pos],&value,4);
+    }
+    static inline uint8_t eprGetByte(unsigned int pos)
+    {
+        return virtualEeprom[pos];
+    }
+    static inline int16_t eprGetInt16(unsigned int pos)
+    {
+        int16_t v;
+        memcpy(&v,&virtualEeprom[pos],2);
+        return v;
+    }
+    static inline int32_t eprGetInt32(unsigned int pos)
+    {
+        int32_t v;
+        memcpy(&v,&virtualEeprom[pos],4);
+        return v;
+    }
+    static inline float eprGetFloat(unsigned int pos)
+    {
+        float v;
+        memcpy(&v,&virtualEeprom[pos],4);
+        return v;
+    }
+
+    static inline void allowInterrupts()
+    {
+        interruptsEnabled = true;
+    }
+    static inline void forbidInterrupts()
+    {
+        interruptsEnabled = false;
+    }
+    static inline unsigned long timeInMilliseconds()
+    {
+        return (unsigned long)(ticks / (F_CPU / 1000));
+    }
+    static inline char readFlashByte(PGM_P ptr)
+    {
+        return pgm_read_byte(ptr);
+    }
+    static void serialSetBaudrate(long baud);
+    static bool serialByteAvailable();
+    static uint8_t serialReadByte();
+    static void serialWriteByte(char b);
+    static void serialFlush();
+    static inline uint8_t *serialRxData()
+    {
+        return serialRxBuffer;
+    }
+    static inline uint16_t serialRxTail()
+    {
+        return serialRxTailPos;
+    }
+    static inline uint16_t serialRxAvailable()
+    {
+        serialReceive();
+        return (serialRxHead - serialRxTailPos) & SERIAL_RX_BUFFER_MASK;
+    }
+    static inline void serialRxConsume(uint16_t n)
+    {
+        serialRxTailPos = (serialRxTailPos + n) & SERIAL_RX_BUFFER_MASK;
+    }
+    static inline uint32_t serialRxOverflows()
+    {
+        return 0; // the simulated host waits for free space
+    }
+    static inline uint16_t serialRxHighWater()
+    {
+        return serialRxHighWaterMark;
+    }
+    static inline void serialRxResetStatistics()
+    {
+        serialRxHighWaterMark = 0;
+    }
+    /** \brief Moves the bytes that arrived until now from the input into the receive ring. */
+    static void serialReceive();
+    static void setupTimer();
+    static void showStartReason();
+    static int getFreeRam();
+    static void resetHardware();
+
+    // SPI related functions, they talk to the SD card emulation of -S in HAL.cpp
+    static inline void spiBegin()
+    {}
+    static void spiInit(uint8_t spiRate);
+    static uint8_t spiReceive(uint8_t send=0xff);
+    static void spiReadBlock(uint8_t*buf,size_t nbyte);
+    static void spiSend(uint8_t b);
+    static void spiSend(const uint8_t* buf , size_t n);
+    static void spiSendBlock(uint8_t token, const uint8_t* buf);
+
+    // I2C Support, no devices connected
+    static inline void i2cInit(unsigned long clockSpeedHz) {}
+    static inline unsigned char i2cStart(unsigned char address) {return 1;}
+    static inline void i2cStartWait(unsigned char address) {}
+    static inline void i2cStop(void) {}
+    static inline unsigned char i2cWrite( unsigned char data ) {return 1;}
+    static inline unsigned char i2cReadAck(void) {return 0;}
+    static inline unsigned char i2cReadNak(void) {return 0;}
+
+    // Watchdog support
+    inline static void startWatchdog() {}
+    inline static void stopWatchdog() {}
+    inline static void pingWatchdog() {}
+
+    inline static float maxExtruderTimerFrequency()
+    {
+        return (float)F_CPU/TIMER0_PRESCALE;
+    }
+#if FEATURE_SERVO
+    static unsigned int servoTimings[4];
+    static void servoMicroseconds(uint8_t servo,int ms);
+#endif
+    static void analogStart();
+    /** \brief Switches the hardware pwm outputs off, the host has none. */
+    static inline void hardwarePwmOff() {}
+
+    /** \brief Fires the next due timer interrupt.
+
+    Called from the idle points of the firmware. Advances the virtual clock to the
+    next timer compare and executes the matching interrupt routine, unless interrupts
+    are forbidden or we are already inside an interrupt. Also ends the program once
+    the serial input is exhausted and the printer stayed idle long enough. */
+    static void simulateInterrupts();
+    static void logPin(uint8_t pin,uint8_t value);
+
+    /** \brief Planner benchmark (-B).
+
+    The motion planner reports each PrintLine::calculateMove call and the number of
+    lines updateTrapezoids had to replan. Lines leave the queue after their planned
+    time without stepping, so the result measures parsing and planning only.
+    The summary goes to stderr on exit. */
+    static bool benchmark;
+    static uint8_t serialRxBuffer[SERIAL_RX_BUFFER_SIZE];
+    static uint16_t serialRxHead;
+    static uint16_t serialRxTailPos;
+    static uint16_t serialRxHighWaterMark;
+    static FILE *planLog; ///< With -l the trapezoid of every line leaving the queue.
+    static uint32_t benchmarkLine();
+    static void benchmarkMoveStart();
+    static void benchmarkMoveEnd();
+    static void benchmarkReplan(uint8_t depth);
+
+    /** \brief Motion stream conversion (-M).
+
+    Moves of G0-G3 are written to the motion stream in steps instead of being
+    queued, all other commands are written in the binary format and executed,
+    so positions after homing or G92 are known. See MotionRecord in Repetier.h. */
+    static FILE *motionStream;
+    static bool motionStreamMove(uint8_t checkEndstops,uint8_t pathOptimize,uint8_t softEndstop);
+    static void motionStreamCommand(GCode *com);
+};
+
+// The few Arduino core functions used outside of the HAL
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+static inline void pinMode(uint8_t pin,uint8_t mode) {HAL::pinMode(pin,mode);}
+static inline void digitalWrite(uint8_t pin,uint8_t value) {HAL::digitalWrite(pin,value);}
+static inline void analogWrite(uint8_t pin,int value) {HAL::digitalWrite(pin,value>127);}
+
+#endif // HAL_H
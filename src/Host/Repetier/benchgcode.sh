@@ -0,0 +1,71 @@
+#!/bin/sh
+# Writes the G-code files used by "make bench" into the directory given as
+# first argument. The files mimic typical slicer output:
+#
+#  curves.gcode   dense 0.1 mm segments on circles of changing radius
+#  vase.gcode     spiral vase mode, z rises with every segment
+#  infill.gcode   zig-zag infill with short turns at the borders
+#  travel.gcode   long travel moves between random points (delta worst case)
+#
+# All coordinates stay in 10..100 mm so the files run on the cartesian and
+# the delta configuration.
+
+DIR=${1:-.}
+mkdir -p "$DIR"
+
+HEADER='G21
+G90
+M82
+G28
+G92 E0
+G1 Z0.3 F3000'
+
+awk -v header="$HEADER" 'BEGIN {
+    print header
+    e = 0; pi = 3.14159265358979
+    for(ring = 0; ring < 30; ring++) {
+        r = 10 + ring
+        n = int(2 * pi * r / 0.1)
+        for(i = 0; i <= n; i++) {
+            a = 2 * pi * i / n
+            e += 0.1 * 0.033
+            printf("G1 X%.3f Y%.3f E%.5f F1800\n", 55 + r * cos(a), 55 + r * sin(a), e)
+        }
+    }
+}' > "$DIR/curves.gcode"
+
+awk -v header="$HEADER" 'BEGIN {
+    print header
+    e = 0; z = 0.3; pi = 3.14159265358979; r = 30; n = 600
+    for(layer = 0; layer < 40; layer++) {
+        for(i = 0; i < n; i++) {
+            a = 2 * pi * i / n
+            z += 0.2 / n
+            e += 2 * pi * r / n * 0.033
+            printf("G1 X%.3f Y%.3f Z%.4f E%.5f F2400\n", 55 + r * cos(a), 55 + r * sin(a), z, e)
+        }
+    }
+}' > "$DIR/vase.gcode"
+
+awk -v header="$HEADER" 'BEGIN {
+    print header
+    e = 0
+    for(layer = 0; layer < 10; layer++) {
+        printf("G1 Z%.2f F3000\n", 0.3 + 0.2 * layer)
+        for(y = 20; y < 90; y += 0.4) {
+            x1 = (int((y - 20) / 0.4) % 2) ? 90 : 20
+            x2 = 110 - x1
+            e += 0.4 * 0.033
+            printf("G1 X%.3f Y%.3f E%.5f F4800\n", x1, y, e)
+            e += 70 * 0.033
+            printf("G1 X%.3f Y%.3f E%.5f F4800\n", x2, y, e)
+        }
+    }
+}' > "$DIR/infill.gcode"
+
+awk -v header="$HEADER" 'BEGIN {
+    print header
+    srand(1)
+    for(i = 0; i < 2000; i++)
+        printf("G0 X%.3f Y%.3f F12000\n", 10 + 90 * rand(), 10 + 90 * rand())
+}' > "$DIR/travel.gcode"
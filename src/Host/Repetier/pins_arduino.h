@@ -0,0 +1,2 @@
+// The host build has no Arduino core. This file only satisfies the
+// include in Extruder.cpp.
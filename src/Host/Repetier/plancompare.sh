@@ -0,0 +1,22 @@
+#!/bin/sh
+# Compares two planner logs written with -B -l, e.g. from the float and the
+# integer planner. Speeds and intervals may differ by 1% (or 2 units),
+# acceleration/deceleration steps by 2% (or 2 steps).
+# Usage: plancompare.sh float.log fixed.log
+
+paste -d ' ' "$1" "$2" | awk '
+function off(a, b, rel, abso,   d) {
+    d = a - b; if(d < 0) d = -d
+    return d > abso && d > rel * (a > b ? a : b)
+}
+{
+    if(NF != 16 || $1 != $9) { print "line " NR ": different moves"; bad++; next }
+    for(i = 2; i <= 6; i++)
+        if(off($i, $(i + 8), 0.01, 2)) { print "line " NR ": field " i ": " $i " <> " $(i + 8); bad++; next }
+    for(i = 7; i <= 8; i++)
+        if(off($i, $(i + 8), 0.02, 2)) { print "line " NR ": field " i ": " $i " <> " $(i + 8); bad++; next }
+}
+END {
+    printf("%d lines compared, %d differ\n", NR, bad)
+    exit(bad > 0)
+}'
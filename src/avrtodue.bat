@@ -6,6 +6,7 @@ copy ArduinoAVR\Repetier\Commands.*  ArduinoDue\Repetier
 copy ArduinoAVR\Repetier\Communication.*  ArduinoDue\Repetier
 copy ArduinoAVR\Repetier\Eeprom.*  ArduinoDue\Repetier
 copy ArduinoAVR\Repetier\Extruder.*  ArduinoDue\Repetier
+copy ArduinoAVR\Repetier\thermistortables.h  ArduinoDue\Repetier
 copy ArduinoAVR\Repetier\FatStructs.h  ArduinoDue\Repetier
 copy ArduinoAVR\Repetier\gcode.*  ArduinoDue\Repetier
 copy ArduinoAVR\Repetier\motion.*  ArduinoDue\Repetier